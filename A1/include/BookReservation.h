@@ -14,6 +14,8 @@
 #include "CircularQueue.h"
 #include "Stack.h"
 
+class ReservationArchive;
+
 class ReservationRecord {
 public:
     std::string patronID;
@@ -36,6 +38,8 @@ public:
 
     ReservationRecord processReservation();
 
+    void archiveFulfilledReservations(ReservationArchive &archive, const Date &fulfilledOn);
+
     CircularQueue<ReservationRecord> pendingReservations;
     Stack<ReservationRecord> fulfilledReservations;
     std::vector<Book> booksDB;
@@ -46,6 +50,4 @@ private:
     int maxPendingReservations;
 };
 
-#include "../src/BookReservation.cpp"
-
 #endif //BOOKRESERVATION_H
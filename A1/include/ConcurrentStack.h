@@ -0,0 +1,61 @@
+#ifndef CONCURRENT_STACK_H
+#define CONCURRENT_STACK_H
+/**
+ * Implementation of a lock-free (Treiber) stack which can be shared between threads.
+ *
+ * Popped nodes are reclaimed through hazard pointers: a thread that is about to dereference the head publishes it in a
+ * hazard slot first, and retired nodes are only deleted once no slot points at them. Since a protected node can never be
+ * freed and reallocated, the head cannot go from A to B and back to A underneath a pending compare-and-swap (ABA).
+ */
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+template <typename T>
+class ConcurrentStack {
+public:
+    ConcurrentStack();
+    ~ConcurrentStack();
+    ConcurrentStack(const ConcurrentStack&) = delete;
+    ConcurrentStack& operator=(const ConcurrentStack&) = delete;
+    bool isEmpty() const;
+    size_t size() const;
+    void push(const T& element);
+    bool pop(T& element);
+    std::vector<T> popAll();
+
+private:
+    static constexpr unsigned int MAX_HAZARD_POINTERS = 128;
+    static constexpr unsigned int RETIRE_THRESHOLD = 2 * MAX_HAZARD_POINTERS;
+
+    struct Node {
+        T value;
+        Node* next;
+        Node* retiredNext;
+
+        explicit Node(const T& v) : value(v), next(nullptr), retiredNext(nullptr) {}
+    };
+
+    struct HazardSlot {
+        std::atomic<std::thread::id> owner;
+        std::atomic<Node*> pointer;
+
+        HazardSlot() : owner(std::thread::id()), pointer(nullptr) {}
+    };
+
+    std::atomic<Node*> head;
+    // Signed, since a pop can take a node before its pusher has counted it
+    std::atomic<std::ptrdiff_t> currentSize;
+    HazardSlot hazardSlots[MAX_HAZARD_POINTERS];
+    std::atomic<Node*> retiredHead;
+    std::atomic<unsigned int> retiredCount;
+
+    HazardSlot* acquireHazardSlot();
+    void retire(Node* node);
+    void reclaim();
+};
+
+#include "../src/ConcurrentStack.cpp"
+
+#endif //CONCURRENT_STACK_H
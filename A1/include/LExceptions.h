@@ -39,4 +39,18 @@ public:
     }
 };
 
+class ArchiveSegmentUnavailable : public std::exception {
+public:
+    const char * what () {
+        return "Reservation archive segment could not be opened!";
+    }
+};
+
+class ArchiveOutOfOrder : public std::exception {
+public:
+    const char * what () {
+        return "Reservations must be archived in the order they were fulfilled!";
+    }
+};
+
 #endif //LEXCEPTIONS_H
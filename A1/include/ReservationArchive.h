@@ -0,0 +1,89 @@
+#ifndef RESERVATIONARCHIVE_H
+#define RESERVATIONARCHIVE_H
+/**
+ * Implementation of an append-only archive for fulfilled reservations.
+ *
+ * The most recent records are kept in memory, older ones are spilled to append-only segment files on disk. Every segment
+ * keeps a sparse time index (one entry every few records), so a time-range query only opens the segments whose date
+ * range overlaps the query and seeks close to the first matching record.
+ */
+#include <string>
+#include <vector>
+#include <functional>
+#include <fstream>
+#include "Date.h"
+#include "CircularQueue.h"
+#include "BookReservation.h"
+
+class ArchivedReservation {
+public:
+    ReservationRecord record;
+    Date fulfilledOn;
+
+    ArchivedReservation(const ReservationRecord &record, const Date &fulfilledOn);
+
+    ArchivedReservation() : fulfilledOn(Date::parseDate("1971-01-01")) {}
+};
+
+class ReservationArchive {
+public:
+    ReservationArchive(const std::string &directory, int recentWindow = 1024, int segmentCapacity = 8192,
+                       int indexInterval = 64);
+    ~ReservationArchive();
+
+    void append(const ReservationRecord &record, const Date &fulfilledOn);
+
+    std::vector<ArchivedReservation> findByPatron(const std::string &patronID, const Date &from, const Date &to);
+
+    std::vector<ArchivedReservation> findByISBN(const std::string &bookISBN, const Date &from, const Date &to);
+
+    void flush();
+
+    size_t size() const;
+
+    size_t segmentCount() const;
+
+private:
+    struct IndexEntry {
+        Date date;
+        std::streamoff offset;
+
+        IndexEntry(const Date &date, std::streamoff offset) : date(date), offset(offset) {}
+    };
+
+    struct Segment {
+        std::string path;
+        Date firstDate;
+        Date lastDate;
+        int recordCount;
+        std::vector<IndexEntry> index;
+
+        explicit Segment(std::string path) : path(std::move(path)), firstDate(Date::parseDate("1971-01-01")),
+                                             lastDate(Date::parseDate("1971-01-01")), recordCount(0) {}
+    };
+
+    std::string directory;
+    int segmentCapacity;
+    int indexInterval;
+    CircularQueue<ArchivedReservation> recentRecords;
+    std::vector<Segment> segments;
+    std::ofstream activeSegment;
+    std::streamoff activeOffset;
+    size_t archivedCount;
+    Date lastAppendedDate;
+
+    void spill(const ArchivedReservation &reservation);
+
+    void openActiveSegment();
+
+    void sealActiveSegment();
+
+    void loadSegments();
+
+    std::vector<ArchivedReservation> query(const Date &from, const Date &to,
+                                           const std::function<bool(const ReservationRecord &)> &matches);
+
+    std::string segmentPath(size_t segmentID) const;
+};
+
+#endif //RESERVATIONARCHIVE_H
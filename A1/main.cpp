@@ -8,6 +8,8 @@
 #include "tests/StackTests.h"
 #include "tests/CircularQueueTests.h"
 #include "tests/BookReservationTests.h"
+#include "tests/ConcurrentStackTests.h"
+#include "tests/ReservationArchiveTests.h"
 /*
  * This is the driver file which directs the project on testing different modules.
  * For each new testing function add a new case with the next available "module_choice" to be able to test it out.
@@ -27,6 +29,10 @@ int main(int argc, char* argv[]) {
             circularQueueTests();
             std::cout << ">> Book Reservation System: \t";
             bookReservationTests();
+            std::cout << ">> ConcurrentStack:\t\t\t\t";
+            concurrentStackTests();
+            std::cout << ">> Reservation Archive: \t\t";
+            reservationArchiveTests();
             break;
         default:
             throw std::invalid_argument("Invalid module choice");
@@ -1,6 +1,7 @@
 #include "../include/BookReservation.h"
 
 #include "../include/LExceptions.h"
+#include "../include/ReservationArchive.h"
 
 /**
  * Initializes the reservation record with the patron's ID and book's ISBN.
@@ -100,6 +101,29 @@ ReservationRecord BookReservationManagementSystem::processReservation() {
     return *reservation;
 }
 
+/**
+ * Moves every fulfilled reservation into the given archive, oldest first, so that the fulfilled reservations stack only
+ * holds the reservations fulfilled since the last call.
+ * @param archive the archive to move the fulfilled reservations to
+ * @param fulfilledOn the date the reservations were fulfilled on
+ * @throws ArchiveOutOfOrder when the date is earlier than the date of the last archived reservation
+ */
+void BookReservationManagementSystem::archiveFulfilledReservations(ReservationArchive &archive,
+                                                                   const Date &fulfilledOn) {
+    std::vector<ReservationRecord> fulfilled;
+
+    fulfilled.reserve(fulfilledReservations.size());
+
+    while (!fulfilledReservations.isEmpty()) {
+        fulfilled.push_back(fulfilledReservations.top());
+        fulfilledReservations.pop();
+    }
+
+    for (auto it = fulfilled.rbegin(); it != fulfilled.rend(); ++it) {
+        archive.append(*it, fulfilledOn);
+    }
+}
+
 /**
  * Adds the given reservation record to the end of the pending reservations queue.
  * @param reservation the reservation record to add to the end of the pending reservations queue
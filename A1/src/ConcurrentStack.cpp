@@ -0,0 +1,200 @@
+#include "../include/ConcurrentStack.h"
+
+#include <algorithm>
+
+/**
+ * Initializes an empty concurrent stack.
+ */
+template<typename T>
+ConcurrentStack<T>::ConcurrentStack() : head(nullptr), currentSize(0), retiredHead(nullptr), retiredCount(0) {
+}
+
+/**
+ * Releases the remaining nodes of the stack and every retired node. No other thread may be using the stack anymore.
+ */
+template<typename T>
+ConcurrentStack<T>::~ConcurrentStack() {
+    Node *node = head.load();
+
+    while (node != nullptr) {
+        Node *next = node->next;
+        delete node;
+        node = next;
+    }
+
+    node = retiredHead.load();
+
+    while (node != nullptr) {
+        Node *next = node->retiredNext;
+        delete node;
+        node = next;
+    }
+}
+
+/**
+ * Returns whether the stack is empty at the time of the call.
+ * @return whether the stack is empty
+ */
+template<typename T>
+bool ConcurrentStack<T>::isEmpty() const {
+    return head.load() == nullptr;
+}
+
+/**
+ * Returns the number of elements in the stack. The count is updated after the element is linked or unlinked, so while
+ * other threads are pushing or popping the result is only approximate; it never goes below zero.
+ * @return the number of elements in the stack
+ */
+template<typename T>
+size_t ConcurrentStack<T>::size() const {
+    const std::ptrdiff_t count = currentSize.load(std::memory_order_relaxed);
+
+    return count > 0 ? static_cast<size_t>(count) : 0;
+}
+
+/**
+ * Pushes the given element to the top of the stack without taking a lock.
+ * @param element the element to push to the top of the stack
+ */
+template<typename T>
+void ConcurrentStack<T>::push(const T &element) {
+    Node *node = new Node(element);
+
+    node->next = head.load(std::memory_order_relaxed);
+
+    // On failure, compare_exchange_weak reloads the current head into node->next, so we only need to retry
+    while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+
+    currentSize.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Pops the element at the top of the stack without taking a lock.
+ * @param element receives the popped element
+ * @return whether an element was popped (false if the stack was empty)
+ */
+template<typename T>
+bool ConcurrentStack<T>::pop(T &element) {
+    HazardSlot *slot = acquireHazardSlot();
+    Node *oldHead = head.load();
+
+    do {
+        // Publish the head as hazardous, then make sure it is still the head; otherwise it may already be retired
+        Node *protectedHead;
+
+        do {
+            protectedHead = oldHead;
+            slot->pointer.store(protectedHead);
+            oldHead = head.load();
+        } while (oldHead != protectedHead);
+    } while (oldHead != nullptr && !head.compare_exchange_strong(oldHead, oldHead->next));
+
+    slot->pointer.store(nullptr);
+    slot->owner.store(std::thread::id());
+
+    if (oldHead == nullptr) return false;
+
+    currentSize.fetch_sub(1, std::memory_order_relaxed);
+
+    // Only the thread that won the compare-and-swap touches the value; other readers only look at next
+    element = std::move(oldHead->value);
+    retire(oldHead);
+
+    return true;
+}
+
+/**
+ * Detaches every element of the stack in a single atomic exchange, so a background archiver can drain the stack while
+ * other threads keep pushing.
+ * @return the detached elements, from the top of the stack to the bottom
+ */
+template<typename T>
+std::vector<T> ConcurrentStack<T>::popAll() {
+    Node *node = head.exchange(nullptr);
+    std::vector<T> elements;
+
+    while (node != nullptr) {
+        Node *next = node->next;
+
+        elements.push_back(std::move(node->value));
+        // A concurrent pop may still hold this node as its hazard, so it must go through the retire list as well
+        retire(node);
+
+        node = next;
+    }
+
+    currentSize.fetch_sub(static_cast<std::ptrdiff_t>(elements.size()), std::memory_order_relaxed);
+
+    return elements;
+}
+
+/**
+ * Claims a free hazard slot for the calling thread, waiting for one to be released if all of them are in use.
+ * @return the claimed hazard slot
+ */
+template<typename T>
+typename ConcurrentStack<T>::HazardSlot *ConcurrentStack<T>::acquireHazardSlot() {
+    const std::thread::id self = std::this_thread::get_id();
+
+    while (true) {
+        for (HazardSlot &slot: hazardSlots) {
+            std::thread::id unowned;
+
+            if (slot.owner.load(std::memory_order_relaxed) == unowned && slot.owner.compare_exchange_strong(unowned, self)) {
+                return &slot;
+            }
+        }
+
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * Adds the given node to the retire list, and reclaims the list once it grows past the threshold.
+ * @param node the node that has been removed from the stack
+ */
+template<typename T>
+void ConcurrentStack<T>::retire(Node *node) {
+    node->retiredNext = retiredHead.load(std::memory_order_relaxed);
+
+    while (!retiredHead.compare_exchange_weak(node->retiredNext, node, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+    }
+
+    if (retiredCount.fetch_add(1) + 1 >= RETIRE_THRESHOLD) reclaim();
+}
+
+/**
+ * Deletes every retired node that is not protected by a hazard pointer, and puts the protected ones back on the list.
+ */
+template<typename T>
+void ConcurrentStack<T>::reclaim() {
+    Node *node = retiredHead.exchange(nullptr);
+
+    if (node == nullptr) return;
+
+    std::vector<Node *> hazards;
+
+    for (HazardSlot &slot: hazardSlots) {
+        Node *hazard = slot.pointer.load();
+
+        if (hazard != nullptr) hazards.push_back(hazard);
+    }
+
+    std::sort(hazards.begin(), hazards.end());
+
+    while (node != nullptr) {
+        Node *next = node->retiredNext;
+
+        retiredCount.fetch_sub(1);
+
+        if (std::binary_search(hazards.begin(), hazards.end(), node)) {
+            retire(node);
+        } else {
+            delete node;
+        }
+
+        node = next;
+    }
+}
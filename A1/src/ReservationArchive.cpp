@@ -0,0 +1,359 @@
+#include "../include/ReservationArchive.h"
+
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include "../include/LExceptions.h"
+
+/**
+ * Writes the given date in the YYYY-MM-DD format understood by Date::parseDate.
+ * @param out the stream to write to
+ * @param date the date to write
+ */
+static void writeDate(std::ostream &out, const Date &date) {
+    out << std::setfill('0') << std::setw(4) << date.getYear() << '-' << std::setw(2) << date.getMonth() << '-'
+        << std::setw(2) << date.getDay();
+}
+
+/**
+ * Reads the next archived reservation (one tab-separated line) from the given segment stream.
+ * @param in the segment stream to read from
+ * @param reservation receives the reservation that was read
+ * @return whether a reservation was read (false at the end of the segment)
+ */
+static bool readReservation(std::istream &in, ArchivedReservation &reservation) {
+    std::string line;
+
+    if (!std::getline(in, line) || line.empty()) return false;
+
+    const size_t firstTab = line.find('\t');
+    const size_t secondTab = line.find('\t', firstTab + 1);
+
+    reservation.fulfilledOn = Date::parseDate(line.substr(0, firstTab));
+    reservation.record.patronID = line.substr(firstTab + 1, secondTab - firstTab - 1);
+    reservation.record.bookISBN = line.substr(secondTab + 1);
+
+    return true;
+}
+
+/**
+ * Returns the given archive setting, checking that it is positive.
+ * @param value the value of the setting
+ * @param message the message of the exception thrown when the value is not positive
+ * @return the value
+ * @throws std::invalid_argument when the value is zero or negative
+ */
+static int requirePositive(const int value, const char *message) {
+    if (value <= 0) throw std::invalid_argument(message);
+
+    return value;
+}
+
+/**
+ * Initializes the archived reservation with the fulfilled record and the date it was fulfilled on.
+ * @param record the fulfilled reservation record
+ * @param fulfilledOn the date the reservation was fulfilled on
+ */
+ArchivedReservation::ArchivedReservation(const ReservationRecord &record, const Date &fulfilledOn) : record(record),
+    fulfilledOn(fulfilledOn) {
+}
+
+/**
+ * Opens the archive stored in the given directory, picking up the segments written by previous runs.
+ * @param directory the existing directory the segment files are stored in
+ * @param recentWindow the number of most recent records to keep in memory
+ * @param segmentCapacity the number of records per segment file
+ * @param indexInterval the number of records between two entries of a segment's sparse time index
+ * @throws std::invalid_argument when the window, the segment capacity or the index interval is not positive
+ * @throws ArchiveSegmentUnavailable when a segment file cannot be opened
+ */
+ReservationArchive::ReservationArchive(const std::string &directory, int recentWindow, int segmentCapacity,
+                                       int indexInterval)
+    : directory(directory),
+      segmentCapacity(requirePositive(segmentCapacity, "An archive segment must hold at least one record")),
+      indexInterval(requirePositive(indexInterval, "The archive index interval must be positive")),
+      recentRecords(requirePositive(recentWindow, "The archive must keep at least one recent record in memory")),
+      activeOffset(0), archivedCount(0), lastAppendedDate(Date::parseDate("1971-01-01")) {
+    loadSegments();
+}
+
+/**
+ * Spills the in-memory window to disk so that no record is lost when the archive is closed. A failure to spill is
+ * swallowed, since a destructor cannot report it; call flush() first to see it.
+ */
+ReservationArchive::~ReservationArchive() {
+    try {
+        flush();
+    } catch (const std::exception &) {
+        // A destructor cannot report the failure
+    }
+}
+
+/**
+ * Appends a fulfilled reservation to the archive. When the in-memory window is full, its oldest record is spilled to the
+ * active segment on disk.
+ * @param record the fulfilled reservation record
+ * @param fulfilledOn the date the reservation was fulfilled on
+ * @throws ArchiveOutOfOrder when the date is earlier than the date of the previously archived record
+ */
+void ReservationArchive::append(const ReservationRecord &record, const Date &fulfilledOn) {
+    if (fulfilledOn < lastAppendedDate) throw ArchiveOutOfOrder();
+
+    if (recentRecords.isFull()) {
+        spill(recentRecords.front());
+        recentRecords.dequeue();
+    }
+
+    recentRecords.enqueue(ArchivedReservation(record, fulfilledOn));
+    lastAppendedDate = fulfilledOn;
+}
+
+/**
+ * Returns the reservations fulfilled for the given patron between the given dates (inclusive), oldest first.
+ * @param patronID the ID of the patron to look for
+ * @param from the first date of the range
+ * @param to the last date of the range
+ * @return the matching reservations
+ */
+std::vector<ArchivedReservation> ReservationArchive::findByPatron(const std::string &patronID, const Date &from,
+                                                                  const Date &to) {
+    return query(from, to, [&patronID](const ReservationRecord &record) {
+        return record.patronID == patronID;
+    });
+}
+
+/**
+ * Returns the reservations fulfilled for the given book between the given dates (inclusive), oldest first.
+ * @param bookISBN the ISBN of the book to look for
+ * @param from the first date of the range
+ * @param to the last date of the range
+ * @return the matching reservations
+ */
+std::vector<ArchivedReservation> ReservationArchive::findByISBN(const std::string &bookISBN, const Date &from,
+                                                                const Date &to) {
+    return query(from, to, [&bookISBN](const ReservationRecord &record) {
+        return record.bookISBN == bookISBN;
+    });
+}
+
+/**
+ * Spills every record of the in-memory window to disk and flushes the active segment.
+ *
+ * @throws ArchiveSegmentUnavailable when a segment or index file cannot be opened
+ */
+void ReservationArchive::flush() {
+    while (!recentRecords.isEmpty()) {
+        spill(recentRecords.front());
+        recentRecords.dequeue();
+    }
+
+    if (activeSegment.is_open()) activeSegment.flush();
+}
+
+/**
+ * Returns the number of archived records, both on disk and in memory.
+ * @return the number of archived records
+ */
+size_t ReservationArchive::size() const {
+    return archivedCount + recentRecords.size();
+}
+
+/**
+ * Returns the number of segment files the archive is made of.
+ * @return the number of segment files
+ */
+size_t ReservationArchive::segmentCount() const {
+    return segments.size();
+}
+
+/**
+ * Appends the given reservation to the active segment, sealing it and starting a new one when it is full.
+ * @param reservation the reservation to write to disk
+ */
+void ReservationArchive::spill(const ArchivedReservation &reservation) {
+    if (!activeSegment.is_open() || segments.back().recordCount >= segmentCapacity) {
+        if (activeSegment.is_open()) sealActiveSegment();
+
+        segments.emplace_back(segmentPath(segments.size()));
+        activeOffset = 0;
+        openActiveSegment();
+    }
+
+    Segment &segment = segments.back();
+
+    if (segment.recordCount == 0) segment.firstDate = reservation.fulfilledOn;
+    if (segment.recordCount % indexInterval == 0) segment.index.emplace_back(reservation.fulfilledOn, activeOffset);
+
+    std::ostringstream line;
+
+    writeDate(line, reservation.fulfilledOn);
+    line << '\t' << reservation.record.patronID << '\t' << reservation.record.bookISBN << '\n';
+
+    const std::string text = line.str();
+
+    activeSegment.write(text.data(), static_cast<std::streamsize>(text.size()));
+    activeOffset += static_cast<std::streamoff>(text.size());
+
+    segment.lastDate = reservation.fulfilledOn;
+    segment.recordCount += 1;
+    archivedCount += 1;
+}
+
+/**
+ * Opens the last segment for appending.
+ * @throws ArchiveSegmentUnavailable when the segment file cannot be opened
+ */
+void ReservationArchive::openActiveSegment() {
+    activeSegment.open(segments.back().path + ".log", std::ios::out | std::ios::app | std::ios::binary);
+
+    if (!activeSegment.is_open()) throw ArchiveSegmentUnavailable();
+}
+
+/**
+ * Closes the active segment and writes its sparse time index next to it, which makes the segment immutable.
+ * @throws ArchiveSegmentUnavailable when the index file cannot be written
+ */
+void ReservationArchive::sealActiveSegment() {
+    activeSegment.close();
+
+    const Segment &segment = segments.back();
+    std::ofstream index(segment.path + ".idx", std::ios::out | std::ios::trunc);
+
+    if (!index.is_open()) throw ArchiveSegmentUnavailable();
+
+    writeDate(index, segment.firstDate);
+    index << ' ';
+    writeDate(index, segment.lastDate);
+    index << ' ' << segment.recordCount << '\n';
+
+    for (const IndexEntry &entry: segment.index) {
+        writeDate(index, entry.date);
+        index << ' ' << entry.offset << '\n';
+    }
+}
+
+/**
+ * Loads the segments left by previous runs. Sealed segments are described by their index file; the last, unsealed
+ * segment is scanned once to rebuild its index and becomes the active segment again.
+ * @throws ArchiveSegmentUnavailable when the unsealed segment cannot be reopened
+ */
+void ReservationArchive::loadSegments() {
+    for (size_t segmentID = 0;; ++segmentID) {
+        const std::string path = segmentPath(segmentID);
+        std::ifstream log(path + ".log", std::ios::in | std::ios::binary);
+
+        if (!log.is_open()) break;
+
+        segments.emplace_back(path);
+        Segment &segment = segments.back();
+        std::ifstream index(path + ".idx");
+
+        if (index.is_open()) {
+            std::string firstDate, lastDate, date;
+            std::streamoff offset;
+
+            index >> firstDate >> lastDate >> segment.recordCount;
+            segment.firstDate = Date::parseDate(firstDate);
+            segment.lastDate = Date::parseDate(lastDate);
+
+            while (index >> date >> offset) {
+                segment.index.emplace_back(Date::parseDate(date), offset);
+            }
+        } else {
+            ArchivedReservation reservation;
+            std::streamoff recordOffset = log.tellg();
+
+            while (readReservation(log, reservation)) {
+                if (segment.recordCount == 0) segment.firstDate = reservation.fulfilledOn;
+                if (segment.recordCount % indexInterval == 0) {
+                    segment.index.emplace_back(reservation.fulfilledOn, recordOffset);
+                }
+
+                segment.lastDate = reservation.fulfilledOn;
+                segment.recordCount += 1;
+                recordOffset = log.tellg();
+            }
+
+            std::ifstream end(path + ".log", std::ios::in | std::ios::binary | std::ios::ate);
+
+            activeOffset = end.tellg();
+
+            if (activeSegment.is_open()) activeSegment.close();
+            openActiveSegment();
+        }
+
+        archivedCount += segment.recordCount;
+        lastAppendedDate = segment.lastDate;
+    }
+}
+
+/**
+ * Returns the records fulfilled between the given dates that satisfy the given predicate, oldest first. Only the
+ * segments whose date range overlaps the query are opened, and each one is read from the closest indexed offset.
+ * @param from the first date of the range
+ * @param to the last date of the range
+ * @param matches the predicate the records have to satisfy
+ * @return the matching reservations
+ */
+std::vector<ArchivedReservation> ReservationArchive::query(const Date &from, const Date &to,
+                                                           const std::function<bool(const ReservationRecord &)> &
+                                                           matches) {
+    std::vector<ArchivedReservation> results;
+
+    if (activeSegment.is_open()) activeSegment.flush();
+
+    for (const Segment &segment: segments) {
+        if (segment.recordCount == 0 || segment.lastDate < from || segment.firstDate > to) continue;
+
+        // Start from the last indexed record before the range; everything before it is older than "from"
+        std::streamoff start = 0;
+
+        for (const IndexEntry &entry: segment.index) {
+            if (entry.date >= from) break;
+
+            start = entry.offset;
+        }
+
+        std::ifstream log(segment.path + ".log", std::ios::in | std::ios::binary);
+
+        if (!log.is_open()) throw ArchiveSegmentUnavailable();
+
+        log.seekg(start);
+
+        ArchivedReservation reservation;
+
+        while (readReservation(log, reservation)) {
+            if (reservation.fulfilledOn > to) break;
+
+            if (reservation.fulfilledOn >= from && matches(reservation.record)) results.push_back(reservation);
+        }
+    }
+
+    // The in-memory window holds the newest records, so it is scanned last to keep the results in time order
+    CircularQueue<ArchivedReservation> recent = recentRecords;
+
+    while (!recent.isEmpty()) {
+        const ArchivedReservation &reservation = recent.front();
+
+        if (reservation.fulfilledOn >= from && reservation.fulfilledOn <= to && matches(reservation.record)) {
+            results.push_back(reservation);
+        }
+
+        recent.dequeue();
+    }
+
+    return results;
+}
+
+/**
+ * Returns the path of the given segment, without the ".log" / ".idx" extension.
+ * @param segmentID the position of the segment in the archive
+ * @return the path of the segment
+ */
+std::string ReservationArchive::segmentPath(size_t segmentID) const {
+    std::ostringstream path;
+
+    path << directory << "/segment-" << std::setfill('0') << std::setw(6) << segmentID;
+
+    return path.str();
+}
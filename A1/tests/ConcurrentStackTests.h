@@ -0,0 +1,183 @@
+#ifndef CONCURRENTSTACKTESTS_H
+#define CONCURRENTSTACKTESTS_H
+#include <iostream>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "../include/Utils.h"
+#include "TestEnvironment.h"
+#include "../include/ConcurrentStack.h"
+#include "../include/BookReservation.h"
+
+std::pair<int, int> concurrentStackTestForReservationRecords() {
+    int passedTests = 0;
+    TestEnvironment env;
+    ConcurrentStack<ReservationRecord> reservationStack;
+    ReservationRecord record;
+    passedTests += _assert_(reservationStack.isEmpty());
+    passedTests += _assert_(!reservationStack.pop(record));
+    reservationStack.push(ReservationRecord(env.user1, env.book1));
+    reservationStack.push(ReservationRecord(env.user2, env.book2));
+    reservationStack.push(ReservationRecord(env.user3, env.book3));
+    passedTests += _assert_(reservationStack.size() == 3);
+    passedTests += _assert_(reservationStack.pop(record));
+    passedTests += _assert_(record.patronID == env.user3.ID);
+    passedTests += _assert_(record.bookISBN == env.book3.ISBN);
+    passedTests += _assert_(reservationStack.size() == 2);
+    std::vector<ReservationRecord> drained = reservationStack.popAll();
+    passedTests += _assert_(drained.size() == 2);
+    passedTests += _assert_(drained[0].patronID == env.user2.ID);
+    passedTests += _assert_(drained[1].patronID == env.user1.ID);
+    passedTests += _assert_(reservationStack.isEmpty());
+    passedTests += _assert_(reservationStack.size() == 0);
+    passedTests += _assert_(reservationStack.popAll().empty());
+    return std::make_pair(passedTests, 13);
+}
+
+std::pair<int, int> concurrentStackTestForMultipleThreads() {
+    int passedTests = 0;
+    const int threadCount = 4;
+    const int elementsPerThread = 50000;
+    ConcurrentStack<int> intStack;
+    std::vector<std::thread> pushers;
+    for (int t = 0; t < threadCount; ++t) {
+        pushers.emplace_back([&intStack, t, elementsPerThread]() {
+            for (int i = 0; i < elementsPerThread; ++i)
+                intStack.push(t * elementsPerThread + i);
+        });
+    }
+    for (std::thread &pusher: pushers)
+        pusher.join();
+    passedTests += _assert_(intStack.size() == threadCount * elementsPerThread);
+
+    // Every thread pops concurrently until the stack runs dry
+    std::vector<long long> poppedSums(threadCount, 0);
+    std::vector<int> poppedCounts(threadCount, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&intStack, &poppedSums, &poppedCounts, t]() {
+            int value;
+            while (intStack.pop(value)) {
+                poppedSums[t] += value;
+                poppedCounts[t] += 1;
+            }
+        });
+    }
+    for (std::thread &worker: workers)
+        worker.join();
+    long long totalSum = 0;
+    int totalCount = 0;
+    for (int t = 0; t < threadCount; ++t) {
+        totalSum += poppedSums[t];
+        totalCount += poppedCounts[t];
+    }
+    const long long n = static_cast<long long>(threadCount) * elementsPerThread;
+    passedTests += _assert_(totalCount == n);
+    passedTests += _assert_(totalSum == n * (n - 1) / 2);
+    passedTests += _assert_(intStack.isEmpty());
+
+    // Producers keep pushing while an archiver drains the stack in bulk
+    std::vector<std::thread> producers;
+    std::vector<int> archived;
+    for (int t = 0; t < threadCount; ++t) {
+        producers.emplace_back([&intStack, elementsPerThread]() {
+            for (int i = 0; i < elementsPerThread; ++i)
+                intStack.push(1);
+        });
+    }
+    std::thread archiver([&intStack, &archived, threadCount, elementsPerThread]() {
+        while (archived.size() < static_cast<size_t>(threadCount * elementsPerThread)) {
+            std::vector<int> batch = intStack.popAll();
+            archived.insert(archived.end(), batch.begin(), batch.end());
+        }
+    });
+    for (std::thread &producer: producers)
+        producer.join();
+    archiver.join();
+    passedTests += _assert_(archived.size() == static_cast<size_t>(threadCount * elementsPerThread));
+    passedTests += _assert_(intStack.isEmpty());
+    return std::make_pair(passedTests, 6);
+}
+
+std::pair<int, int> concurrentStackTestForProducersAndConsumers() {
+    int passedTests = 0;
+    ConcurrentStack<int> intStack;
+    const int threadCount = 4;
+    const int elementsPerThread = 5000;
+    const int n = threadCount * elementsPerThread;
+
+    // Producers push distinct values while consumers pop from the same stack, and an observer watches size()
+    std::atomic<int> producersLeft(threadCount);
+    std::atomic<bool> sizeInRange(true);
+    std::vector<std::vector<int>> popped(threadCount);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&intStack, &producersLeft, t, elementsPerThread]() {
+            for (int i = 0; i < elementsPerThread; ++i)
+                intStack.push(t * elementsPerThread + i);
+            producersLeft.fetch_sub(1);
+        });
+        workers.emplace_back([&intStack, &producersLeft, &popped, t]() {
+            int value;
+            while (producersLeft.load() > 0) {
+                if (intStack.pop(value))
+                    popped[t].push_back(value);
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+    std::thread observer([&intStack, &producersLeft, &sizeInRange, n]() {
+        while (producersLeft.load() > 0) {
+            if (intStack.size() > static_cast<size_t>(n))
+                sizeInRange = false;
+        }
+    });
+    for (std::thread &worker: workers)
+        worker.join();
+    observer.join();
+    int value;
+    while (intStack.pop(value))
+        popped[0].push_back(value);
+
+    std::vector<int> seen(n, 0);
+    bool inRange = true;
+    for (const std::vector<int> &values: popped) {
+        for (int v: values) {
+            if (v < 0 || v >= n)
+                inRange = false;
+            else
+                ++seen[v];
+        }
+    }
+    bool seenOnce = true;
+    for (int count: seen)
+        seenOnce = seenOnce && count == 1;
+    passedTests += _assert_(inRange);
+    passedTests += _assert_(seenOnce);
+    passedTests += _assert_(sizeInRange.load());
+    passedTests += _assert_(intStack.isEmpty());
+    passedTests += _assert_(intStack.size() == 0);
+    return std::make_pair(passedTests, 5);
+}
+
+int concurrentStackTests() {
+    int passedTests = 0;
+    int totalTests = 0;
+    std::pair<int, int> r1 = concurrentStackTestForReservationRecords();
+    passedTests += r1.first;
+    totalTests += r1.second;
+    std::pair<int, int> r2 = concurrentStackTestForMultipleThreads();
+    passedTests += r2.first;
+    totalTests += r2.second;
+    std::pair<int, int> r3 = concurrentStackTestForProducersAndConsumers();
+    passedTests += r3.first;
+    totalTests += r3.second;
+    double grade = static_cast<double>(passedTests * 100) / totalTests;
+    grade = std::round(grade * 10) / 10;
+    std::cout << "Total tests passed: " << passedTests << " out of " << totalTests << " (" << grade << "%)"  << std::endl;
+    return 0;
+}
+
+#endif //CONCURRENTSTACKTESTS_H
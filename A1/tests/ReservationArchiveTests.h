@@ -0,0 +1,167 @@
+#ifndef RESERVATIONARCHIVETESTS_H
+#define RESERVATIONARCHIVETESTS_H
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "TestEnvironment.h"
+#include "../include/BookReservation.h"
+#include "../include/ReservationArchive.h"
+#include "../include/LExceptions.h"
+
+std::string makeArchiveDirectory() {
+    char directory[] = "/tmp/reservation-archive-XXXXXX";
+    return mkdtemp(directory);
+}
+
+void removeArchiveDirectory(const std::string &directory) {
+    for (int i = 0; i < 100; ++i) {
+        char segment[32];
+        std::snprintf(segment, sizeof(segment), "/segment-%06d", i);
+        std::remove((directory + segment + ".log").c_str());
+        std::remove((directory + segment + ".idx").c_str());
+    }
+    rmdir(directory.c_str());
+}
+
+std::pair<int, int> reservationArchiveTestTimeRangeQueries() {
+    int passedTests = 0;
+    TestEnvironment te;
+    const std::string directory = makeArchiveDirectory();
+    Patron patrons[] = {te.user1, te.user2, te.user3};
+    Book books[] = {te.book1, te.book2, te.book3, te.book4};
+    {
+        ReservationArchive archive(directory, 4, 5, 2);
+        Date date = Date::parseDate("2023-01-01");
+        for (int i = 0; i < 24; ++i) { // one reservation per day, patrons and books taking turns
+            archive.append(ReservationRecord(patrons[i % 3], books[i % 4]), date);
+            date = Date::getNextDate(date);
+        }
+        passedTests += _assert_(archive.size() == 24);
+        passedTests += _assert_(archive.segmentCount() == 4); // 20 records on disk, 4 kept in memory
+        std::vector<ArchivedReservation> user1 = archive.findByPatron(te.user1.ID, Date::parseDate("2023-01-01"),
+                                                                      Date::parseDate("2023-01-30"));
+        passedTests += _assert_(user1.size() == 8);
+        passedTests += _assert_(user1.front().fulfilledOn == Date::parseDate("2023-01-01"));
+        passedTests += _assert_(user1.back().fulfilledOn == Date::parseDate("2023-01-22"));
+        std::vector<ArchivedReservation> book2 = archive.findByISBN(te.book2.ISBN, Date::parseDate("2023-01-05"),
+                                                                    Date::parseDate("2023-01-18"));
+        passedTests += _assert_(book2.size() == 4);
+        passedTests += _assert_(book2.front().fulfilledOn == Date::parseDate("2023-01-06"));
+        passedTests += _assert_(book2.back().record.patronID == te.user3.ID);
+        std::vector<ArchivedReservation> recent = archive.findByPatron(te.user3.ID, Date::parseDate("2023-01-22"),
+                                                                       Date::parseDate("2023-02-01"));
+        passedTests += _assert_(recent.size() == 1);
+        passedTests += _assert_(recent.front().record.bookISBN == te.book4.ISBN);
+        passedTests += _assert_(archive.findByPatron(te.user4.ID, Date::parseDate("2023-01-01"),
+                                                     Date::parseDate("2023-12-30")).empty());
+        try { // reservations can only be appended in time order
+            archive.append(ReservationRecord(te.user1, te.book1), Date::parseDate("2022-12-30"));
+            passedTests += _assert_(false);
+        } catch (ArchiveOutOfOrder &e) {
+            passedTests += _assert_(true);
+        }
+    }
+    ReservationArchive reopened(directory, 4, 5, 2);
+    passedTests += _assert_(reopened.size() == 24);
+    std::vector<ArchivedReservation> user2 = reopened.findByPatron(te.user2.ID, Date::parseDate("2023-01-10"),
+                                                                   Date::parseDate("2023-01-24"));
+    passedTests += _assert_(user2.size() == 5);
+    reopened.append(ReservationRecord(te.user2, te.book1), Date::parseDate("2023-01-25"));
+    user2 = reopened.findByPatron(te.user2.ID, Date::parseDate("2023-01-10"), Date::parseDate("2023-01-25"));
+    passedTests += _assert_(user2.size() == 6);
+    removeArchiveDirectory(directory);
+    return std::make_pair(passedTests, 15);
+}
+
+std::pair<int, int> reservationArchiveTestFulfilledReservations() {
+    int passedTests = 0;
+    TestEnvironment te;
+    te.book1.copies = 2;
+    te.book2.copies = 1;
+    const std::string directory = makeArchiveDirectory();
+    ReservationArchive archive(directory, 2, 4, 2);
+    BookReservationManagementSystem brms(5);
+    brms.indexBookToDB(te.book1);
+    brms.indexBookToDB(te.book2);
+    brms.enqueueReservation(te.user1, te.book1);
+    brms.enqueueReservation(te.user2, te.book2);
+    brms.processReservation();
+    brms.processReservation();
+    brms.archiveFulfilledReservations(archive, Date::parseDate("2023-09-01"));
+    passedTests += _assert_(brms.fulfilledReservations.isEmpty());
+    brms.enqueueReservation(te.user3, te.book1);
+    brms.processReservation();
+    brms.archiveFulfilledReservations(archive, Date::parseDate("2023-09-02"));
+    passedTests += _assert_(archive.size() == 3);
+    std::vector<ArchivedReservation> book1 = archive.findByISBN(te.book1.ISBN, Date::parseDate("2023-09-01"),
+                                                                Date::parseDate("2023-09-30"));
+    passedTests += _assert_(book1.size() == 2);
+    passedTests += _assert_(book1[0].record.patronID == te.user1.ID);
+    passedTests += _assert_(book1[1].record.patronID == te.user3.ID);
+    passedTests += _assert_(book1[1].fulfilledOn == Date::parseDate("2023-09-02"));
+    removeArchiveDirectory(directory);
+    return std::make_pair(passedTests, 6);
+}
+
+std::pair<int, int> reservationArchiveTestInvalidSettings() {
+    int passedTests = 0;
+    const std::string directory = makeArchiveDirectory();
+    const int settings[][3] = {{0, 4, 2}, {2, 0, 2}, {2, 4, 0}, {-1, 4, 2}, {2, -4, 2}, {2, 4, -2}};
+    for (const auto &setting : settings) {
+        try {
+            ReservationArchive archive(directory, setting[0], setting[1], setting[2]);
+        } catch (std::invalid_argument &e) {
+            passedTests += 1;
+        }
+    }
+    removeArchiveDirectory(directory);
+    return std::make_pair(passedTests, 6);
+}
+
+std::pair<int, int> reservationArchiveTestUnavailableDirectory() {
+    int passedTests = 0;
+    TestEnvironment te;
+    const std::string directory = makeArchiveDirectory();
+    {
+        ReservationArchive archive(directory, 2, 1, 1);
+        Date date = Date::parseDate("2023-03-01");
+        for (int i = 0; i < 3; ++i) { // the first record is spilled, the other two stay in memory
+            archive.append(ReservationRecord(te.user1, te.book1), date);
+            date = Date::getNextDate(date);
+        }
+        removeArchiveDirectory(directory);
+        try {
+            archive.flush();
+        } catch (ArchiveSegmentUnavailable &e) {
+            passedTests += 1;
+        }
+        passedTests += _assert_(archive.size() == 3);
+    } // the destructor fails to spill the window again and must not throw
+    passedTests += 1;
+    return std::make_pair(passedTests, 3);
+}
+
+int reservationArchiveTests() {
+    int passedTests = 0;
+    int totalTests = 0;
+    std::pair<int, int> r1 = reservationArchiveTestTimeRangeQueries();
+    passedTests += r1.first;
+    totalTests += r1.second;
+    std::pair<int, int> r2 = reservationArchiveTestFulfilledReservations();
+    passedTests += r2.first;
+    totalTests += r2.second;
+    std::pair<int, int> r3 = reservationArchiveTestInvalidSettings();
+    passedTests += r3.first;
+    totalTests += r3.second;
+    std::pair<int, int> r4 = reservationArchiveTestUnavailableDirectory();
+    passedTests += r4.first;
+    totalTests += r4.second;
+    double grade = static_cast<double>(passedTests * 100) / totalTests;
+    grade = std::round(grade * 10) / 10;
+    std::cout << "Total tests passed: " << passedTests << " out of " << totalTests << " (" << grade << "%)"  << std::endl;
+    return 0;
+}
+
+#endif //RESERVATIONARCHIVETESTS_H
@@ -12,10 +12,14 @@
 #include "Utils.h"
 #include "Stack.h"
 #include "UnorderedSet.h"
+#include "UnorderedHashSet.h"
 #include "HashTable.h"
+#include "DenseHashTable.h"
 
 class BookRecommendation {
 public:
+    // Sizes the tables for the expected number of patrons and books, so they do not rehash while being filled
+    explicit BookRecommendation(unsigned int expectedPatrons = 100, unsigned int expectedBooks = 100);
     void addUserBorrowedBook(Patron& userID, Book& book);
     std::vector<Book> getBookRecommendations(const std::string& targetUserID, int numRecommendations, int neighborhoodSize);
     double calculateSimilarity(const std::string& userID1, const std::string& userID2);
@@ -23,8 +27,13 @@ public:
     UnorderedSet<Book> getRecommendedBooks(const UnorderedSet<std::string>& neighborhood, const std::string& targetUserID);
 
 private:
-    HashTable<std::string, UnorderedSet<Book>> userBorrowedBooks;
-    HashTable<std::string, UnorderedSet<Patron>> bookBorrowedByUsers;
+    // calculateSimilarity only asks whether a patron borrowed a book, so the borrowed books are hashed, not ordered
+    using BorrowedBooks = UnorderedSet<Book, HashBackend<>>;
+
+    // getNeighborhood scans every patron, so the patrons' sets are kept packed for a linear scan
+    DenseHashTable<std::string, BorrowedBooks> userBorrowedBooks;
+    // The sets live in a slab, so growing the table moves 8-byte handles rather than whole sets
+    HashTable<std::string, UnorderedSet<Patron>, 32, SlabValuePolicy<std::string>> bookBorrowedByUsers;
 };
 
 #endif //BOOKRECOMMENDATION_H
@@ -0,0 +1,107 @@
+#ifndef CONCURRENTHASHTABLE_H
+#define CONCURRENTHASHTABLE_H
+/**
+ * Implementation of a hopscotch hash table which can be shared between threads.
+ *
+ * Buckets are grouped in segments of 64. A writer locks the segment of the key's home bucket and the one after it, which
+ * covers the whole neighbourhood, so writers on different parts of the table never wait on each other. Readers take no
+ * lock at all: every segment carries a version that writers make odd while they move entries around, and a lookup that
+ * did not find its key retries if the version of the home segment changed underneath it.
+ *
+ * Entries are immutable and updated by swapping in a new one. Removed entries and the bucket arrays left behind by a
+ * resize are reclaimed through hazard pointers, so a reader never dereferences freed memory. Since a reader cannot hold
+ * a reference into the table safely, lookups copy the value out instead of returning a pointer.
+ */
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "HashTable.h"
+
+template <typename KeyType, typename ValueType, unsigned int H = 32>
+class ConcurrentHashTable {
+public:
+    explicit ConcurrentHashTable(unsigned int size = 100, double threshold = 0.7);
+    ~ConcurrentHashTable();
+    ConcurrentHashTable(const ConcurrentHashTable&) = delete;
+    ConcurrentHashTable& operator=(const ConcurrentHashTable&) = delete;
+    bool insert(const KeyType& key, const ValueType& value);
+    bool search(const KeyType& key, ValueType& value);
+    bool contains(const KeyType& key);
+    bool updateValueForKey(const KeyType& key, const ValueType& newValue);
+    bool remove(const KeyType& key);
+    unsigned int size() const;
+    unsigned int tableSize();
+    double loadFactor();
+
+private:
+    static_assert(H > 0 && H <= 64, "The hopscotch neighbourhood must fit in a 64-bit bitmap");
+    // A segment is at least as wide as a neighbourhood, so a neighbourhood spans at most two segments
+    static constexpr unsigned int SEGMENT_SIZE = 64;
+    static constexpr unsigned int MAX_HAZARD_POINTERS = 128;
+    static constexpr unsigned int RETIRE_THRESHOLD = 2 * MAX_HAZARD_POINTERS;
+    using HopBitmap = typename std::conditional<(H <= 32), std::uint32_t, std::uint64_t>::type;
+
+    struct Entry {
+        const KeyType key;
+        const ValueType value;
+
+        Entry(const KeyType& key, const ValueType& value) : key(key), value(value) {}
+    };
+
+    struct Bucket {
+        std::atomic<Entry*> entry{nullptr};
+        std::atomic<HopBitmap> hopInfo{0};
+    };
+
+    struct Segment {
+        std::mutex lock;
+        // Odd while a writer is moving entries whose home bucket is in this segment
+        std::atomic<unsigned int> version{0};
+    };
+
+    // The bucket array has H - 1 extra buckets at its end, so neighbourhoods never wrap around
+    struct Table {
+        const unsigned int size;
+        const unsigned int segmentCount;
+        std::unique_ptr<Bucket[]> buckets;
+        std::unique_ptr<Segment[]> segments;
+
+        explicit Table(unsigned int size);
+    };
+
+    struct alignas(64) HazardSlot {
+        std::atomic<std::thread::id> owner;
+        std::atomic<Table*> table;
+        std::atomic<Entry*> entry;
+
+        HazardSlot() : owner(std::thread::id()), table(nullptr), entry(nullptr) {}
+    };
+
+    const double loadFactorThreshold;
+    std::atomic<Table*> currentTable;
+    std::atomic<unsigned int> elementCount;
+    HazardSlot hazardSlots[MAX_HAZARD_POINTERS];
+    std::mutex retireLock;
+    std::vector<Entry*> retiredEntries;
+    std::vector<Table*> retiredTables;
+
+    HazardSlot* acquireHazardSlot();
+    void releaseHazardSlot(HazardSlot* slot);
+    Table* protectTable(HazardSlot* slot);
+    bool protectEntry(HazardSlot* slot, Table* table, const Bucket& bucket, Entry*& entry);
+    bool find(const KeyType& key, ValueType* value);
+    Table* lockNeighbourhood(HazardSlot* slot, const KeyType& key, unsigned int& home);
+    void unlockNeighbourhood(Table* table, unsigned int home);
+    int findIndex(Table* table, unsigned int home, const KeyType& key) const;
+    bool place(Table* table, unsigned int home, Entry* entry);
+    void resize(Table* table);
+    void retire(Entry* entry);
+    void retire(Table* table);
+    void reclaim();
+};
+
+#include "../src/ConcurrentHashTable.cpp"
+
+#endif //CONCURRENTHASHTABLE_H
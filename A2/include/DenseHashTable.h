@@ -0,0 +1,124 @@
+#ifndef DENSEHASHTABLE_H
+#define DENSEHASHTABLE_H
+/**
+ * Implementation of a dense hash map, which keeps its entries packed in insertion order in a vector and only their
+ * positions in the hash index.
+ *
+ * Each index slot is 8 bytes: the position of its entry, and the low 32 bits of the entry's hash, which give the slot's
+ * home and rule out most key comparisons without touching the entry. Slots are probed linearly and removed with
+ * backward shifting, so the index never holds tombstones. Removing an entry moves the last entry into its place, so the
+ * entries stay packed, and iterating over the table is a linear scan over exactly size() entries.
+ * Values move when the entries vector grows or an entry is removed, so pointers returned by search() only stay valid
+ * until the next insertion or removal. The index is allocated by the first insertion, so an empty table, or one that was
+ * moved from, holds no memory.
+ */
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <iterator>
+#include <type_traits>
+#include "HashTable.h"
+
+template <typename KeyType, typename ValueType, typename Hasher = DefaultHasher<KeyType>>
+class DenseHashTable {
+private:
+    using KeyView = typename HashKeyView<KeyType>::type;
+
+    // Number of lookups whose index slots searchBatch() loads at the same time
+    static constexpr unsigned int BATCH_SIZE = 16;
+    static constexpr unsigned int MIN_TABLE_SIZE = 8;
+
+    // entry is the position of the slot's entry plus one, so that an all-zero slot is empty
+    struct IndexSlot {
+        std::uint32_t entry;
+        std::uint32_t hash;
+    };
+
+public:
+    struct Entry {
+        KeyType key;
+        ValueType value;
+
+        Entry* operator->() {
+            return this;
+        }
+
+        const Entry* operator->() const {
+            return this;
+        }
+    };
+
+    // The number of index slots
+    unsigned int tableSize;
+    double loadFactorThreshold;
+    template <bool Const>
+    class BasicIterator {
+    public:
+        using EntryType = typename std::conditional<Const, const Entry, Entry>::type;
+
+        explicit BasicIterator(EntryType* current) : current(current) {}
+
+        BasicIterator& operator++() {
+            ++current;
+            return *this;
+        }
+
+        bool operator!=(const BasicIterator& other) const {
+            return current != other.current;
+        }
+
+        bool operator==(const BasicIterator& other) const {
+            return current == other.current;
+        }
+
+        EntryType& operator*() const {
+            return *current;
+        }
+
+    private:
+        EntryType* current;
+    };
+
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    explicit DenseHashTable(unsigned int size = 100, double threshold = 0.7);
+    Iterator begin();
+    Iterator end();
+    ConstIterator begin() const;
+    ConstIterator end() const;
+    ValueType& operator[](KeyView key);
+    bool insert(KeyView key, const ValueType& value);
+    template <typename Function>
+    bool upsert(KeyView key, Function&& function);
+    ValueType* search(KeyView key);
+    const ValueType* search(KeyView key) const;
+    template <typename LookupKeys>
+    void searchBatch(const LookupKeys& keys, std::vector<ValueType*>& results);
+    bool remove(KeyView key);
+    void clear();
+    void reserve(unsigned int count);
+    unsigned int size() const;
+    double loadFactor() const;
+    HashTableStats stats() const;
+
+private:
+    std::vector<IndexSlot> index;
+    std::vector<Entry> entries;
+    unsigned int rehashCount = 0;
+    std::chrono::nanoseconds rehashTime{0};
+
+    unsigned int mask() const;
+    int findSlot(KeyView key, size_t hash) const;
+    void claim(std::uint32_t hash, std::uint32_t entry);
+    void vacate(unsigned int slot);
+    template <typename MakeValue>
+    std::pair<ValueType&, bool> findOrPlace(KeyView key, MakeValue&& makeValue);
+    void rehash(unsigned int newTableSize);
+};
+
+#include "../src/DenseHashTable.cpp"
+
+#endif //DENSEHASHTABLE_H
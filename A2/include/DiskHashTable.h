@@ -0,0 +1,166 @@
+#ifndef DISKHASHTABLE_H
+#define DISKHASHTABLE_H
+/**
+ * Implementation of a disk-backed hash table with std::string keys, built on extendible hashing, for tables larger than
+ * the memory they may use.
+ *
+ * The file is a sequence of fixed-size pages. Page 0 holds a header; every other page is a bucket holding variable-length
+ * records (the key's hash, the key and the encoded value). The directory maps the low globalDepth bits of a key's hash
+ * to the bucket holding the key, and several directory entries share a bucket whose local depth is below the global
+ * depth. When a bucket is full, only that bucket is split in two; when it was already referenced by a single entry, the
+ * directory doubles first, which copies page numbers but not a single record. The directory stays in memory and is
+ * written after the last page by flush().
+ *
+ * Pages are read and written through a cache holding at most cachePages pages. When the cache is full, a clock hand
+ * sweeps the frames and evicts the first page that was not used since the hand last passed it, writing it back if it was
+ * changed, so the table uses about cachePages * pageSize bytes plus 4 bytes per directory entry, however many entries
+ * it holds. Values are stored through a DiskValueCodec, and search() returns a decoded copy.
+ * Buckets are not merged when entries are removed.
+ */
+#include <string>
+#include <string_view>
+#include <optional>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "HashTable.h"
+#include "Utils.h"
+
+/**
+ * Converts values to the bytes they are stored as inside a page, and back. Trivially copyable values are stored as they
+ * are; other types need a specialization.
+ */
+template <typename ValueType>
+struct DiskValueCodec {
+    static_assert(std::is_trivially_copyable<ValueType>::value,
+                  "Values that are not trivially copyable need a DiskValueCodec specialization");
+
+    static void encode(const ValueType& value, std::string& bytes);
+    static ValueType decode(const char* bytes, size_t length);
+};
+
+template <>
+struct DiskValueCodec<std::string> {
+    static void encode(const std::string& value, std::string& bytes);
+    static std::string decode(const char* bytes, size_t length);
+};
+
+template <>
+struct DiskValueCodec<Book> {
+    static void encode(const Book& value, std::string& bytes);
+    static Book decode(const char* bytes, size_t length);
+};
+
+// Counters of the page cache, used to size it against a memory budget
+struct DiskHashTableStats {
+    unsigned long long pageReads = 0;
+    unsigned long long pageWrites = 0;
+    unsigned long long cacheHits = 0;
+    unsigned int splitCount = 0;
+    unsigned int directoryDoublings = 0;
+    unsigned int globalDepth = 0;
+    unsigned int pageCount = 0;
+    unsigned int size = 0;
+    size_t bytesUsed = 0;
+};
+
+template <typename ValueType>
+class DiskHashTable {
+public:
+    using Codec = DiskValueCodec<ValueType>;
+
+    static constexpr std::uint32_t VERSION = 1;
+
+    explicit DiskHashTable(const std::string& path, unsigned int cachePages = 64, unsigned int pageSize = 4096);
+    ~DiskHashTable();
+    DiskHashTable(const DiskHashTable&) = delete;
+    DiskHashTable& operator=(const DiskHashTable&) = delete;
+    bool insert(std::string_view key, const ValueType& value);
+    bool insert_or_assign(std::string_view key, const ValueType& value);
+    std::optional<ValueType> search(std::string_view key);
+    bool contains(std::string_view key);
+    bool remove(std::string_view key);
+    void flush();
+    unsigned int size() const;
+    DiskHashTableStats stats() const;
+
+private:
+    static constexpr char MAGIC[8] = {'H', 'T', 'D', 'I', 'S', 'K', 'E', 'X'};
+    static constexpr std::uint32_t MAX_DEPTH = 32;
+
+    // Every field has a fixed width; the directory is stored at directoryOffset, after the last page
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t pageSize;
+        std::uint32_t pageCount;
+        std::uint32_t globalDepth;
+        std::uint32_t size;
+        std::uint32_t reserved;
+        std::uint64_t directoryOffset;
+    };
+
+    // The start of every bucket page; records follow it back to back
+    struct PageHeader {
+        std::uint32_t localDepth;
+        std::uint32_t recordCount;
+        std::uint32_t usedBytes;
+        std::uint32_t reserved;
+    };
+
+    // The start of every record, followed by the key's bytes and the value's bytes
+    struct RecordHeader {
+        std::uint32_t hash;
+        std::uint32_t keyLength;
+        std::uint32_t valueLength;
+    };
+
+    struct Frame {
+        std::uint32_t page;
+        bool dirty;
+        bool referenced;
+        std::vector<char> bytes;
+    };
+
+    int descriptor = -1;
+    std::string path;
+    unsigned int pageSize;
+    unsigned int cachePages;
+    std::uint32_t pageCount = 0;
+    std::uint32_t globalDepth = 0;
+    std::uint32_t elementCount = 0;
+    std::vector<std::uint32_t> directory;
+    std::vector<Frame> frames;
+    // Maps a cached page to its frame
+    HashTable<std::uint32_t, unsigned int> pageFrames;
+    unsigned int clockHand = 0;
+    unsigned long long pageReads = 0;
+    unsigned long long pageWrites = 0;
+    unsigned long long cacheHits = 0;
+    unsigned int splitCount = 0;
+    unsigned int directoryDoublings = 0;
+
+    static std::uint32_t hashKey(std::string_view key);
+    Frame& page(std::uint32_t pageNumber);
+    std::uint32_t newPage(std::uint32_t localDepth);
+    Frame& frameFor(std::uint32_t pageNumber, bool read);
+    void writeFrame(Frame& frame);
+    void readAt(char* bytes, size_t length, std::uint64_t offset);
+    void writeAt(const char* bytes, size_t length, std::uint64_t offset);
+    std::uint32_t bucketOf(std::uint32_t hash) const;
+    long findRecord(const char* bucket, std::string_view key, std::uint32_t hash) const;
+    static void appendRecord(char* bucket, const char* record, size_t length);
+    std::string makeRecord(std::string_view key, const ValueType& value, std::uint32_t hash) const;
+    bool place(std::string_view key, std::uint32_t hash, const std::string& record);
+    void split(std::uint32_t pageNumber);
+};
+
+#include "../src/DiskHashTable.cpp"
+
+#endif //DISKHASHTABLE_H
@@ -0,0 +1,173 @@
+#ifndef FROZENHASHTABLE_H
+#define FROZENHASHTABLE_H
+/**
+ * Implementation of a read-only hash table with std::string keys that lives in a binary image file.
+ *
+ * freeze() writes the entries of a HashTable into an image: a versioned header, an open-addressing slot array with
+ * linear probing, and a heap holding the bytes of every string. Slots refer to their key (and to string values) by
+ * offset into the heap, so the image holds no pointers and can be mapped at any address. Opening an image maps the file
+ * read-only with mmap and validates its header; lookups then run directly against the mapped pages, and the operating
+ * system only reads the pages that lookups actually touch.
+ *
+ * Values are stored through a FrozenValueCodec: trivially copyable values are stored as they are, while std::string and
+ * Book values are stored as references into the string heap and read back as views.
+ */
+#include <string>
+#include <string_view>
+#include <optional>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "HashTable.h"
+#include "Utils.h"
+
+// A string stored in the heap of a frozen image
+struct FrozenStringRef {
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+// Collects the strings of an image while it is being written
+class FrozenStringHeap {
+public:
+    FrozenStringRef add(std::string_view string);
+    const std::string& bytes() const;
+
+private:
+    std::string heap;
+};
+
+/**
+ * Converts values to the form they are stored in inside a frozen image, and back to a view of the stored form.
+ * Trivially copyable values are stored as they are; other types need a specialization.
+ *
+ * TYPE_TAG is written into the image and checked when it is opened, so an image cannot be read as another value type.
+ * For trivially copyable values it is built from the kind of type and its size and alignment; structs of the same size
+ * and alignment need a specialization to tell them apart.
+ */
+template <typename ValueType>
+struct FrozenValueCodec {
+    static_assert(std::is_trivially_copyable<ValueType>::value,
+                  "Values that are not trivially copyable need a FrozenValueCodec specialization");
+    using stored_type = ValueType;
+    using view_type = ValueType;
+
+    // 1 for bool, 2 for floating point, 3 for signed integers, 4 for unsigned integers, 5 for enums and 6 for the rest
+    static constexpr std::uint32_t TYPE_KIND =
+            std::is_same<ValueType, bool>::value ? 1 :
+            std::is_floating_point<ValueType>::value ? 2 :
+            std::is_integral<ValueType>::value ? (std::is_signed<ValueType>::value ? 3 : 4) :
+            std::is_enum<ValueType>::value ? 5 : 6;
+    static constexpr std::uint32_t TYPE_TAG = TYPE_KIND << 24 | (sizeof(ValueType) & 0xFFFF) << 8 |
+                                              alignof(ValueType);
+
+    static stored_type encode(const ValueType& value, FrozenStringHeap& heap);
+    static view_type decode(const stored_type& stored, const char* heap);
+};
+
+template <>
+struct FrozenValueCodec<std::string> {
+    using stored_type = FrozenStringRef;
+    using view_type = std::string_view;
+
+    static constexpr std::uint32_t TYPE_TAG = 0x10000001;
+
+    static stored_type encode(const std::string& value, FrozenStringHeap& heap);
+    static view_type decode(const stored_type& stored, const char* heap);
+};
+
+// A Book read back from a frozen image; its strings point into the mapped image
+struct FrozenBook {
+    std::string_view ISBN;
+    std::string_view title;
+    std::string_view author;
+    std::string_view publisher;
+    std::string_view yearPublished;
+    int copies;
+};
+
+template <>
+struct FrozenValueCodec<Book> {
+    struct stored_type {
+        FrozenStringRef ISBN;
+        FrozenStringRef title;
+        FrozenStringRef author;
+        FrozenStringRef publisher;
+        FrozenStringRef yearPublished;
+        std::int32_t copies;
+    };
+    using view_type = FrozenBook;
+
+    static constexpr std::uint32_t TYPE_TAG = 0x10000002;
+
+    static stored_type encode(const Book& value, FrozenStringHeap& heap);
+    static view_type decode(const stored_type& stored, const char* heap);
+};
+
+template <typename ValueType>
+class FrozenHashTable {
+public:
+    using Codec = FrozenValueCodec<ValueType>;
+    using View = typename Codec::view_type;
+
+    static constexpr std::uint32_t VERSION = 2;
+
+    template <typename Table>
+    static void freeze(Table& table, const std::string& path);
+    explicit FrozenHashTable(const std::string& path);
+    ~FrozenHashTable();
+    FrozenHashTable(FrozenHashTable&& other) noexcept;
+    FrozenHashTable(const FrozenHashTable&) = delete;
+    FrozenHashTable& operator=(const FrozenHashTable&) = delete;
+    FrozenHashTable& operator=(FrozenHashTable&&) = delete;
+    std::optional<View> search(std::string_view key) const;
+    bool contains(std::string_view key) const;
+    unsigned int size() const;
+    unsigned int slotCount() const;
+
+private:
+    static constexpr char MAGIC[8] = {'H', 'T', 'F', 'R', 'O', 'Z', 'E', 'N'};
+
+    // Every field has a fixed width, and the slot array starts on a cache line
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t slotSize;
+        // The TYPE_TAG of the codec the values were written with
+        std::uint32_t valueType;
+        std::uint32_t reserved;
+        std::uint32_t slotCount;
+        std::uint32_t size;
+        std::uint64_t slotsOffset;
+        std::uint64_t heapOffset;
+        std::uint64_t heapSize;
+    };
+
+    // A hash of 0 marks an empty slot
+    struct Slot {
+        std::uint64_t hash;
+        FrozenStringRef key;
+        typename Codec::stored_type value;
+    };
+
+    const char* image = nullptr;
+    size_t imageSize = 0;
+    const Header* header = nullptr;
+    const Slot* slots = nullptr;
+    const char* heap = nullptr;
+
+    static std::uint64_t hashKey(std::string_view key);
+    const Slot* findSlot(std::string_view key) const;
+};
+
+#include "../src/FrozenHashTable.cpp"
+
+#endif //FROZENHASHTABLE_H
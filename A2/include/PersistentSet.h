@@ -0,0 +1,117 @@
+#ifndef PERSISTENTSET_H
+#define PERSISTENTSET_H
+/**
+ * Implementation of a persistent set, a balanced search tree whose nodes are never changed once built and are shared
+ * between copies of the set.
+ *
+ * Copying a set only takes a reference to its root. Insertions and erasures copy the O(log n) nodes on the path to the
+ * changed key and share every other subtree with the sets they were copied from, so a copy is a cheap immutable
+ * snapshot: a reader may keep iterating over its copy, on another thread as well, while the original goes on changing.
+ * Nodes are reference counted and deleted with the last set that reaches them.
+ *
+ * The tree is weight-balanced: the subtree sizes kept for rank() and select() also decide the rotations, so nodes need
+ * neither a colour nor a parent pointer, which could not be shared between the trees a node belongs to.
+ */
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+template <typename Key>
+struct PersistentNode {
+    const Key key;
+    PersistentNode* const left;
+    PersistentNode* const right;
+    // The number of keys in the subtree rooted at this node, including its own
+    const size_t size;
+    // The number of sets and parent nodes that reach this node
+    std::atomic<size_t> references;
+
+    PersistentNode(const Key& k, PersistentNode* l, PersistentNode* r)
+            : key(k), left(l), right(r), size(1 + (l == nullptr ? 0 : l->size) + (r == nullptr ? 0 : r->size)),
+              references(1) {}
+};
+
+template <typename Key>
+class PersistentSet {
+public:
+    // Iterates in sorted order, keeping the path from the root to the current node
+    class Iterator {
+    public:
+        explicit Iterator(PersistentNode<Key>* root) {
+            pushLeftSpine(root);
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+
+        bool operator==(const Iterator& other) const {
+            return path.empty() ? other.path.empty() : !other.path.empty() && path.back() == other.path.back();
+        }
+
+        const Key& operator*() const {
+            return path.back()->key;
+        }
+
+        Iterator& operator++() {
+            PersistentNode<Key>* node = path.back();
+            path.pop_back();
+            pushLeftSpine(node->right);
+            return *this;
+        }
+
+    private:
+        std::vector<PersistentNode<Key>*> path;
+
+        void pushLeftSpine(PersistentNode<Key>* node) {
+            for (; node != nullptr; node = node->left)
+                path.push_back(node);
+        }
+    };
+
+    PersistentSet();
+    ~PersistentSet();
+    PersistentSet(const PersistentSet& other);
+    PersistentSet(PersistentSet&& other) noexcept;
+    PersistentSet& operator=(const PersistentSet& other);
+    PersistentSet& operator=(PersistentSet&& other) noexcept;
+    Iterator begin() const;
+    Iterator end() const;
+    bool insert(const Key& key);
+    bool search(const Key& key) const;
+    bool erase(const Key& key);
+    void clear();
+    size_t size() const;
+    size_t rank(const Key& key) const;
+    const Key& select(size_t index) const;
+    PersistentSet snapshot() const;
+
+private:
+    // A subtree may weigh at most DELTA times its sibling, and is rotated twice if its inner child weighs at least
+    // RATIO times its outer child; (3, 2) are the only integer parameters that keep the tree balanced
+    static constexpr size_t DELTA = 3;
+    static constexpr size_t RATIO = 2;
+
+    PersistentNode<Key>* root;
+
+    // The functions below take over the references held by their node arguments, unless documented as borrowing them,
+    // and return a node the caller holds a reference to
+    static PersistentNode<Key>* retain(PersistentNode<Key>* node);
+    static void release(PersistentNode<Key>* node);
+    static size_t getSize(const PersistentNode<Key>* node);
+    static PersistentNode<Key>* makeNode(const Key& key, PersistentNode<Key>* left, PersistentNode<Key>* right);
+    static PersistentNode<Key>* balance(const Key& key, PersistentNode<Key>* left, PersistentNode<Key>* right);
+    static PersistentNode<Key>* rotateLeft(const Key& key, PersistentNode<Key>* left, PersistentNode<Key>* right);
+    static PersistentNode<Key>* rotateRight(const Key& key, PersistentNode<Key>* left, PersistentNode<Key>* right);
+    static PersistentNode<Key>* insertInto(PersistentNode<Key>* node, const Key& key);
+    static PersistentNode<Key>* eraseFrom(PersistentNode<Key>* node, const Key& key, bool& erased);
+    static PersistentNode<Key>* join(PersistentNode<Key>* left, PersistentNode<Key>* right);
+    static PersistentNode<Key>* eraseMin(PersistentNode<Key>* node);
+    static PersistentNode<Key>* eraseMax(PersistentNode<Key>* node);
+};
+
+#include "../src/PersistentSet.cpp"
+
+#endif //PERSISTENTSET_H
@@ -0,0 +1,106 @@
+#ifndef STATICHASHTABLE_H
+#define STATICHASHTABLE_H
+/**
+ * Implementation of a read-only hash table over a fixed set of keys, built on a minimal perfect hash function in the
+ * style of PTHash.
+ *
+ * Keys are spread over small buckets of about 5 keys each. While building, the buckets are processed from the largest
+ * to the smallest, and every bucket gets the first 16-bit pilot value that sends all of its keys to free positions of a
+ * slightly larger position space (the keys fill 98% of it). Positions past the last entry are then remapped into the
+ * holes left below it, which makes the hash minimal: the n entries sit in an array of exactly n slots.
+ *
+ * A lookup hashes the key, reads the pilot of its bucket (the pilot array takes about 3 bits per key and stays in
+ * cache) and then reads exactly one entry. Every entry keeps 32 bits of its key's hash as a fingerprint, so a lookup for
+ * a missing key almost always fails on the fingerprint without comparing keys.
+ *
+ * The key set is fixed once built, but values can be updated in place through search().
+ */
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <functional>
+#include "HashTable.h"
+
+template <typename KeyType, typename ValueType, typename Hasher = DefaultHasher<KeyType>>
+class StaticHashTable {
+private:
+    using KeyView = typename HashKeyView<KeyType>::type;
+
+    // Average number of keys per bucket, and the share of the position space that the keys fill
+    static constexpr unsigned int BUCKET_SIZE = 5;
+    static constexpr double POSITION_LOAD = 0.98;
+    static constexpr unsigned int MAX_PILOT = 0xFFFF;
+    static constexpr unsigned int MAX_SEEDS = 64;
+
+public:
+    struct Entry {
+        std::uint32_t fingerprint = 0;
+        KeyType key;
+        ValueType value;
+    };
+
+    class Iterator {
+    public:
+        explicit Iterator(Entry* entry) : entry(entry) {}
+
+        Iterator& operator++() {
+            ++entry;
+            return *this;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return entry != other.entry;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return entry == other.entry;
+        }
+
+        Entry* operator*() {
+            return entry;
+        }
+
+    private:
+        Entry* entry;
+    };
+
+    StaticHashTable() = default;
+    template <typename Range>
+    explicit StaticHashTable(const Range& entries);
+    Iterator begin();
+    Iterator end();
+    ValueType* search(KeyView key);
+    const ValueType* search(KeyView key) const;
+    bool contains(KeyView key) const;
+    unsigned int size() const;
+    double bitsPerKey() const;
+
+private:
+    std::vector<Entry> entries;
+    std::vector<std::uint16_t> pilots;
+    // Final slots of the taken positions past the last entry
+    std::vector<std::uint32_t> remapped;
+    unsigned int positionCount = 0;
+    std::uint64_t seed = 0;
+
+    // A key being placed while the table is built
+    struct PendingKey {
+        std::uint64_t hash;
+        size_t source;
+        unsigned int bucket;
+        unsigned int position;
+    };
+
+    static std::uint64_t mix(std::uint64_t value);
+    std::uint64_t keyHash(KeyView key) const;
+    unsigned int position(std::uint64_t hash, unsigned int pilot) const;
+    unsigned int slot(std::uint64_t hash) const;
+    bool findPilots(std::vector<PendingKey>& keys);
+};
+
+#include "../src/StaticHashTable.cpp"
+
+#endif //STATICHASHTABLE_H
@@ -0,0 +1,119 @@
+#ifndef SWISSHASHTABLE_H
+#define SWISSHASHTABLE_H
+/**
+ * Implementation of an open-addressing hash table in the style of Swiss tables.
+ *
+ * Next to the keys and values, the table keeps one control byte per slot: the top bit marks an empty or deleted slot,
+ * and full slots hold 7 bits of the key's hash (its tag). Slots are probed in groups of 16, and all 16 tags of a group
+ * are compared against the searched tag at once with SSE2, so keys are only compared when their tags match.
+ * It offers HashTable's basic interface (operator[], insert, updateValueForKey, search, remove, clear, iteration and
+ * stats), with the same return values, so it can be swapped in wherever only those are used.
+ */
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <chrono>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "HashTable.h"
+
+template <typename KeyType, typename ValueType>
+class SwissHashTable {
+private:
+    static constexpr unsigned int GROUP_WIDTH = 16;
+    static constexpr std::int8_t EMPTY = -128;
+    static constexpr std::int8_t DELETED = -2;
+
+    // A group of 16 control bytes, matched with a single SSE2 comparison when available
+    class Group {
+    public:
+        explicit Group(const std::int8_t* controlBytes);
+        std::uint32_t match(std::int8_t tag) const;
+        std::uint32_t matchEmpty() const;
+        std::uint32_t matchEmptyOrDeleted() const;
+
+    private:
+#if defined(__SSE2__)
+        __m128i controls;
+#else
+        const std::int8_t* controls;
+#endif
+    };
+
+    struct Slot {
+        const KeyType& key;
+        ValueType& value;
+        bool occupied;
+
+        const Slot* operator->() const {
+            return this;
+        }
+    };
+
+public:
+    unsigned int tableSize;
+    double loadFactorThreshold;
+    class Iterator {
+    public:
+        Iterator(SwissHashTable* table, unsigned int index) : table(table), index(index) {}
+
+        Iterator& operator++() {
+            ++index;
+            while (index < table->tableSize && table->controlBytes[index] < 0) {
+                ++index;
+            }
+            return *this;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return index != other.index;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return index == other.index;
+        }
+
+        Slot operator*() {
+            return Slot{table->keys[index], table->values[index], true};
+        }
+
+    private:
+        SwissHashTable* table;
+        unsigned int index;
+    };
+
+    explicit SwissHashTable(unsigned int size = 100, double threshold = 0.875);
+    Iterator begin();
+    Iterator end();
+    ValueType& operator[](const KeyType& key);
+    bool updateValueForKey(const KeyType& key, ValueType newValue);
+    bool insert(const KeyType& key, const ValueType& value);
+    ValueType* search(const KeyType& key);
+    bool remove(const KeyType& key);
+    void clear();
+    unsigned int size() const;
+    double loadFactor() const;
+    HashTableStats stats() const;
+
+private:
+    std::vector<std::int8_t> controlBytes;
+    std::vector<KeyType> keys;
+    std::vector<ValueType> values;
+    unsigned int elementCount = 0;
+    unsigned int deletedCount = 0;
+    unsigned int rehashCount = 0;
+    std::chrono::nanoseconds rehashTime{0};
+
+    unsigned int groupMask() const;
+    int findIndex(const KeyType& key, std::size_t hash) const;
+    unsigned int findInsertSlot(std::size_t hash) const;
+    unsigned int place(const KeyType& key, const ValueType& value, std::size_t hash);
+    void rehash(unsigned int newTableSize);
+};
+
+#include "../src/SwissHashTable.cpp"
+
+#endif //SWISSHASHTABLE_H
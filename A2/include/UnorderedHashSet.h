@@ -0,0 +1,83 @@
+#ifndef UNORDEREDHASHSET_H
+#define UNORDEREDHASHSET_H
+/**
+ * Implementation of the hash backend of UnorderedSet, for sets that are only asked whether they hold a key.
+ *
+ * The keys are kept in a DenseHashTable, so search() hashes the key once and compares it with the few keys whose hashes
+ * match, instead of comparing it with O(log n) keys with operator<. Iteration visits the keys in insertion order (until
+ * an erasure moves the last key into the erased key's place), not in sorted order, so the tree's rank(), select() and
+ * countInRange() are not offered.
+ */
+#include <type_traits>
+#include "UnorderedSet.h"
+#include "DenseHashTable.h"
+
+/**
+ * The hasher of a key type: its nested Hash if it has one, as Book, Patron and Date do, or else DefaultHasher.
+ */
+template <typename Key, typename = void>
+struct SetKeyHasher {
+    using type = DefaultHasher<Key>;
+};
+
+template <typename Key>
+struct SetKeyHasher<Key, std::void_t<typename Key::Hash>> {
+    using type = typename Key::Hash;
+};
+
+template <typename Key, typename Hasher>
+class UnorderedSet<Key, HashBackend<Hasher>> {
+private:
+    using KeyHasher = typename std::conditional<std::is_void<Hasher>::value, typename SetKeyHasher<Key>::type,
+                                                Hasher>::type;
+
+    // The table's values carry nothing; only its keys are used
+    struct Member {};
+
+    using Table = DenseHashTable<Key, Member, KeyHasher>;
+
+    static constexpr unsigned int MIN_TABLE_SIZE = 8;
+
+public:
+    class Iterator {
+    public:
+        explicit Iterator(typename Table::ConstIterator current) : current(current) {}
+
+        bool operator!=(const Iterator& other) const {
+            return current != other.current;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return current == other.current;
+        }
+
+        const Key& operator*() const {
+            return (*current).key;
+        }
+
+        Iterator& operator++() {
+            ++current;
+            return *this;
+        }
+
+    private:
+        typename Table::ConstIterator current;
+    };
+
+    UnorderedSet();
+    Iterator begin() const;
+    Iterator end() const;
+    bool insert(const Key& key);
+    bool search(const Key& key) const;
+    bool erase(const Key& key);
+    void clear();
+    void reserve(unsigned int count);
+    size_t size() const;
+
+private:
+    Table keys;
+};
+
+#include "../src/UnorderedHashSet.cpp"
+
+#endif //UNORDEREDHASHSET_H
@@ -6,8 +6,18 @@
 #define UNORDEREDSET_H
 /**
  * Implementation of an unordered set using a balanced red-black Tree.
+ *
+ * The Backend parameter picks how the keys are stored. The red-black tree keeps them in order, which rank(), select()
+ * and countInRange() need; HashBackend (see UnorderedHashSet.h) hashes them instead, for sets that are only asked
+ * whether they hold a key.
  */
 #include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 enum class Color { RED, BLACK, BLUE };
 
@@ -18,12 +28,70 @@ struct Node {
     Node* right;
     Node* parent;
     Color color;
+    // The number of keys in the subtree rooted at this node, including its own
+    size_t size;
 
-    explicit Node(const Key& k) : key(k), left(nullptr), right(nullptr), parent(nullptr), color(Color::RED) {}
+    explicit Node(const Key& k) : key(k), left(nullptr), right(nullptr), parent(nullptr), color(Color::RED), size(1) {}
 };
 
+/**
+ * Storage for the nodes of one set. Nodes are carved out of slabs that double in size up to MAX_SLAB_SIZE nodes, so a
+ * small set only takes a small slab, and erased nodes are kept on a free list for later insertions. release() hands
+ * back every slab at once instead of freeing nodes one by one; only keys that have a destructor are visited.
+ */
 template <typename Key>
+class NodeSlab {
+public:
+    NodeSlab() = default;
+    ~NodeSlab();
+    NodeSlab(const NodeSlab&) = delete;
+    NodeSlab& operator=(const NodeSlab&) = delete;
+    NodeSlab(NodeSlab&& other) noexcept;
+    NodeSlab& operator=(NodeSlab&& other) noexcept;
+    Node<Key>* allocate(const Key& key);
+    void free(Node<Key>* node);
+    void release(Node<Key>* root);
+    size_t bytesUsed() const;
+
+private:
+    static constexpr size_t FIRST_SLAB_SIZE = 4;
+    static constexpr size_t MAX_SLAB_SIZE = 1024;
+
+    // Raw storage for one node; a free slot holds the next free slot, and the first slot of a slab holds a SlabHeader
+    struct alignas(Node<Key>) Slot {
+        unsigned char bytes[sizeof(Node<Key>)];
+    };
+
+    struct SlabHeader {
+        Slot* previous;
+        size_t size;
+    };
+
+    static_assert(sizeof(SlabHeader) <= sizeof(Slot) && sizeof(Slot*) <= sizeof(Slot),
+                  "A node slot must be able to hold a slab header");
+
+    // The newest slab, from which unused slots are handed out; older slabs are chained through their headers
+    Slot* lastSlab = nullptr;
+    size_t lastSlabUsed = 0;
+    Slot* freeSlots = nullptr;
+
+    static SlabHeader& header(Slot* slab);
+    static Slot*& nextFree(Slot* slot);
+    static void destroyTree(Node<Key>* node);
+};
+
+// Stores the keys of an UnorderedSet in a red-black tree, ordered with operator<
+struct RedBlackTreeBackend {};
+
+// Stores the keys of an UnorderedSet in a hash table; Hasher defaults to the key's nested Hash, or to std::hash
+template <typename Hasher = void>
+struct HashBackend {};
+
+template <typename Key, typename Backend = RedBlackTreeBackend>
 class UnorderedSet {
+    static_assert(std::is_same<Backend, RedBlackTreeBackend>::value,
+                  "Include UnorderedHashSet.h to store the keys of an UnorderedSet in a hash table");
+
 public:
     Node<Key>* root;
     class Iterator {
@@ -70,6 +138,10 @@ public:
     // TODO implement the following functions in ../src/UnorderedSet.cpp
     UnorderedSet();
     ~UnorderedSet();
+    UnorderedSet(const UnorderedSet& other);
+    UnorderedSet(UnorderedSet&& other) noexcept;
+    UnorderedSet& operator=(const UnorderedSet& other);
+    UnorderedSet& operator=(UnorderedSet&& other) noexcept;
     Iterator begin() const;
     Iterator end() const;
     bool insert(const Key& key);
@@ -77,26 +149,37 @@ public:
     bool erase(const Key& key);
     void clear();
     size_t size() const;
+    size_t rank(const Key& key) const;
+    const Key& select(size_t index) const;
+    size_t countInRange(const Key& low, const Key& high) const;
+    size_t bytesUsed() const;
 
 private:
     size_t setSize;
+    NodeSlab<Key> nodes;
     // TODO implement the following functions in ../src/UnorderedSet.cpp
     //Recursively updates the size of the subtree rooted at the given node:
     void updateSize();
-    //Recursively calculates the size of the subtree rooted at the given node:
+    //Returns the size of the subtree rooted at the given node, kept up to date by every insertion, deletion and rotation:
     size_t getSize(Node<Key>* node) const;
+    //Recomputes the size of the given node from its children:
+    void resize(Node<Key>* node);
+    //Counts the keys less than (or, if inclusive, equal to) the given key:
+    size_t countBelow(const Key& key, bool inclusive) const;
     //Fixes a Red-Red violation in the Red-Black Tree:
     void fixRedRedViolation(Node<Key>* node);
     //Performs a left rotation on the subtree rooted at the given node:
     void rotateLeft(Node<Key>* node);
     //Performs a right rotation on the subtree rooted at the given node:
     void rotateRight(Node<Key>* node);
+    //Hangs the replacement where the given node hangs from its parent:
+    void replaceChild(Node<Key>* node, Node<Key>* replacement);
     //Deletes a node with only one child in the Red-Black Tree:
     void deleteOneChild(Node<Key>* node);
     //Fixes the Red-Black Tree properties after a node deletion:
     void deleteFix(Node<Key>* node);
-    //Recursively clears the Red-Black Tree starting from the given node:
-    void clearRecursive(Node<Key>* node);
+    //Recursively copies the subtree rooted at the given node into this set's slab:
+    Node<Key>* copyRecursive(const Node<Key>* node, Node<Key>* parent);
 };
 
 #include "../src/UnorderedSet.cpp"
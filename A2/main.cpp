@@ -7,6 +7,10 @@
 #include "tests/UnorderedSetTests.h"
 #include "tests/HashTableTests.h"
 #include "tests/BookRecommendationTests.h"
+#include "tests/ConcurrentHashTableTests.h"
+#include "tests/FrozenHashTableTests.h"
+#include "tests/DiskHashTableTests.h"
+#include "tests/HashTableBenchmarks.h"
 #include "include/LExceptions.h"
 /*
  * This is the driver file which directs the project on testing different modules.
@@ -25,9 +29,19 @@ int main(int argc, char *argv[]) {
             unorderedSetTests();
             std::cout << ">> HashTable:\t\t\t\t\t";
             hashTableTests();
+            std::cout << ">> ConcurrentHashTable:\t\t\t";
+            concurrentHashTableTests();
+            std::cout << ">> FrozenHashTable:\t\t\t\t";
+            frozenHashTableTests();
+            std::cout << ">> DiskHashTable:\t\t\t\t";
+            diskHashTableTests();
             std::cout << ">> Book Recommender System: \t";
             bookRecommendationTests();
             break;
+        case 1: // Benchmarking the hash table engines:
+            std::cout << ">> HashTable benchmarks:";
+            hashTableBenchmarks();
+            break;
         default:
             throw std::invalid_argument("Invalid module choice");
             break;
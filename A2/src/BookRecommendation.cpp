@@ -1,19 +1,15 @@
 #include "../include/BookRecommendation.h"
 
-void BookRecommendation::addUserBorrowedBook(Patron &userID, Book &book) {
-    // If a list of borrowed books exists for the user
-    if (userBorrowedBooks.search(userID.ID)) {
-        // Update the user's list of borrowed books
-        UnorderedSet<Book> borrowedBooks = userBorrowedBooks[userID.ID];
-
-        borrowedBooks.insert(book);
-    } else {
-        // Create a new list of borrowed books for the user
-        UnorderedSet<Book> borrowedBooks{};
+BookRecommendation::BookRecommendation(const unsigned int expectedPatrons, const unsigned int expectedBooks) {
+    userBorrowedBooks.reserve(expectedPatrons);
+    bookBorrowedByUsers.reserve(expectedBooks);
+}
 
+void BookRecommendation::addUserBorrowedBook(Patron &userID, Book &book) {
+    // Add the book to the user's list of borrowed books in place, creating the list first if the user has none
+    userBorrowedBooks.upsert(userID.ID, [&book](BorrowedBooks &borrowedBooks) {
         borrowedBooks.insert(book);
-        userBorrowedBooks.insert(userID.ID, borrowedBooks);
-    }
+    });
 }
 
 std::vector<Book> BookRecommendation::getBookRecommendations(
@@ -131,16 +127,14 @@ UnorderedSet<Book> BookRecommendation::getRecommendedBooks(const UnorderedSet<st
     // 1. Create a HashTable to store the frequency of each book borrowed by users in the neighbourhood
 
     HashTable<std::string, int> frequencyMap;
+    std::vector<BorrowedBooks *> neighborhoodBooks;
 
-    for (const auto &userID: neighborhood) {
-        const auto borrowedBooks = userBorrowedBooks.search(userID);
+    // Look up the whole neighbourhood at once, so that the patrons' buckets are loaded in parallel
+    userBorrowedBooks.searchBatch(neighborhood, neighborhoodBooks);
 
+    for (const auto borrowedBooks: neighborhoodBooks) {
         for (const auto &book: *borrowedBooks) {
-            if (frequencyMap.search(book.ISBN)) {
-                frequencyMap.updateValueForKey(book.ISBN, frequencyMap[book.ISBN] + 1);
-            } else {
-                frequencyMap.insert(book.ISBN, 1);
-            }
+            frequencyMap.upsert(book.ISBN, [](int &frequency) { frequency += 1; });
         }
     }
 
@@ -0,0 +1,593 @@
+#include "../include/ConcurrentHashTable.h"
+
+#include <algorithm>
+
+template<typename KeyType, typename ValueType, unsigned int H>
+constexpr unsigned int ConcurrentHashTable<KeyType, ValueType, H>::SEGMENT_SIZE;
+
+/**
+ * Allocates an empty bucket array with the given number of home buckets.
+ *
+ * @param size The number of home buckets
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+ConcurrentHashTable<KeyType, ValueType, H>::Table::Table(const unsigned int size) : size(size),
+    segmentCount((size + H - 1 + SEGMENT_SIZE - 1) / SEGMENT_SIZE), buckets(new Bucket[size + H - 1]),
+    segments(new Segment[segmentCount]) {
+}
+
+/**
+ * Constructor.
+ *
+ * @param size The size of the hash table
+ * @param threshold The max load factor
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+ConcurrentHashTable<KeyType, ValueType, H>::ConcurrentHashTable(const unsigned int size, const double threshold)
+    : loadFactorThreshold(threshold), currentTable(new Table(std::max(size, 1u))), elementCount(0) {
+}
+
+/**
+ * Releases every entry and bucket array, including the retired ones. No other thread may be using the table anymore.
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+ConcurrentHashTable<KeyType, ValueType, H>::~ConcurrentHashTable() {
+    Table *table = currentTable.load();
+
+    for (unsigned int i = 0; i < table->size + H - 1; ++i) {
+        delete table->buckets[i].entry.load();
+    }
+
+    delete table;
+
+    // Retired bucket arrays only point at entries that were moved to the current table, or retired on their own
+    for (Entry *entry: retiredEntries) {
+        delete entry;
+    }
+
+    for (Table *retiredTable: retiredTables) {
+        delete retiredTable;
+    }
+}
+
+/**
+ * Inserts a value for the given key if the key does not exist yet, growing the table when the threshold is reached or
+ * the key's neighbourhood is full.
+ *
+ * @param key The key to insert the value for
+ * @param value The value to insert
+ * @return Whether the key was inserted (false if it already existed)
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+bool ConcurrentHashTable<KeyType, ValueType, H>::insert(const KeyType &key, const ValueType &value) {
+    HazardSlot *slot = acquireHazardSlot();
+    Entry *entry = new Entry(key, value);
+
+    while (true) {
+        unsigned int home;
+        Table *table = lockNeighbourhood(slot, key, home);
+
+        if (findIndex(table, home, key) >= 0) {
+            unlockNeighbourhood(table, home);
+            releaseHazardSlot(slot);
+            delete entry;
+
+            return false;
+        }
+
+        if (elementCount.load() + 1 <= loadFactorThreshold * table->size && place(table, home, entry)) {
+            elementCount.fetch_add(1);
+            unlockNeighbourhood(table, home);
+            releaseHazardSlot(slot);
+
+            return true;
+        }
+
+        unlockNeighbourhood(table, home);
+        resize(table);
+    }
+}
+
+/**
+ * Copies the value of the key into the given value if the key exists. The lookup takes no lock.
+ *
+ * @param key The key to search for
+ * @param value Receives the value of the key
+ * @return Whether the key exists
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+bool ConcurrentHashTable<KeyType, ValueType, H>::search(const KeyType &key, ValueType &value) {
+    return find(key, &value);
+}
+
+/**
+ * Returns whether the key exists. The lookup takes no lock.
+ *
+ * @param key The key to search for
+ * @return Whether the key exists
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+bool ConcurrentHashTable<KeyType, ValueType, H>::contains(const KeyType &key) {
+    return find(key, nullptr);
+}
+
+/**
+ * Replaces the value of the given key if it exists. Concurrent readers see either the old or the new value.
+ *
+ * @param key The key of the value to update
+ * @param newValue The new value
+ * @return Whether the key exists
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+bool ConcurrentHashTable<KeyType, ValueType, H>::updateValueForKey(const KeyType &key, const ValueType &newValue) {
+    HazardSlot *slot = acquireHazardSlot();
+    Entry *entry = new Entry(key, newValue);
+    unsigned int home;
+    Table *table = lockNeighbourhood(slot, key, home);
+    const int index = findIndex(table, home, key);
+    Entry *oldEntry = index >= 0 ? table->buckets[index].entry.exchange(entry) : nullptr;
+
+    unlockNeighbourhood(table, home);
+    releaseHazardSlot(slot);
+
+    if (oldEntry == nullptr) {
+        delete entry;
+
+        return false;
+    }
+
+    retire(oldEntry);
+
+    return true;
+}
+
+/**
+ * Removes the key from the hash table if it exists.
+ *
+ * @param key The key to remove
+ * @return Whether the removal was successful
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+bool ConcurrentHashTable<KeyType, ValueType, H>::remove(const KeyType &key) {
+    HazardSlot *slot = acquireHazardSlot();
+    unsigned int home;
+    Table *table = lockNeighbourhood(slot, key, home);
+    const int index = findIndex(table, home, key);
+    Entry *entry = nullptr;
+
+    if (index >= 0) {
+        Bucket &homeBucket = table->buckets[home];
+
+        homeBucket.hopInfo.store(homeBucket.hopInfo.load() & ~(HopBitmap(1) << (index - home)));
+        entry = table->buckets[index].entry.exchange(nullptr);
+        elementCount.fetch_sub(1);
+    }
+
+    unlockNeighbourhood(table, home);
+    releaseHazardSlot(slot);
+
+    if (entry == nullptr) return false;
+
+    retire(entry);
+
+    return true;
+}
+
+/**
+ * Returns the number of items in the hash table. While other threads are writing, the result is only a snapshot.
+ *
+ * @return The number of items in the hash table
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+unsigned int ConcurrentHashTable<KeyType, ValueType, H>::size() const {
+    return elementCount.load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns the number of home buckets of the current bucket array.
+ *
+ * @return The size of the hash table
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+unsigned int ConcurrentHashTable<KeyType, ValueType, H>::tableSize() {
+    HazardSlot *slot = acquireHazardSlot();
+    const unsigned int size = protectTable(slot)->size;
+
+    releaseHazardSlot(slot);
+
+    return size;
+}
+
+/**
+ * Calculates the hash table's load factor.
+ *
+ * @return The hash table's load factor
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+double ConcurrentHashTable<KeyType, ValueType, H>::loadFactor() {
+    double count = size();
+
+    return count / tableSize();
+}
+
+/**
+ * Claims a free hazard slot for the calling thread, waiting for one to be released if all of them are in use. Threads
+ * start looking at different slots so that they do not all contend for the first one.
+ *
+ * @return The claimed hazard slot
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+typename ConcurrentHashTable<KeyType, ValueType, H>::HazardSlot *
+ConcurrentHashTable<KeyType, ValueType, H>::acquireHazardSlot() {
+    const std::thread::id self = std::this_thread::get_id();
+    const size_t start = std::hash<std::thread::id>{}(self) % MAX_HAZARD_POINTERS;
+
+    while (true) {
+        for (size_t i = 0; i < MAX_HAZARD_POINTERS; ++i) {
+            HazardSlot &slot = hazardSlots[(start + i) % MAX_HAZARD_POINTERS];
+            std::thread::id unowned;
+
+            if (slot.owner.load(std::memory_order_relaxed) == unowned && slot.owner.compare_exchange_strong(unowned, self)) {
+                return &slot;
+            }
+        }
+
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * Clears the hazards of the given slot and gives it back.
+ *
+ * @param slot The slot claimed by the calling thread
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+void ConcurrentHashTable<KeyType, ValueType, H>::releaseHazardSlot(HazardSlot *slot) {
+    slot->entry.store(nullptr);
+    slot->table.store(nullptr);
+    slot->owner.store(std::thread::id());
+}
+
+/**
+ * Publishes the current bucket array as hazardous, so that it cannot be freed while the calling thread uses it.
+ *
+ * @param slot The slot claimed by the calling thread
+ * @return The protected bucket array
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+typename ConcurrentHashTable<KeyType, ValueType, H>::Table *
+ConcurrentHashTable<KeyType, ValueType, H>::protectTable(HazardSlot *slot) {
+    Table *table = currentTable.load();
+
+    // The array is only safe once it is still current after being published; otherwise it may already be retired
+    while (true) {
+        slot->table.store(table);
+
+        Table *current = currentTable.load();
+
+        if (current == table) return table;
+
+        table = current;
+    }
+}
+
+/**
+ * Publishes the entry of the given bucket as hazardous, so that it cannot be freed while the calling thread reads it.
+ * A resize leaves the old array pointing at the entries the new array uses, and writers on the new array retire them
+ * without touching the old bucket, so the entry is only safe once both its bucket and the array are unchanged after
+ * being published.
+ *
+ * @param slot The slot claimed by the calling thread
+ * @param table The bucket array the bucket belongs to, which must be protected
+ * @param bucket The bucket to read the entry of
+ * @param entry Receives the protected entry, or nullptr if the bucket is empty
+ * @return Whether the entry is protected; false means the array was replaced and the lookup has to start over
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+bool ConcurrentHashTable<KeyType, ValueType, H>::protectEntry(HazardSlot *slot, Table *table, const Bucket &bucket,
+                                                              Entry *&entry) {
+    entry = bucket.entry.load();
+
+    while (true) {
+        slot->entry.store(entry);
+
+        if (currentTable.load() != table) return false;
+
+        Entry *current = bucket.entry.load();
+
+        if (current == entry) return true;
+
+        entry = current;
+    }
+}
+
+/**
+ * Looks for the key without taking a lock. A hit is always valid since entries are immutable; a miss is only reported
+ * once the home segment's version shows that no entry was moved during the scan, and the bucket array was not replaced.
+ *
+ * @param key The key to search for
+ * @param value Receives the value of the key if it is not nullptr
+ * @return Whether the key exists
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+bool ConcurrentHashTable<KeyType, ValueType, H>::find(const KeyType &key, ValueType *value) {
+    HazardSlot *slot = acquireHazardSlot();
+
+    while (true) {
+        Table *table = protectTable(slot);
+        const unsigned int home = hashKey(key, table->size);
+        const Segment &segment = table->segments[home / SEGMENT_SIZE];
+        const unsigned int version = segment.version.load(std::memory_order_acquire);
+
+        if (version & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        HopBitmap hopInfo = table->buckets[home].hopInfo.load(std::memory_order_acquire);
+        bool replaced = false;
+
+        while (hopInfo != 0) {
+            Entry *entry;
+
+            if (!protectEntry(slot, table, table->buckets[home + lowestSetBit(hopInfo)], entry)) {
+                replaced = true;
+                break;
+            }
+
+            if (entry != nullptr && entry->key == key) {
+                if (value != nullptr) *value = entry->value;
+
+                releaseHazardSlot(slot);
+
+                return true;
+            }
+
+            hopInfo &= hopInfo - 1;
+        }
+
+        if (replaced) continue;
+
+        if (segment.version.load(std::memory_order_acquire) == version && currentTable.load() == table) {
+            releaseHazardSlot(slot);
+
+            return false;
+        }
+    }
+}
+
+/**
+ * Locks the segment of the key's home bucket and the one after it, which together cover its whole neighbourhood.
+ *
+ * @param slot The slot claimed by the calling thread
+ * @param key The key to lock the neighbourhood of
+ * @param home Receives the home bucket of the key
+ * @return The bucket array the neighbourhood was locked in, which is the current one until it is unlocked
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+typename ConcurrentHashTable<KeyType, ValueType, H>::Table *
+ConcurrentHashTable<KeyType, ValueType, H>::lockNeighbourhood(HazardSlot *slot, const KeyType &key,
+                                                              unsigned int &home) {
+    while (true) {
+        Table *table = protectTable(slot);
+        const unsigned int segment = (home = hashKey(key, table->size)) / SEGMENT_SIZE;
+
+        // Segments are always locked in increasing order, the same order resize uses
+        table->segments[segment].lock.lock();
+        if (segment + 1 < table->segmentCount) table->segments[segment + 1].lock.lock();
+
+        if (currentTable.load() == table) return table;
+
+        // The array was replaced while this thread waited for the lock
+        unlockNeighbourhood(table, home);
+    }
+}
+
+/**
+ * Unlocks the segments locked by lockNeighbourhood.
+ *
+ * @param table The bucket array the neighbourhood was locked in
+ * @param home The home bucket of the key
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+void ConcurrentHashTable<KeyType, ValueType, H>::unlockNeighbourhood(Table *table, const unsigned int home) {
+    const unsigned int segment = home / SEGMENT_SIZE;
+
+    if (segment + 1 < table->segmentCount) table->segments[segment + 1].lock.unlock();
+    table->segments[segment].lock.unlock();
+}
+
+/**
+ * Returns the index of the bucket holding the given key. The neighbourhood must be locked.
+ *
+ * @param table The bucket array to search
+ * @param home The home bucket of the key
+ * @param key The key to search for
+ * @return The index of the bucket holding the key, or -1 if the key does not exist
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+int ConcurrentHashTable<KeyType, ValueType, H>::findIndex(Table *table, const unsigned int home,
+                                                          const KeyType &key) const {
+    HopBitmap hopInfo = table->buckets[home].hopInfo.load(std::memory_order_relaxed);
+
+    while (hopInfo != 0) {
+        const unsigned int index = home + lowestSetBit(hopInfo);
+
+        if (table->buckets[index].entry.load(std::memory_order_relaxed)->key == key) return static_cast<int>(index);
+
+        hopInfo &= hopInfo - 1;
+    }
+
+    return -1;
+}
+
+/**
+ * Places the entry in the neighbourhood of its home bucket. The free bucket is searched for in the locked segments only,
+ * and is moved closer by displacing entries whose home bucket is also in the locked segments. The version of a moved
+ * entry's home segment is odd while the entry is in two buckets, so that lookups do not report a miss in between.
+ *
+ * @param table The bucket array to place the entry in
+ * @param home The home bucket of the entry, whose neighbourhood must be locked
+ * @param entry The entry to place
+ * @return Whether the entry was placed (false if the table has to grow first)
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+bool ConcurrentHashTable<KeyType, ValueType, H>::place(Table *table, const unsigned int home, Entry *entry) {
+    Bucket *buckets = table->buckets.get();
+    const unsigned int freeLimit = std::min((home / SEGMENT_SIZE + 2) * SEGMENT_SIZE, table->size + H - 1);
+    unsigned int freeIndex = home;
+
+    while (freeIndex < freeLimit && buckets[freeIndex].entry.load(std::memory_order_relaxed) != nullptr) {
+        ++freeIndex;
+    }
+
+    if (freeIndex >= freeLimit) return false;
+
+    while (freeIndex - home >= H) {
+        unsigned int candidate = freeIndex - H + 1;
+
+        // Find the closest home bucket whose first entry sits before the free bucket
+        for (; candidate < freeIndex; ++candidate) {
+            const HopBitmap hopInfo = buckets[candidate].hopInfo.load(std::memory_order_relaxed);
+
+            if (hopInfo != 0 && candidate + lowestSetBit(hopInfo) < freeIndex) break;
+        }
+
+        if (candidate == freeIndex) return false;
+
+        Bucket &candidateBucket = buckets[candidate];
+        const HopBitmap hopInfo = candidateBucket.hopInfo.load(std::memory_order_relaxed);
+        const unsigned int offset = lowestSetBit(hopInfo);
+        Segment &segment = table->segments[candidate / SEGMENT_SIZE];
+
+        segment.version.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        buckets[freeIndex].entry.store(buckets[candidate + offset].entry.load(std::memory_order_relaxed),
+                                       std::memory_order_release);
+        // The new bit is set before the old one is cleared, so the entry can always be reached from its home bucket
+        candidateBucket.hopInfo.store(hopInfo | HopBitmap(1) << (freeIndex - candidate), std::memory_order_release);
+        candidateBucket.hopInfo.store((hopInfo | HopBitmap(1) << (freeIndex - candidate)) & ~(HopBitmap(1) << offset),
+                                      std::memory_order_release);
+        buckets[candidate + offset].entry.store(nullptr, std::memory_order_release);
+
+        segment.version.fetch_add(1, std::memory_order_release);
+
+        freeIndex = candidate + offset;
+    }
+
+    buckets[freeIndex].entry.store(entry, std::memory_order_release);
+    buckets[home].hopInfo.store(buckets[home].hopInfo.load(std::memory_order_relaxed) | HopBitmap(1) << (freeIndex - home),
+                                std::memory_order_release);
+
+    return true;
+}
+
+/**
+ * Replaces the given bucket array with one twice as large. Every segment of the old array stays locked until the new
+ * one is published, so no writer can change it in the meantime; readers keep using it until they notice the swap.
+ *
+ * @param table The bucket array that has to grow
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+void ConcurrentHashTable<KeyType, ValueType, H>::resize(Table *table) {
+    bool replaced = false;
+
+    for (unsigned int i = 0; i < table->segmentCount; ++i) {
+        table->segments[i].lock.lock();
+    }
+
+    // Another writer may have grown the table while this one waited for the locks
+    if (currentTable.load() == table) {
+        unsigned int newSize = table->size * 2;
+        Table *grown = new Table(newSize);
+
+        for (unsigned int i = 0; i < table->size + H - 1; ++i) {
+            Entry *entry = table->buckets[i].entry.load(std::memory_order_relaxed);
+
+            if (entry == nullptr) continue;
+
+            // If a neighbourhood of the new array overflows, start over with an even larger one
+            if (!place(grown, hashKey(entry->key, grown->size), entry)) {
+                delete grown;
+                newSize *= 2;
+                grown = new Table(newSize);
+                i = static_cast<unsigned int>(-1);
+            }
+        }
+
+        currentTable.store(grown);
+        replaced = true;
+    }
+
+    for (unsigned int i = table->segmentCount; i > 0; --i) {
+        table->segments[i - 1].lock.unlock();
+    }
+
+    if (replaced) retire(table);
+}
+
+/**
+ * Adds the given entry to the retire list, and reclaims the list once it grows past the threshold.
+ *
+ * @param entry The entry that has been removed from the table
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+void ConcurrentHashTable<KeyType, ValueType, H>::retire(Entry *entry) {
+    std::lock_guard<std::mutex> guard(retireLock);
+
+    retiredEntries.push_back(entry);
+
+    if (retiredEntries.size() >= RETIRE_THRESHOLD) reclaim();
+}
+
+/**
+ * Adds the given bucket array to the retire list and reclaims the list. Its entries are not retired, since they were
+ * moved to the new array.
+ *
+ * @param table The bucket array that has been replaced
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+void ConcurrentHashTable<KeyType, ValueType, H>::retire(Table *table) {
+    std::lock_guard<std::mutex> guard(retireLock);
+
+    retiredTables.push_back(table);
+    reclaim();
+}
+
+/**
+ * Deletes every retired entry and bucket array that is not protected by a hazard pointer. The retire lock must be held.
+ */
+template<typename KeyType, typename ValueType, unsigned int H>
+void ConcurrentHashTable<KeyType, ValueType, H>::reclaim() {
+    std::vector<Entry *> entryHazards;
+    std::vector<Table *> tableHazards;
+
+    for (HazardSlot &slot: hazardSlots) {
+        entryHazards.push_back(slot.entry.load());
+        tableHazards.push_back(slot.table.load());
+    }
+
+    std::sort(entryHazards.begin(), entryHazards.end());
+    std::sort(tableHazards.begin(), tableHazards.end());
+
+    auto protectedEntries = std::partition(retiredEntries.begin(), retiredEntries.end(), [&](Entry *entry) {
+        return std::binary_search(entryHazards.begin(), entryHazards.end(), entry);
+    });
+
+    for (auto it = protectedEntries; it != retiredEntries.end(); ++it) {
+        delete *it;
+    }
+
+    retiredEntries.erase(protectedEntries, retiredEntries.end());
+
+    auto protectedTables = std::partition(retiredTables.begin(), retiredTables.end(), [&](Table *table) {
+        return std::binary_search(tableHazards.begin(), tableHazards.end(), table);
+    });
+
+    for (auto it = protectedTables; it != retiredTables.end(); ++it) {
+        delete *it;
+    }
+
+    retiredTables.erase(protectedTables, retiredTables.end());
+}
@@ -0,0 +1,426 @@
+#include "../include/DenseHashTable.h"
+
+template<typename KeyType, typename ValueType, typename Hasher>
+constexpr unsigned int DenseHashTable<KeyType, ValueType, Hasher>::BATCH_SIZE;
+
+template<typename KeyType, typename ValueType, typename Hasher>
+constexpr unsigned int DenseHashTable<KeyType, ValueType, Hasher>::MIN_TABLE_SIZE;
+
+/**
+ * Constructor. The number of index slots is rounded up to a power of two; the index is only allocated by the first
+ * insertion.
+ *
+ * @param size The minimum number of index slots
+ * @param threshold The max load factor of the index
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+DenseHashTable<KeyType, ValueType, Hasher>::DenseHashTable(const unsigned int size, const double threshold)
+        : tableSize(MIN_TABLE_SIZE), loadFactorThreshold(threshold) {
+    while (tableSize < size) {
+        tableSize *= 2;
+    }
+}
+
+/**
+ * Returns the first entry of the hash table.
+ *
+ * @return The beginning of the hash table
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+typename DenseHashTable<KeyType, ValueType, Hasher>::Iterator DenseHashTable<KeyType, ValueType, Hasher>::begin() {
+    return Iterator(entries.data());
+}
+
+/**
+ * Returns the position past the last entry of the hash table.
+ *
+ * @return The end of the hash table
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+typename DenseHashTable<KeyType, ValueType, Hasher>::Iterator DenseHashTable<KeyType, ValueType, Hasher>::end() {
+    return Iterator(entries.data() + entries.size());
+}
+
+/**
+ * Returns the first entry of the hash table, for reading.
+ *
+ * @return The beginning of the hash table
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+typename DenseHashTable<KeyType, ValueType, Hasher>::ConstIterator
+DenseHashTable<KeyType, ValueType, Hasher>::begin() const {
+    return ConstIterator(entries.data());
+}
+
+/**
+ * Returns the position past the last entry of the hash table, for reading.
+ *
+ * @return The end of the hash table
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+typename DenseHashTable<KeyType, ValueType, Hasher>::ConstIterator
+DenseHashTable<KeyType, ValueType, Hasher>::end() const {
+    return ConstIterator(entries.data() + entries.size());
+}
+
+/**
+ * Returns the value of the key, inserting a default-constructed value first if the key does not exist yet.
+ *
+ * @param key The key to find or insert
+ * @return The value of the key
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+ValueType &DenseHashTable<KeyType, ValueType, Hasher>::operator[](KeyView key) {
+    return findOrPlace(key, []() { return ValueType(); }).first;
+}
+
+/**
+ * Inserts a value for the given key if the key does not exist yet. The new entry goes after all the others.
+ *
+ * @param key The key to insert the value for
+ * @param value The value to insert
+ * @return Whether the key was inserted; false means the key already exists and its value was left untouched
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+bool DenseHashTable<KeyType, ValueType, Hasher>::insert(KeyView key, const ValueType &value) {
+    return findOrPlace(key, [&value]() -> const ValueType & { return value; }).second;
+}
+
+/**
+ * Calls the given function on the value of the key, inserting a default-constructed value first if the key does not
+ * exist yet.
+ *
+ * @param key The key of the value to update
+ * @param function The function to call with a reference to the value
+ * @return Whether the key was inserted
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+template<typename Function>
+bool DenseHashTable<KeyType, ValueType, Hasher>::upsert(KeyView key, Function &&function) {
+    auto found = findOrPlace(key, []() { return ValueType(); });
+    function(found.first);
+    return found.second;
+}
+
+/**
+ * Searches for the value of the given key.
+ *
+ * @param key The key to search for
+ * @return A pointer to the value of the key, or nullptr if the key does not exist
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+ValueType *DenseHashTable<KeyType, ValueType, Hasher>::search(KeyView key) {
+    const int slot = findSlot(key, Hasher{}(key));
+
+    return slot >= 0 ? &entries[index[slot].entry - 1].value : nullptr;
+}
+
+/**
+ * Searches for the value of the given key, for reading.
+ *
+ * @param key The key to search for
+ * @return A pointer to the value of the key, or nullptr if the key does not exist
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+const ValueType *DenseHashTable<KeyType, ValueType, Hasher>::search(KeyView key) const {
+    const int slot = findSlot(key, Hasher{}(key));
+
+    return slot >= 0 ? &entries[index[slot].entry - 1].value : nullptr;
+}
+
+/**
+ * Looks up every key of the given range, e.g. a std::vector or an UnorderedSet of keys, and stores a pointer to each
+ * key's value (or nullptr) in results, in the order of the keys. The index slots of the next keys are prefetched while
+ * the current key is compared, so that the cache misses of a batch overlap.
+ *
+ * @param keys The keys to search for
+ * @param results Cleared, then filled with one pointer per key
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+template<typename LookupKeys>
+void DenseHashTable<KeyType, ValueType, Hasher>::searchBatch(const LookupKeys &keys, std::vector<ValueType *> &results) {
+    // The hashes of the keys between the probed key and the prefetched one
+    size_t hashes[BATCH_SIZE];
+    auto ahead = std::begin(keys);
+    const auto last = std::end(keys);
+
+    results.clear();
+
+    if (index.empty()) {
+        for (; ahead != last; ++ahead) {
+            results.push_back(nullptr);
+        }
+        return;
+    }
+
+    auto prefetchAhead = [&](const unsigned int slot) {
+        hashes[slot] = Hasher{}(KeyView(*ahead));
+        prefetchForRead(&index[hashes[slot] & mask()]);
+        ++ahead;
+    };
+
+    unsigned int pending = 0;
+
+    for (; ahead != last && pending < BATCH_SIZE; ++pending) {
+        prefetchAhead(pending);
+    }
+
+    for (auto it = std::begin(keys); pending > 0; ++it) {
+        const unsigned int slot = static_cast<unsigned int>(results.size() % BATCH_SIZE);
+        const int found = findSlot(KeyView(*it), hashes[slot]);
+
+        results.push_back(found >= 0 ? &entries[index[found].entry - 1].value : nullptr);
+
+        // The slot of the key just probed is free for the next key to prefetch
+        if (ahead != last) {
+            prefetchAhead(slot);
+        } else {
+            pending -= 1;
+        }
+    }
+}
+
+/**
+ * Removes the key from the hash table if it exists. The last entry is moved into the removed entry's place.
+ *
+ * @param key The key to remove
+ * @return Whether the removal was successful
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+bool DenseHashTable<KeyType, ValueType, Hasher>::remove(KeyView key) {
+    const int slot = findSlot(key, Hasher{}(key));
+
+    if (slot < 0) return false;
+
+    const std::uint32_t position = index[slot].entry - 1;
+    const std::uint32_t lastPosition = static_cast<std::uint32_t>(entries.size() - 1);
+
+    vacate(slot);
+
+    if (position != lastPosition) {
+        // Repoint the last entry's slot at the hole before moving the entry into it
+        unsigned int lastSlot = Hasher{}(KeyView(entries[lastPosition].key)) & mask();
+
+        while (index[lastSlot].entry != lastPosition + 1) {
+            lastSlot = (lastSlot + 1) & mask();
+        }
+
+        index[lastSlot].entry = position + 1;
+        entries[position] = std::move(entries[lastPosition]);
+    }
+
+    entries.pop_back();
+
+    return true;
+}
+
+/**
+ * Clears the hash table, keeping its size.
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+void DenseHashTable<KeyType, ValueType, Hasher>::clear() {
+    entries.clear();
+
+    if (!index.empty()) index.assign(tableSize, IndexSlot{0, 0});
+}
+
+/**
+ * Makes room for the given number of entries, so that inserting them neither grows the entries nor rehashes the index.
+ *
+ * @param count The number of entries to make room for
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+void DenseHashTable<KeyType, ValueType, Hasher>::reserve(const unsigned int count) {
+    entries.reserve(count);
+
+    unsigned int newTableSize = tableSize;
+
+    while (count > newTableSize * loadFactorThreshold) {
+        newTableSize *= 2;
+    }
+
+    if (newTableSize != tableSize && !index.empty()) {
+        rehash(newTableSize);
+    } else {
+        tableSize = newTableSize;
+    }
+}
+
+/**
+ * Returns the number of entries in the hash table.
+ *
+ * @return The number of entries in the hash table
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+unsigned int DenseHashTable<KeyType, ValueType, Hasher>::size() const {
+    return static_cast<unsigned int>(entries.size());
+}
+
+/**
+ * Returns the load factor of the index.
+ *
+ * @return The number of entries divided by the number of index slots
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+double DenseHashTable<KeyType, ValueType, Hasher>::loadFactor() const {
+    return static_cast<double>(entries.size()) / tableSize;
+}
+
+/**
+ * Collects the index's probe length histogram and the table's rehash counters and memory footprint.
+ *
+ * @return The hash table's statistics
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+HashTableStats DenseHashTable<KeyType, ValueType, Hasher>::stats() const {
+    HashTableStats tableStats;
+
+    // The index is still empty before the first insertion, and after the table was moved from
+    for (unsigned int slot = 0; slot < index.size(); ++slot) {
+        if (index[slot].entry == 0) continue;
+
+        const unsigned int probeLength = (slot - index[slot].hash) & mask();
+
+        if (probeLength >= tableStats.probeLengthHistogram.size()) {
+            tableStats.probeLengthHistogram.resize(probeLength + 1, 0);
+        }
+
+        tableStats.probeLengthHistogram[probeLength] += 1;
+    }
+
+    tableStats.rehashCount = rehashCount;
+    tableStats.rehashTime = rehashTime;
+    tableStats.bytesUsed = sizeof(*this) + index.capacity() * sizeof(IndexSlot) + entries.capacity() * sizeof(Entry);
+    tableStats.size = size();
+    tableStats.tableSize = tableSize;
+    tableStats.loadFactor = loadFactor();
+
+    return tableStats;
+}
+
+/**
+ * Returns the mask that maps a hash to an index slot.
+ *
+ * @return The number of index slots minus one
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+unsigned int DenseHashTable<KeyType, ValueType, Hasher>::mask() const {
+    return tableSize - 1;
+}
+
+/**
+ * Finds the index slot of the given key. Keys are only compared when the low 32 bits of the hashes match.
+ *
+ * @param key The key to find
+ * @param hash The hash of the key
+ * @return The index slot of the key, or -1 if the key does not exist
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+int DenseHashTable<KeyType, ValueType, Hasher>::findSlot(KeyView key, const size_t hash) const {
+    if (index.empty()) return -1;
+
+    const auto shortHash = static_cast<std::uint32_t>(hash);
+    unsigned int slot = shortHash & mask();
+
+    while (index[slot].entry != 0) {
+        if (index[slot].hash == shortHash && entries[index[slot].entry - 1].key == key) {
+            return static_cast<int>(slot);
+        }
+
+        slot = (slot + 1) & mask();
+    }
+
+    return -1;
+}
+
+/**
+ * Points the first empty index slot from the hash's home onwards at the given entry.
+ *
+ * @param hash The low 32 bits of the entry's hash
+ * @param entry The position of the entry plus one
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+void DenseHashTable<KeyType, ValueType, Hasher>::claim(const std::uint32_t hash, const std::uint32_t entry) {
+    unsigned int slot = hash & mask();
+
+    while (index[slot].entry != 0) {
+        slot = (slot + 1) & mask();
+    }
+
+    index[slot] = IndexSlot{entry, hash};
+}
+
+/**
+ * Empties the given index slot, then shifts the slots that follow it back towards their homes, so that every key stays
+ * reachable from its home without tombstones.
+ *
+ * @param slot The index slot to empty
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+void DenseHashTable<KeyType, ValueType, Hasher>::vacate(unsigned int slot) {
+    unsigned int next = (slot + 1) & mask();
+
+    while (index[next].entry != 0) {
+        const unsigned int home = index[next].hash & mask();
+
+        // The slot can move back into the hole unless its home lies after the hole
+        if (((next - home) & mask()) >= ((next - slot) & mask())) {
+            index[slot] = index[next];
+            slot = next;
+        }
+
+        next = (next + 1) & mask();
+    }
+
+    index[slot] = IndexSlot{0, 0};
+}
+
+/**
+ * Returns the value of the key, appending an entry with the value made by makeValue first if the key does not exist yet.
+ *
+ * @param key The key to find or insert
+ * @param makeValue Returns the value to insert; only called when the key is inserted
+ * @return The value of the key, and whether the key was inserted
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+template<typename MakeValue>
+std::pair<ValueType &, bool> DenseHashTable<KeyType, ValueType, Hasher>::findOrPlace(KeyView key,
+                                                                                    MakeValue &&makeValue) {
+    const size_t hash = Hasher{}(key);
+    const int slot = findSlot(key, hash);
+
+    if (slot >= 0) return {entries[index[slot].entry - 1].value, false};
+
+    if (entries.size() + 1 > tableSize * loadFactorThreshold) {
+        rehash(tableSize * 2);
+    } else if (index.empty()) {
+        index.assign(tableSize, IndexSlot{0, 0});
+    }
+
+    entries.push_back(Entry{KeyType(key), makeValue()});
+    claim(static_cast<std::uint32_t>(hash), static_cast<std::uint32_t>(entries.size()));
+
+    return {entries.back().value, true};
+}
+
+/**
+ * Rebuilds the index with the given number of slots. The entries stay where they are, and the index slots carry enough
+ * of each hash to be placed again without rehashing any key.
+ *
+ * @param newTableSize The new number of index slots, a power of two
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+void DenseHashTable<KeyType, ValueType, Hasher>::rehash(const unsigned int newTableSize) {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<IndexSlot> oldIndex(newTableSize, IndexSlot{0, 0});
+
+    oldIndex.swap(index);
+    tableSize = newTableSize;
+
+    for (const IndexSlot &slot: oldIndex) {
+        if (slot.entry != 0) claim(slot.hash, slot.entry);
+    }
+
+    rehashCount += 1;
+    rehashTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+}
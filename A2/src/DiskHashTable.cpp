@@ -0,0 +1,686 @@
+#include "../include/DiskHashTable.h"
+
+template<typename ValueType>
+constexpr std::uint32_t DiskHashTable<ValueType>::VERSION;
+
+template<typename ValueType>
+constexpr char DiskHashTable<ValueType>::MAGIC[8];
+
+template<typename ValueType>
+constexpr std::uint32_t DiskHashTable<ValueType>::MAX_DEPTH;
+
+/**
+ * Appends the given string to the bytes of a value, prefixed with its length.
+ *
+ * @param bytes The bytes to append to
+ * @param string The string to append
+ */
+inline void appendDiskString(std::string &bytes, const std::string_view string) {
+    const auto length = static_cast<std::uint32_t>(string.size());
+
+    bytes.append(reinterpret_cast<const char *>(&length), sizeof(length));
+    bytes.append(string);
+}
+
+/**
+ * Reads a string written by appendDiskString and moves the cursor past it.
+ *
+ * @param cursor The first byte of the string's length
+ * @return The string
+ */
+inline std::string readDiskString(const char *&cursor) {
+    std::uint32_t length;
+
+    std::memcpy(&length, cursor, sizeof(length));
+    cursor += sizeof(length);
+
+    std::string string(cursor, length);
+
+    cursor += length;
+
+    return string;
+}
+
+template<typename ValueType>
+void DiskValueCodec<ValueType>::encode(const ValueType &value, std::string &bytes) {
+    bytes.append(reinterpret_cast<const char *>(&value), sizeof(ValueType));
+}
+
+template<typename ValueType>
+ValueType DiskValueCodec<ValueType>::decode(const char *bytes, size_t) {
+    ValueType value;
+
+    std::memcpy(&value, bytes, sizeof(ValueType));
+
+    return value;
+}
+
+inline void DiskValueCodec<std::string>::encode(const std::string &value, std::string &bytes) {
+    bytes.append(value);
+}
+
+inline std::string DiskValueCodec<std::string>::decode(const char *bytes, const size_t length) {
+    return {bytes, length};
+}
+
+inline void DiskValueCodec<Book>::encode(const Book &value, std::string &bytes) {
+    const auto copies = static_cast<std::int32_t>(value.copies);
+
+    appendDiskString(bytes, value.ISBN);
+    appendDiskString(bytes, value.title);
+    appendDiskString(bytes, value.author);
+    appendDiskString(bytes, value.publisher);
+    appendDiskString(bytes, value.yearPublished);
+    bytes.append(reinterpret_cast<const char *>(&copies), sizeof(copies));
+}
+
+inline Book DiskValueCodec<Book>::decode(const char *bytes, size_t) {
+    Book book;
+    std::int32_t copies;
+
+    book.ISBN = readDiskString(bytes);
+    book.title = readDiskString(bytes);
+    book.author = readDiskString(bytes);
+    book.publisher = readDiskString(bytes);
+    book.yearPublished = readDiskString(bytes);
+    std::memcpy(&copies, bytes, sizeof(copies));
+    book.copies = copies;
+
+    return book;
+}
+
+/**
+ * Constructor. Opens the table stored in the given file, or starts a new one with a single empty bucket if the file is
+ * empty or does not exist. An existing table keeps the page size it was created with.
+ *
+ * @param path The file holding the table
+ * @param cachePages The maximum number of pages kept in memory
+ * @param pageSize The size of a page in bytes, for a new table
+ * @throws std::invalid_argument If the cache or the pages are too small
+ * @throws std::runtime_error If the file cannot be opened or is not a valid table
+ */
+template<typename ValueType>
+DiskHashTable<ValueType>::DiskHashTable(const std::string &path, const unsigned int cachePages,
+                                        const unsigned int pageSize)
+        : path(path), pageSize(pageSize), cachePages(cachePages), pageFrames(2 * cachePages) {
+    if (cachePages == 0) throw std::invalid_argument("A disk hash table needs at least one cached page");
+    if (pageSize < 2 * sizeof(Header)) throw std::invalid_argument("Disk hash table pages are too small");
+
+    descriptor = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+
+    if (descriptor < 0) throw std::runtime_error("Failed to open disk hash table " + path);
+
+    // Whatever goes wrong while the header and the directory are read, the file must not stay open
+    try {
+        struct stat fileStatus{};
+
+        if (::fstat(descriptor, &fileStatus) != 0) throw std::runtime_error("Failed to read disk hash table " + path);
+
+        const auto fileSize = static_cast<std::uint64_t>(fileStatus.st_size);
+
+        if (fileSize == 0) {
+            // Page 0 is the header, written by flush()
+            pageCount = 1;
+            directory.push_back(newPage(0));
+            return;
+        }
+
+        Header header{};
+
+        if (fileSize >= sizeof(Header)) readAt(reinterpret_cast<char *>(&header), sizeof(Header), 0);
+
+        const std::uint64_t directoryBytes = (std::uint64_t{1} << std::min(header.globalDepth, MAX_DEPTH)) *
+                                             sizeof(std::uint32_t);
+        const bool valid = fileSize >= sizeof(Header) &&
+                           std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                           header.version == VERSION &&
+                           header.pageSize >= 2 * sizeof(Header) &&
+                           header.pageCount > 1 &&
+                           header.globalDepth < MAX_DEPTH &&
+                           header.directoryOffset == static_cast<std::uint64_t>(header.pageCount) * header.pageSize &&
+                           header.directoryOffset + directoryBytes <= fileSize;
+
+        if (!valid) {
+            throw std::runtime_error("Not a version " + std::to_string(VERSION) + " disk hash table: " + path);
+        }
+
+        this->pageSize = header.pageSize;
+        pageCount = header.pageCount;
+        globalDepth = header.globalDepth;
+        elementCount = header.size;
+        directory.resize(std::size_t{1} << globalDepth);
+        readAt(reinterpret_cast<char *>(directory.data()), directoryBytes, header.directoryOffset);
+    } catch (...) {
+        ::close(descriptor);
+        throw;
+    }
+}
+
+/**
+ * Destructor. Flushes the table and closes its file.
+ */
+template<typename ValueType>
+DiskHashTable<ValueType>::~DiskHashTable() {
+    try {
+        flush();
+    } catch (const std::runtime_error &) {
+        // A destructor cannot report the failure; call flush() first to see it
+    }
+
+    ::close(descriptor);
+}
+
+/**
+ * Inserts a value for the given key if the key does not exist yet, splitting the key's bucket as often as needed to make
+ * room for it.
+ *
+ * @param key The key to insert the value for
+ * @param value The value to insert
+ * @return Whether the key was inserted; false means the key already exists and its value was left untouched
+ * @throws std::length_error If the key and the value do not fit in a page
+ */
+template<typename ValueType>
+bool DiskHashTable<ValueType>::insert(const std::string_view key, const ValueType &value) {
+    const std::uint32_t hash = hashKey(key);
+
+    return place(key, hash, makeRecord(key, value, hash));
+}
+
+/**
+ * Inserts a value for the given key, or replaces the value if the key already exists.
+ *
+ * @param key The key to insert the value for
+ * @param value The value to insert
+ * @return Whether the key was inserted; false means an existing value was replaced
+ * @throws std::length_error If the key and the value do not fit in a page; the table is then left unchanged
+ */
+template<typename ValueType>
+bool DiskHashTable<ValueType>::insert_or_assign(const std::string_view key, const ValueType &value) {
+    const std::uint32_t hash = hashKey(key);
+    const std::string record = makeRecord(key, value, hash);
+    const bool replaced = remove(key);
+
+    place(key, hash, record);
+
+    return !replaced;
+}
+
+/**
+ * Searches for the value of the given key, reading its bucket from the file if it is not cached.
+ *
+ * @param key The key to search for
+ * @return A copy of the value of the key, or std::nullopt if the key does not exist
+ */
+template<typename ValueType>
+std::optional<ValueType> DiskHashTable<ValueType>::search(const std::string_view key) {
+    const std::uint32_t hash = hashKey(key);
+    const char *bucket = page(bucketOf(hash)).bytes.data();
+    const long offset = findRecord(bucket, key, hash);
+
+    if (offset < 0) return std::nullopt;
+
+    RecordHeader record;
+
+    std::memcpy(&record, bucket + offset, sizeof(RecordHeader));
+
+    return Codec::decode(bucket + offset + sizeof(RecordHeader) + record.keyLength, record.valueLength);
+}
+
+/**
+ * Returns whether the key exists in the table.
+ *
+ * @param key The key to search for
+ * @return Whether the key exists
+ */
+template<typename ValueType>
+bool DiskHashTable<ValueType>::contains(const std::string_view key) {
+    const std::uint32_t hash = hashKey(key);
+
+    return findRecord(page(bucketOf(hash)).bytes.data(), key, hash) >= 0;
+}
+
+/**
+ * Removes the key from the table if it exists. The records after it in its bucket move up to close the gap.
+ *
+ * @param key The key to remove
+ * @return Whether the removal was successful
+ */
+template<typename ValueType>
+bool DiskHashTable<ValueType>::remove(const std::string_view key) {
+    const std::uint32_t hash = hashKey(key);
+    Frame &frame = page(bucketOf(hash));
+    char *bucket = frame.bytes.data();
+    const long offset = findRecord(bucket, key, hash);
+
+    if (offset < 0) return false;
+
+    PageHeader header;
+    RecordHeader record;
+
+    std::memcpy(&header, bucket, sizeof(PageHeader));
+    std::memcpy(&record, bucket + offset, sizeof(RecordHeader));
+
+    const size_t length = sizeof(RecordHeader) + record.keyLength + record.valueLength;
+
+    std::memmove(bucket + offset, bucket + offset + length, header.usedBytes - offset - length);
+    header.usedBytes -= static_cast<std::uint32_t>(length);
+    header.recordCount -= 1;
+    // Freed bytes are zeroed, so that a page's bytes only depend on its records
+    std::memset(bucket + header.usedBytes, 0, length);
+    std::memcpy(bucket, &header, sizeof(PageHeader));
+    frame.dirty = true;
+    elementCount -= 1;
+
+    return true;
+}
+
+/**
+ * Writes every changed page, the directory and the header to the file. The data reaches the operating system, which
+ * writes it to the disk in its own time.
+ *
+ * @throws std::runtime_error If the file cannot be written
+ */
+template<typename ValueType>
+void DiskHashTable<ValueType>::flush() {
+    for (Frame &frame: frames) {
+        if (frame.dirty) writeFrame(frame);
+    }
+
+    Header header;
+
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.pageSize = pageSize;
+    header.pageCount = pageCount;
+    header.globalDepth = globalDepth;
+    header.size = elementCount;
+    header.directoryOffset = static_cast<std::uint64_t>(pageCount) * pageSize;
+
+    const size_t directoryBytes = directory.size() * sizeof(std::uint32_t);
+
+    writeAt(reinterpret_cast<const char *>(directory.data()), directoryBytes, header.directoryOffset);
+    writeAt(reinterpret_cast<const char *>(&header), sizeof(Header), 0);
+
+    // Drops a longer directory left behind by an earlier flush
+    if (::ftruncate(descriptor, static_cast<off_t>(header.directoryOffset + directoryBytes)) != 0) {
+        throw std::runtime_error("Failed to truncate disk hash table " + path);
+    }
+}
+
+/**
+ * Returns the number of items in the table.
+ *
+ * @return The number of items in the table
+ */
+template<typename ValueType>
+unsigned int DiskHashTable<ValueType>::size() const {
+    return elementCount;
+}
+
+/**
+ * Collects the table's page cache counters, its shape and the memory it uses.
+ *
+ * @return The table's statistics
+ */
+template<typename ValueType>
+DiskHashTableStats DiskHashTable<ValueType>::stats() const {
+    DiskHashTableStats tableStats;
+
+    tableStats.pageReads = pageReads;
+    tableStats.pageWrites = pageWrites;
+    tableStats.cacheHits = cacheHits;
+    tableStats.splitCount = splitCount;
+    tableStats.directoryDoublings = directoryDoublings;
+    tableStats.globalDepth = globalDepth;
+    tableStats.pageCount = pageCount;
+    tableStats.size = elementCount;
+    tableStats.bytesUsed = sizeof(*this) + frames.capacity() * sizeof(Frame) + frames.size() * pageSize +
+                           directory.capacity() * sizeof(std::uint32_t);
+
+    return tableStats;
+}
+
+/**
+ * Hashes the key with 64-bit FNV-1a and folds the result to 32 bits. Unlike std::hash, the result does not depend on
+ * the standard library, so a table can be opened by a build other than the one that wrote it.
+ *
+ * @param key The key to hash
+ * @return The hash of the key
+ */
+template<typename ValueType>
+std::uint32_t DiskHashTable<ValueType>::hashKey(const std::string_view key) {
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    for (const char character: key) {
+        hash = (hash ^ static_cast<unsigned char>(character)) * 1099511628211ULL;
+    }
+
+    return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+}
+
+/**
+ * Returns the frame holding the given page, reading the page from the file if it is not cached. The frame stays valid
+ * until the next page is requested.
+ *
+ * @param pageNumber The page to return
+ * @return The frame holding the page
+ */
+template<typename ValueType>
+typename DiskHashTable<ValueType>::Frame &DiskHashTable<ValueType>::page(const std::uint32_t pageNumber) {
+    const unsigned int *cached = pageFrames.search(pageNumber);
+
+    if (cached != nullptr) {
+        cacheHits += 1;
+        frames[*cached].referenced = true;
+        return frames[*cached];
+    }
+
+    return frameFor(pageNumber, true);
+}
+
+/**
+ * Appends an empty bucket page to the table. The page is only cached; it reaches the file when it is evicted or flushed.
+ *
+ * @param localDepth The local depth of the new bucket
+ * @return The number of the new page
+ */
+template<typename ValueType>
+std::uint32_t DiskHashTable<ValueType>::newPage(const std::uint32_t localDepth) {
+    const std::uint32_t pageNumber = pageCount++;
+    Frame &frame = frameFor(pageNumber, false);
+    const PageHeader header{localDepth, 0, sizeof(PageHeader), 0};
+
+    std::fill(frame.bytes.begin(), frame.bytes.end(), 0);
+    std::memcpy(frame.bytes.data(), &header, sizeof(PageHeader));
+    frame.dirty = true;
+
+    return pageNumber;
+}
+
+/**
+ * Gives the given page a frame: a free one while the cache is not full, or else the first frame the clock hand finds
+ * unreferenced, clearing the reference bits it passes. The evicted page is written back first if it was changed.
+ *
+ * @param pageNumber The page to give a frame
+ * @param read Whether to read the page from the file into the frame
+ * @return The frame of the page
+ */
+template<typename ValueType>
+typename DiskHashTable<ValueType>::Frame &DiskHashTable<ValueType>::frameFor(const std::uint32_t pageNumber,
+                                                                             const bool read) {
+    unsigned int index = 0;
+
+    if (frames.size() < cachePages) {
+        index = static_cast<unsigned int>(frames.size());
+        frames.push_back(Frame{pageNumber, false, true, std::vector<char>(pageSize, 0)});
+    } else {
+        while (frames[clockHand].referenced) {
+            frames[clockHand].referenced = false;
+            clockHand = (clockHand + 1) % cachePages;
+        }
+
+        index = clockHand;
+        clockHand = (clockHand + 1) % cachePages;
+
+        if (frames[index].dirty) writeFrame(frames[index]);
+
+        pageFrames.remove(frames[index].page);
+        frames[index].page = pageNumber;
+    }
+
+    Frame &frame = frames[index];
+
+    if (read) {
+        readAt(frame.bytes.data(), pageSize, static_cast<std::uint64_t>(pageNumber) * pageSize);
+        pageReads += 1;
+    }
+
+    frame.referenced = true;
+    pageFrames.insert(pageNumber, index);
+
+    return frame;
+}
+
+/**
+ * Writes the given frame's page to the file.
+ *
+ * @param frame The frame to write back
+ */
+template<typename ValueType>
+void DiskHashTable<ValueType>::writeFrame(Frame &frame) {
+    writeAt(frame.bytes.data(), pageSize, static_cast<std::uint64_t>(frame.page) * pageSize);
+    frame.dirty = false;
+    pageWrites += 1;
+}
+
+/**
+ * Reads exactly the given number of bytes at the given offset of the file.
+ *
+ * @param bytes The buffer to read into
+ * @param length The number of bytes to read
+ * @param offset The offset in the file to read from
+ * @throws std::runtime_error If the file ends early or cannot be read
+ */
+template<typename ValueType>
+void DiskHashTable<ValueType>::readAt(char *bytes, size_t length, std::uint64_t offset) {
+    while (length > 0) {
+        const ssize_t count = ::pread(descriptor, bytes, length, static_cast<off_t>(offset));
+
+        if (count <= 0) throw std::runtime_error("Failed to read disk hash table " + path);
+
+        bytes += count;
+        length -= static_cast<size_t>(count);
+        offset += static_cast<std::uint64_t>(count);
+    }
+}
+
+/**
+ * Writes exactly the given number of bytes at the given offset of the file.
+ *
+ * @param bytes The bytes to write
+ * @param length The number of bytes to write
+ * @param offset The offset in the file to write at
+ * @throws std::runtime_error If the file cannot be written
+ */
+template<typename ValueType>
+void DiskHashTable<ValueType>::writeAt(const char *bytes, size_t length, std::uint64_t offset) {
+    while (length > 0) {
+        const ssize_t count = ::pwrite(descriptor, bytes, length, static_cast<off_t>(offset));
+
+        if (count <= 0) throw std::runtime_error("Failed to write disk hash table " + path);
+
+        bytes += count;
+        length -= static_cast<size_t>(count);
+        offset += static_cast<std::uint64_t>(count);
+    }
+}
+
+/**
+ * Returns the bucket that the directory maps the given hash to, by its low globalDepth bits.
+ *
+ * @param hash The hash of a key
+ * @return The page number of the key's bucket
+ */
+template<typename ValueType>
+std::uint32_t DiskHashTable<ValueType>::bucketOf(const std::uint32_t hash) const {
+    return directory[hash & (directory.size() - 1)];
+}
+
+/**
+ * Finds the record of the given key in a bucket. Keys are only compared when the hashes match.
+ *
+ * @param bucket The bytes of the bucket page
+ * @param key The key to find
+ * @param hash The hash of the key
+ * @return The offset of the key's record in the page, or -1 if the key is not in the bucket
+ */
+template<typename ValueType>
+long DiskHashTable<ValueType>::findRecord(const char *bucket, const std::string_view key,
+                                          const std::uint32_t hash) const {
+    PageHeader header;
+
+    std::memcpy(&header, bucket, sizeof(PageHeader));
+
+    size_t offset = sizeof(PageHeader);
+
+    for (std::uint32_t i = 0; i < header.recordCount; ++i) {
+        RecordHeader record;
+
+        std::memcpy(&record, bucket + offset, sizeof(RecordHeader));
+
+        if (record.hash == hash &&
+            std::string_view(bucket + offset + sizeof(RecordHeader), record.keyLength) == key) {
+            return static_cast<long>(offset);
+        }
+
+        offset += sizeof(RecordHeader) + record.keyLength + record.valueLength;
+    }
+
+    return -1;
+}
+
+/**
+ * Appends a record to a bucket that has room for it.
+ *
+ * @param bucket The bytes of the bucket page
+ * @param record The bytes of the record
+ * @param length The length of the record
+ */
+template<typename ValueType>
+void DiskHashTable<ValueType>::appendRecord(char *bucket, const char *record, const size_t length) {
+    PageHeader header;
+
+    std::memcpy(&header, bucket, sizeof(PageHeader));
+    std::memcpy(bucket + header.usedBytes, record, length);
+    header.usedBytes += static_cast<std::uint32_t>(length);
+    header.recordCount += 1;
+    std::memcpy(bucket, &header, sizeof(PageHeader));
+}
+
+/**
+ * Encodes the key and the value into a record.
+ *
+ * @param key The key of the record
+ * @param value The value of the record
+ * @param hash The hash of the key
+ * @return The bytes of the record
+ * @throws std::length_error If the record does not fit in an empty page
+ */
+template<typename ValueType>
+std::string DiskHashTable<ValueType>::makeRecord(const std::string_view key, const ValueType &value,
+                                                 const std::uint32_t hash) const {
+    std::string record(sizeof(RecordHeader), '\0');
+
+    record.append(key);
+    Codec::encode(value, record);
+
+    if (sizeof(PageHeader) + record.size() > pageSize) {
+        throw std::length_error("Disk hash table record does not fit in a page");
+    }
+
+    const RecordHeader header{hash, static_cast<std::uint32_t>(key.size()),
+                              static_cast<std::uint32_t>(record.size() - sizeof(RecordHeader) - key.size())};
+
+    std::memcpy(&record[0], &header, sizeof(RecordHeader));
+
+    return record;
+}
+
+/**
+ * Appends the record of the given key to the key's bucket if the key is not in the table yet, splitting the bucket
+ * until the record fits.
+ *
+ * @param key The key of the record
+ * @param hash The hash of the key
+ * @param record The bytes of the record
+ * @return Whether the record was inserted
+ */
+template<typename ValueType>
+bool DiskHashTable<ValueType>::place(const std::string_view key, const std::uint32_t hash, const std::string &record) {
+    while (true) {
+        const std::uint32_t pageNumber = bucketOf(hash);
+        Frame &frame = page(pageNumber);
+        PageHeader header;
+
+        std::memcpy(&header, frame.bytes.data(), sizeof(PageHeader));
+
+        if (findRecord(frame.bytes.data(), key, hash) >= 0) return false;
+
+        if (header.usedBytes + record.size() <= pageSize) {
+            appendRecord(frame.bytes.data(), record.data(), record.size());
+            frame.dirty = true;
+            elementCount += 1;
+            return true;
+        }
+
+        split(pageNumber);
+    }
+}
+
+/**
+ * Splits a full bucket in two by the next bit of its records' hashes. A bucket that the directory maps a single entry
+ * to doubles the directory first; either way, only the entries that pointed to the full bucket are updated, and only
+ * its records are moved.
+ *
+ * @param pageNumber The page of the full bucket
+ * @throws std::length_error If the bucket holds keys that share all 32 bits of their hash
+ */
+template<typename ValueType>
+void DiskHashTable<ValueType>::split(const std::uint32_t pageNumber) {
+    const std::vector<char> full = page(pageNumber).bytes;
+    PageHeader header;
+
+    std::memcpy(&header, full.data(), sizeof(PageHeader));
+
+    if (header.localDepth + 1 >= MAX_DEPTH) {
+        throw std::length_error("Too many disk hash table keys share a hash to split their bucket");
+    }
+
+    if (header.localDepth == globalDepth) {
+        const size_t entries = directory.size();
+
+        directory.resize(2 * entries);
+        std::copy(directory.begin(), directory.begin() + static_cast<long>(entries),
+                  directory.begin() + static_cast<long>(entries));
+        globalDepth += 1;
+        directoryDoublings += 1;
+    }
+
+    const std::uint32_t bit = std::uint32_t{1} << header.localDepth;
+    const PageHeader halfHeader{header.localDepth + 1, 0, sizeof(PageHeader), 0};
+    std::vector<char> halves[2] = {std::vector<char>(pageSize, 0), std::vector<char>(pageSize, 0)};
+
+    for (std::vector<char> &half: halves) {
+        std::memcpy(half.data(), &halfHeader, sizeof(PageHeader));
+    }
+
+    size_t offset = sizeof(PageHeader);
+
+    for (std::uint32_t i = 0; i < header.recordCount; ++i) {
+        RecordHeader record;
+
+        std::memcpy(&record, full.data() + offset, sizeof(RecordHeader));
+
+        const size_t length = sizeof(RecordHeader) + record.keyLength + record.valueLength;
+
+        appendRecord(halves[(record.hash & bit) != 0].data(), full.data() + offset, length);
+        offset += length;
+    }
+
+    const std::uint32_t sibling = newPage(header.localDepth + 1);
+    Frame &siblingFrame = page(sibling);
+
+    siblingFrame.bytes.swap(halves[1]);
+
+    Frame &frame = page(pageNumber);
+
+    frame.bytes.swap(halves[0]);
+    frame.dirty = true;
+
+    for (size_t entry = 0; entry < directory.size(); ++entry) {
+        if (directory[entry] == pageNumber && (entry & bit) != 0) directory[entry] = sibling;
+    }
+
+    splitCount += 1;
+}
@@ -0,0 +1,304 @@
+#include "../include/FrozenHashTable.h"
+
+template<typename ValueType>
+constexpr std::uint32_t FrozenHashTable<ValueType>::VERSION;
+
+template<typename ValueType>
+constexpr char FrozenHashTable<ValueType>::MAGIC[8];
+
+template<typename ValueType>
+constexpr std::uint32_t FrozenValueCodec<ValueType>::TYPE_KIND;
+
+template<typename ValueType>
+constexpr std::uint32_t FrozenValueCodec<ValueType>::TYPE_TAG;
+
+/**
+ * Appends the given string to the heap.
+ *
+ * @param string The string to append
+ * @return The reference to the string inside the heap
+ */
+inline FrozenStringRef FrozenStringHeap::add(const std::string_view string) {
+    const FrozenStringRef ref{static_cast<std::uint32_t>(heap.size()), static_cast<std::uint32_t>(string.size())};
+
+    if (heap.size() + string.size() > UINT32_MAX) throw std::length_error("Frozen string heap is full");
+
+    heap.append(string);
+
+    return ref;
+}
+
+/**
+ * Returns the bytes of every string appended so far.
+ *
+ * @return The bytes of the heap
+ */
+inline const std::string &FrozenStringHeap::bytes() const {
+    return heap;
+}
+
+/**
+ * Returns the string of the given reference.
+ *
+ * @param ref The reference to the string
+ * @param heap The first byte of the heap
+ * @return A view of the string
+ */
+inline std::string_view frozenString(const FrozenStringRef &ref, const char *heap) {
+    return {heap + ref.offset, ref.length};
+}
+
+template<typename ValueType>
+typename FrozenValueCodec<ValueType>::stored_type FrozenValueCodec<ValueType>::encode(const ValueType &value,
+                                                                                    FrozenStringHeap &) {
+    return value;
+}
+
+template<typename ValueType>
+typename FrozenValueCodec<ValueType>::view_type FrozenValueCodec<ValueType>::decode(const stored_type &stored,
+                                                                                   const char *) {
+    return stored;
+}
+
+inline FrozenStringRef FrozenValueCodec<std::string>::encode(const std::string &value, FrozenStringHeap &heap) {
+    return heap.add(value);
+}
+
+inline std::string_view FrozenValueCodec<std::string>::decode(const FrozenStringRef &stored, const char *heap) {
+    return frozenString(stored, heap);
+}
+
+inline FrozenValueCodec<Book>::stored_type FrozenValueCodec<Book>::encode(const Book &value, FrozenStringHeap &heap) {
+    return {heap.add(value.ISBN), heap.add(value.title), heap.add(value.author), heap.add(value.publisher),
+            heap.add(value.yearPublished), value.copies};
+}
+
+inline FrozenBook FrozenValueCodec<Book>::decode(const stored_type &stored, const char *heap) {
+    return {frozenString(stored.ISBN, heap), frozenString(stored.title, heap), frozenString(stored.author, heap),
+            frozenString(stored.publisher, heap), frozenString(stored.yearPublished, heap), stored.copies};
+}
+
+/**
+ * Writes an image of the given table to the given file. The slot array gets at least twice as many slots as the table
+ * has entries, so linear probing stays short.
+ *
+ * @tparam Table A HashTable (or any table with the same iterator) with std::string keys and ValueType values
+ * @param table The table to freeze
+ * @param path The file to write the image to
+ * @throws std::runtime_error If the file cannot be written
+ */
+template<typename ValueType>
+template<typename Table>
+void FrozenHashTable<ValueType>::freeze(Table &table, const std::string &path) {
+    std::uint32_t slotCount = 8;
+
+    while (slotCount < 2 * table.size()) {
+        slotCount *= 2;
+    }
+
+    // Slots are copied into a zeroed buffer, so that padding bytes are written as zeros
+    std::vector<char> slotBytes(static_cast<size_t>(slotCount) * sizeof(Slot), 0);
+    FrozenStringHeap stringHeap;
+    std::uint32_t size = 0;
+
+    for (auto it = table.begin(); it != table.end(); ++it) {
+        const auto bucket = *it;
+        Slot slot;
+
+        std::memset(&slot, 0, sizeof(Slot));
+        slot.hash = hashKey(bucket->key);
+        slot.key = stringHeap.add(bucket->key);
+        slot.value = Codec::encode(bucket->value, stringHeap);
+
+        std::uint32_t index = static_cast<std::uint32_t>(slot.hash) & (slotCount - 1);
+
+        while (reinterpret_cast<const Slot *>(slotBytes.data())[index].hash != 0) {
+            index = (index + 1) & (slotCount - 1);
+        }
+
+        std::memcpy(slotBytes.data() + static_cast<size_t>(index) * sizeof(Slot), &slot, sizeof(Slot));
+        size += 1;
+    }
+
+    Header imageHeader;
+
+    std::memset(&imageHeader, 0, sizeof(Header));
+    std::memcpy(imageHeader.magic, MAGIC, sizeof(MAGIC));
+    imageHeader.version = VERSION;
+    imageHeader.slotSize = sizeof(Slot);
+    imageHeader.valueType = Codec::TYPE_TAG;
+    imageHeader.slotCount = slotCount;
+    imageHeader.size = size;
+    imageHeader.slotsOffset = 64;
+    imageHeader.heapOffset = imageHeader.slotsOffset + slotBytes.size();
+    imageHeader.heapSize = stringHeap.bytes().size();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    const std::vector<char> padding(imageHeader.slotsOffset - sizeof(Header), 0);
+
+    file.write(reinterpret_cast<const char *>(&imageHeader), sizeof(Header));
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+    file.write(slotBytes.data(), static_cast<std::streamsize>(slotBytes.size()));
+    file.write(stringHeap.bytes().data(), static_cast<std::streamsize>(stringHeap.bytes().size()));
+
+    if (!file) throw std::runtime_error("Failed to write frozen hash table image " + path);
+}
+
+/**
+ * Constructor. Maps the given image read-only and checks that its header was written by this version for this value
+ * type and fits the file; no entry is read until it is looked up, so the slots and the heap are trusted as written.
+ *
+ * @param path The image file to open
+ * @throws std::runtime_error If the file cannot be mapped or is not a valid image
+ */
+template<typename ValueType>
+FrozenHashTable<ValueType>::FrozenHashTable(const std::string &path) {
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+
+    if (descriptor < 0) throw std::runtime_error("Failed to open frozen hash table image " + path);
+
+    struct stat fileStatus{};
+
+    if (::fstat(descriptor, &fileStatus) != 0 || fileStatus.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(descriptor);
+        throw std::runtime_error("Frozen hash table image is too small: " + path);
+    }
+
+    imageSize = static_cast<size_t>(fileStatus.st_size);
+    void *mapping = ::mmap(nullptr, imageSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+    // The mapping keeps the file alive on its own
+    ::close(descriptor);
+
+    if (mapping == MAP_FAILED) throw std::runtime_error("Failed to map frozen hash table image " + path);
+
+    image = static_cast<const char *>(mapping);
+    header = reinterpret_cast<const Header *>(image);
+
+    const bool valid = std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                       header->version == VERSION &&
+                       header->slotSize == sizeof(Slot) &&
+                       header->valueType == Codec::TYPE_TAG &&
+                       header->slotCount > 0 && (header->slotCount & (header->slotCount - 1)) == 0 &&
+                       header->size < header->slotCount &&
+                       header->slotsOffset % alignof(Slot) == 0 &&
+                       header->heapOffset ==
+                       header->slotsOffset + static_cast<std::uint64_t>(header->slotCount) * sizeof(Slot) &&
+                       header->heapOffset + header->heapSize <= imageSize;
+
+    if (!valid) {
+        ::munmap(mapping, imageSize);
+        throw std::runtime_error("Not a version " + std::to_string(VERSION) + " frozen hash table image: " + path);
+    }
+
+    slots = reinterpret_cast<const Slot *>(image + header->slotsOffset);
+    heap = image + header->heapOffset;
+}
+
+/**
+ * Destructor. Unmaps the image.
+ */
+template<typename ValueType>
+FrozenHashTable<ValueType>::~FrozenHashTable() {
+    if (image != nullptr) ::munmap(const_cast<char *>(image), imageSize);
+}
+
+/**
+ * Move constructor. The other table is left without an image.
+ *
+ * @param other The table to take the image from
+ */
+template<typename ValueType>
+FrozenHashTable<ValueType>::FrozenHashTable(FrozenHashTable &&other) noexcept
+        : image(other.image), imageSize(other.imageSize), header(other.header), slots(other.slots), heap(other.heap) {
+    other.image = nullptr;
+    other.imageSize = 0;
+}
+
+/**
+ * Returns a view of the value of the key if it exists. String views inside the result point into the mapped image and
+ * stay valid as long as the table is open.
+ *
+ * @param key The key to search for
+ * @return A view of the value of the key, or std::nullopt if the key does not exist
+ */
+template<typename ValueType>
+std::optional<typename FrozenHashTable<ValueType>::View> FrozenHashTable<ValueType>::search(
+    const std::string_view key
+) const {
+    const Slot *slot = findSlot(key);
+
+    if (slot == nullptr) return std::nullopt;
+
+    return Codec::decode(slot->value, heap);
+}
+
+/**
+ * Returns whether the key exists in the table.
+ *
+ * @param key The key to search for
+ * @return Whether the key exists
+ */
+template<typename ValueType>
+bool FrozenHashTable<ValueType>::contains(const std::string_view key) const {
+    return findSlot(key) != nullptr;
+}
+
+/**
+ * Returns the number of items in the table.
+ *
+ * @return The number of items in the table
+ */
+template<typename ValueType>
+unsigned int FrozenHashTable<ValueType>::size() const {
+    return header->size;
+}
+
+/**
+ * Returns the number of slots in the image.
+ *
+ * @return The number of slots in the image
+ */
+template<typename ValueType>
+unsigned int FrozenHashTable<ValueType>::slotCount() const {
+    return header->slotCount;
+}
+
+/**
+ * Hashes the key with 64-bit FNV-1a. Unlike std::hash, the result does not depend on the standard library, so an image
+ * can be opened by a build other than the one that wrote it.
+ *
+ * @param key The key to hash
+ * @return The hash of the key, never 0
+ */
+template<typename ValueType>
+std::uint64_t FrozenHashTable<ValueType>::hashKey(const std::string_view key) {
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    for (const char character: key) {
+        hash = (hash ^ static_cast<unsigned char>(character)) * 1099511628211ULL;
+    }
+
+    return hash != 0 ? hash : 1;
+}
+
+/**
+ * Returns the slot holding the given key by probing linearly from its home slot up to the first empty slot.
+ *
+ * @param key The key to search for
+ * @return The slot holding the key, or nullptr if the key does not exist
+ */
+template<typename ValueType>
+const typename FrozenHashTable<ValueType>::Slot *FrozenHashTable<ValueType>::findSlot(
+    const std::string_view key
+) const {
+    const std::uint32_t mask = header->slotCount - 1;
+    const std::uint64_t hash = hashKey(key);
+
+    for (std::uint32_t index = static_cast<std::uint32_t>(hash) & mask; slots[index].hash != 0;
+         index = (index + 1) & mask) {
+        if (slots[index].hash == hash && frozenString(slots[index].key, heap) == key) return &slots[index];
+    }
+
+    return nullptr;
+}
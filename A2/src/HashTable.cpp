@@ -9,84 +9,450 @@
  * @return The calculated hash key
  */
 template<typename Key>
-unsigned int hashKey(Key key, const unsigned int tableSize) {
+unsigned int hashKey(const Key &key, const unsigned int tableSize) {
     return std::hash<Key>{}(key) % tableSize;
 }
 
 /**
- * Constructor.
+ * Wraps an index that went past the end of the table by less than one table size, without a division.
  *
+ * @param index The index to wrap, smaller than twice the table size
  * @param size The size of the hash table
- * @param threshold The max load factor
+ * @return The index within the table
  */
-template<typename KeyType, typename ValueType>
-HashTable<KeyType, ValueType>::HashTable(const unsigned int size, const double threshold) : tableSize(size),
-    loadFactorThreshold(threshold), hashTable(size) {
+inline unsigned int wrapIndex(const unsigned int index, const unsigned int size) {
+    return index >= size ? index - size : index;
 }
 
 /**
- * Returns the beginning of the hash table.
+ * Returns the smallest power of two that is at least the given size.
  *
- * @return The beginning of the hash table
+ * @param size The requested size
+ * @param minimum The smallest size to return (a power of two)
+ * @return The rounded up size
  */
-template<typename KeyType, typename ValueType>
-typename HashTable<KeyType, ValueType>::Iterator HashTable<KeyType, ValueType>::begin() {
-    auto it = hashTable.begin();
-    // Skip to first occupied bucket if current one is not occupied
-    while (it != hashTable.end() && !it->occupied) {
-        ++it;
+inline unsigned int roundUpToPowerOfTwo(const unsigned int size, unsigned int minimum) {
+    while (minimum < size) {
+        minimum *= 2;
     }
-    return Iterator(it, hashTable.end());
+
+    return minimum;
 }
 
+/**
+ * Returns the position of the lowest set bit of the given (non-zero) neighbourhood bitmap.
+ *
+ * @param bitmap The bitmap to scan
+ * @return The position of the lowest set bit
+ */
+inline unsigned int lowestSetBit(const std::uint64_t bitmap) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned int>(__builtin_ctzll(bitmap));
+#else
+    unsigned int position = 0;
+
+    while (!((bitmap >> position) & 1)) {
+        position += 1;
+    }
+
+    return position;
+#endif
+}
 
 /**
- * Returns the end of the hash table.
+ * Starts loading the cache line holding the given address. Does nothing on compilers without a prefetch intrinsic.
  *
- * @return The end of the hash table.
+ * @param address The address that will be read soon
+ */
+inline void prefetchForRead(const void *address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 3);
+#else
+    (void) address;
+#endif
+}
+
+/**
+ * Constructor. All buckets start empty.
+ *
+ * @param size The number of buckets
  */
-template<typename KeyType, typename ValueType>
-typename HashTable<KeyType, ValueType>::Iterator HashTable<KeyType, ValueType>::end() {
-    return Iterator(hashTable.end(), hashTable.end());
+inline OccupancyBitmap::OccupancyBitmap(const unsigned int size) : words((size + 63) / 64, 0) {
+}
+
+inline OccupancyBit<false> OccupancyBitmap::operator[](const unsigned int index) {
+    return OccupancyBit<false>(words[index / 64], static_cast<std::uint64_t>(1) << (index % 64));
 }
 
+inline OccupancyBit<true> OccupancyBitmap::operator[](const unsigned int index) const {
+    return OccupancyBit<true>(words[index / 64], static_cast<std::uint64_t>(1) << (index % 64));
+}
 
 /**
- * Returns the value corresponding to the given key if it exists.
+ * Returns the first occupied bucket in [index, end), skipping 64 empty buckets per word.
  *
- * @param key The key to retrieve the value of
- * @return The value corresponding to the given key if it exists
+ * @param index The first bucket to look at
+ * @param end The bucket past the last one to look at
+ * @return The index of the first occupied bucket, or end if there is none
  */
-template<typename KeyType, typename ValueType>
-ValueType &HashTable<KeyType, ValueType>::operator[](const KeyType &key) {
-    // First try to find the key
-    const int startingIndex = hashKey(key, tableSize);
-    int currentHop = 0;
+inline unsigned int OccupancyBitmap::next(const unsigned int index, const unsigned int end) const {
+    if (index >= end) return end;
 
-    while (currentHop < HOP_RANGE) {
-        const int index = (startingIndex + currentHop) % tableSize;
+    size_t word = index / 64;
+    // Ignore the buckets before the index in its word
+    std::uint64_t bits = words[word] & (~static_cast<std::uint64_t>(0) << (index % 64));
+    const size_t lastWord = (end - 1) / 64;
 
-        if (hashTable[index].key == key && hashTable[index].occupied) return hashTable[index].value;
+    while (bits == 0) {
+        if (word == lastWord) return end;
 
-        currentHop += 1;
+        bits = words[++word];
     }
 
-    // If key not found, insert a default-constructed value and return a reference to it
-    insert(key, ValueType());
-    // Now find the newly inserted value and return its reference
-    currentHop = 0;
-    while (currentHop < HOP_RANGE) {
-        const int index = (startingIndex + currentHop) % tableSize;
+    const unsigned int occupied = static_cast<unsigned int>(word * 64) + lowestSetBit(bits);
+
+    return occupied < end ? occupied : end;
+}
+
+inline void OccupancyBitmap::assign(const unsigned int size) {
+    words.assign((size + 63) / 64, 0);
+}
+
+inline void OccupancyBitmap::swap(OccupancyBitmap &other) {
+    words.swap(other.words);
+}
+
+inline void OccupancyBitmap::release() {
+    std::vector<std::uint64_t>().swap(words);
+}
+
+inline size_t OccupancyBitmap::bytesUsed() const {
+    return words.capacity() * sizeof(std::uint64_t);
+}
+
+/**
+ * Hashes the key (or its view) with std::hash.
+ *
+ * @param key The key to hash
+ * @return The hash of the key
+ */
+template<typename KeyType>
+size_t DefaultHasher<KeyType>::operator()(typename HashKeyView<KeyType>::type key) const {
+    return std::hash<typename std::decay<typename HashKeyView<KeyType>::type>::type>{}(key);
+}
+
+/**
+ * Hashes the key (or its view) with std::hash, then mixes every bit of the hash into every other one with the
+ * SplitMix64 finalizer.
+ *
+ * @param key The key to hash
+ * @return The mixed hash of the key
+ */
+template<typename KeyType>
+size_t MixingHasher<KeyType>::operator()(typename HashKeyView<KeyType>::type key) const {
+    std::uint64_t hash = DefaultHasher<KeyType>{}(key);
+
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+
+    return static_cast<size_t>(hash ^ (hash >> 31));
+}
+
+/**
+ * Doubles the table size.
+ *
+ * @param size The current table size
+ * @return The next table size
+ */
+inline unsigned int DoublingGrowth::nextSize(const unsigned int size) {
+    return size * 2;
+}
+
+/**
+ * Grows the table size by half, which wastes less memory after a resize at the cost of resizing more often.
+ *
+ * @param size The current table size
+ * @return The next table size
+ */
+inline unsigned int HalfAgainGrowth::nextSize(const unsigned int size) {
+    return size + (size < 2 ? 1 : size / 2);
+}
+
+inline unsigned int ModuloIndexMapping::tableSize(const unsigned int requestedSize) {
+    return requestedSize > 0 ? requestedSize : 1;
+}
+
+inline unsigned int ModuloIndexMapping::index(const size_t hash, const unsigned int size) {
+    return static_cast<unsigned int>(hash % size);
+}
+
+inline unsigned int PowerOfTwoIndexMapping::tableSize(const unsigned int requestedSize) {
+    return roundUpToPowerOfTwo(requestedSize, 1);
+}
+
+inline unsigned int PowerOfTwoIndexMapping::index(const size_t hash, const unsigned int size) {
+    return static_cast<unsigned int>(hash & (size - 1));
+}
+
+inline unsigned int FibonacciIndexMapping::tableSize(const unsigned int requestedSize) {
+    // The shift below needs at least one index bit
+    return roundUpToPowerOfTwo(requestedSize, 2);
+}
+
+inline unsigned int FibonacciIndexMapping::index(const size_t hash, const unsigned int size) {
+    // 2^64 divided by the golden ratio; the top log2(size) bits of the product are the index
+    return static_cast<unsigned int>((static_cast<std::uint64_t>(hash) * 11400714819323198485ULL) >>
+                                     (64 - lowestSetBit(size)));
+}
+
+inline unsigned int FastRangeIndexMapping::tableSize(const unsigned int requestedSize) {
+    return requestedSize > 0 ? requestedSize : 1;
+}
+
+inline unsigned int FastRangeIndexMapping::index(const size_t hash, const unsigned int size) {
+#if defined(__SIZEOF_INT128__)
+    return static_cast<unsigned int>((static_cast<unsigned __int128>(hash) * size) >> 64);
+#else
+    return static_cast<unsigned int>(((static_cast<std::uint64_t>(hash) >> 32) * size) >> 32);
+#endif
+}
+
+/**
+ * Destructor. Destroys every value ever constructed in the slab, released or not.
+ */
+template<typename ValueType>
+ValueSlab<ValueType>::~ValueSlab() {
+    for (size_t i = 0; i < constructedCount; ++i) {
+        std::launder(reinterpret_cast<ValueType *>(&chunks[i / CHUNK_SIZE][i % CHUNK_SIZE]))->~ValueType();
+    }
+}
+
+/**
+ * Stores the given value in a released slot if there is one, or else in the next unused slot, adding a chunk when the
+ * last one is full.
+ *
+ * @param value The value to store
+ * @return The address of the stored value, which stays valid until it is released
+ */
+template<typename ValueType>
+template<typename Value>
+ValueType *ValueSlab<ValueType>::allocate(Value &&value) {
+    if (!freeValues.empty()) {
+        ValueType *reused = freeValues.back();
+
+        *reused = std::forward<Value>(value);
+        freeValues.pop_back();
+
+        return reused;
+    }
+
+    if (constructedCount == chunks.size() * CHUNK_SIZE) chunks.emplace_back(new Slot[CHUNK_SIZE]);
+
+    Slot &slot = chunks[constructedCount / CHUNK_SIZE][constructedCount % CHUNK_SIZE];
+    ValueType *constructed = new(&slot) ValueType(std::forward<Value>(value));
+
+    constructedCount += 1;
+
+    return constructed;
+}
+
+/**
+ * Hands the given value back to the slab. It is reset to a default value right away, so whatever it held is freed now
+ * rather than when its slot is reused.
+ *
+ * @param value The value to release, which must have come from allocate()
+ */
+template<typename ValueType>
+void ValueSlab<ValueType>::release(ValueType *value) {
+    *value = ValueType();
+    freeValues.push_back(value);
+}
+
+/**
+ * Returns the number of bytes held by the slab's chunks and free list, not counting memory owned by the values.
+ *
+ * @return The number of bytes used by the slab
+ */
+template<typename ValueType>
+size_t ValueSlab<ValueType>::bytesUsed() const {
+    return chunks.size() * CHUNK_SIZE * sizeof(Slot) + freeValues.capacity() * sizeof(ValueType *);
+}
+
+/**
+ * Constructor. Removals never shrink the table below its initial size.
+ *
+ * @param size The size of the hash table, rounded up to a size the index mapping supports
+ * @param threshold The max load factor
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+HashTable<KeyType, ValueType, H, Policy>::HashTable(const unsigned int size, const double threshold) : tableSize(
+        IndexMapping::tableSize(size)), loadFactorThreshold(threshold), hashTable(tableSize),
+    minimumTableSize(tableSize), shrinkThreshold(threshold / 4) {
+    oldTable.shareStorage(hashTable);
+}
+
+/**
+ * Builds a hash table from a range of (key, value) pairs, such as a std::vector<std::pair<KeyType, ValueType>> or a
+ * std::map. The table is sized for the whole range up front, then the entries are sorted by home bucket and placed in
+ * a single pass over the bucket array, so consecutive entries land in the same or neighbouring cache lines. When a key
+ * appears more than once, its first occurrence is kept, as with insert.
+ *
+ * With several threads, the bucket array is split into one contiguous block per thread, ending on a multiple of 64
+ * buckets, and each thread places the entries whose home bucket lies in its block. An entry that would have to leave
+ * its block, or to displace another entry, is left for a final single-threaded pass. Threads only pay off for tens of
+ * millions of entries.
+ *
+ * @param entries The (key, value) pairs to build the table from; its iterators must yield references, not copies
+ * @param threshold The max load factor
+ * @param threadCount The number of threads to place the entries with
+ * @return The hash table holding the entries
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename Range>
+HashTable<KeyType, ValueType, H, Policy> HashTable<KeyType, ValueType, H, Policy>::buildFrom(
+    const Range &entries,
+    const double threshold,
+    unsigned int threadCount
+) {
+    using Entry = typename std::decay<decltype(*std::begin(entries))>::type;
+
+    // The sorted entries point into the range, so it has to hold its pairs rather than produce them on the fly
+    static_assert(std::is_lvalue_reference<decltype(*std::begin(entries))>::value,
+                  "buildFrom needs a range whose iterators yield references to stored pairs");
+
+    const auto entryCount = static_cast<unsigned int>(std::distance(std::begin(entries), std::end(entries)));
+    HashTable table(1, threshold);
+
+    table.reserve(entryCount);
+
+    // Counting sort by home bucket: count the entries of every bucket, then scatter them in bucket order. Being stable,
+    // it keeps the first occurrence of a key ahead of the others.
+    std::vector<BulkEntry<Entry>> hashedEntries;
+    std::vector<unsigned int> bucketStarts(table.tableSize + 1, 0);
 
-        if (hashTable[index].key == key && hashTable[index].occupied) {
-            return hashTable[index].value;
+    hashedEntries.reserve(entryCount);
+
+    for (const Entry &entry: entries) {
+        const size_t hash = Hasher{}(entry.first);
+        const unsigned int home = IndexMapping::index(hash, table.tableSize);
+
+        hashedEntries.push_back({home, hash, &entry});
+        bucketStarts[home + 1] += 1;
+    }
+
+    for (unsigned int i = 0; i < table.tableSize; ++i) {
+        bucketStarts[i + 1] += bucketStarts[i];
+    }
+
+    std::vector<BulkEntry<Entry>> sortedEntries(hashedEntries.size());
+
+    for (const BulkEntry<Entry> &entry: hashedEntries) {
+        sortedEntries[bucketStarts[entry.home]++] = entry;
+    }
+
+    // Every thread gets at least a few neighbourhoods' worth of buckets, if the layout lets threads place entries at all
+    threadCount = std::max(1u, std::min(threadCount, table.tableSize / (4 * HOP_RANGE)));
+
+    if (!Buckets::PARALLEL_PLACEMENT) threadCount = 1;
+
+    std::vector<std::vector<const BulkEntry<Entry> *>> deferred(threadCount);
+    std::vector<unsigned int> placed(threadCount, 0);
+    std::vector<std::thread> threads;
+    size_t first = 0;
+
+    for (unsigned int t = 0; t < threadCount; ++t) {
+        // Blocks end on a whole word of the occupancy bitmap, so that no two threads write to the same word
+        const unsigned int limit = std::min(table.tableSize, static_cast<unsigned int>(
+            (static_cast<std::uint64_t>(table.tableSize) * (t + 1) / threadCount + 63) / 64 * 64));
+        const size_t last = std::lower_bound(sortedEntries.begin() + first, sortedEntries.end(), limit,
+                                             [](const BulkEntry<Entry> &entry, const unsigned int home) {
+                                                 return entry.home < home;
+                                             }) - sortedEntries.begin();
+        auto placeBlock = [&table, &sortedEntries, &deferred, &placed, first, last, limit, t]() {
+            placed[t] = table.placeSorted(sortedEntries, first, last, limit, deferred[t]);
+        };
+
+        if (t + 1 < threadCount) {
+            threads.emplace_back(placeBlock);
+        } else {
+            placeBlock();
         }
 
-        currentHop += 1;
+        first = last;
     }
 
-    // This should never happen if insert worked correctly
-    throw std::runtime_error("Failed to insert value");
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    for (unsigned int t = 0; t < threadCount; ++t) {
+        table.elementCount += placed[t];
+    }
+
+    // Place the entries that could not be placed without leaving their block, in their original order
+    for (const std::vector<const BulkEntry<Entry> *> &block: deferred) {
+        for (const BulkEntry<Entry> *entry: block) {
+            if (table.findValue(entry->entry->first, entry->hash) != nullptr) continue;
+
+            while (table.place(entry->hash, entry->entry->first, entry->entry->second) < 0) {
+                table.rehash();
+            }
+        }
+    }
+
+    return table;
+}
+
+/**
+ * Returns the beginning of the hash table.
+ *
+ * @return The beginning of the hash table
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+typename HashTable<KeyType, ValueType, H, Policy>::Iterator HashTable<KeyType, ValueType, H, Policy>::begin() {
+    // Iteration only walks one bucket array, so any pending migration is completed first
+    migrateBuckets(oldTableSize);
+
+    // Skip to first occupied bucket
+    return Iterator(&hashTable, hashTable.nextOccupied(0, tableSize), tableSize);
+}
+
+
+/**
+ * Returns the end of the hash table.
+ *
+ * @return The end of the hash table.
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+typename HashTable<KeyType, ValueType, H, Policy>::Iterator HashTable<KeyType, ValueType, H, Policy>::end() {
+    return Iterator(&hashTable, tableSize, tableSize);
+}
+
+
+/**
+ * Returns the value corresponding to the given key, inserting a default-constructed value first if the key does not
+ * exist yet.
+ *
+ * @param key The key to retrieve the value of
+ * @return The value corresponding to the given key
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+ValueType &HashTable<KeyType, ValueType, H, Policy>::operator[](const KeyType &key) {
+    return findOrInsert(key).first;
+}
+
+/**
+ * Returns the value corresponding to the key viewed by the given lookup key (e.g. a std::string_view or a C string for
+ * std::string keys). The lookup hashes and compares the view in place; a KeyType is only built if the key has to be
+ * inserted.
+ *
+ * @param key The key to retrieve the value of
+ * @return The value corresponding to the given key
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename LookupKey, typename>
+ValueType &HashTable<KeyType, ValueType, H, Policy>::operator[](const LookupKey &key) {
+    return findOrInsert(key).first;
 }
 
 /**
@@ -94,130 +460,207 @@ ValueType &HashTable<KeyType, ValueType>::operator[](const KeyType &key) {
  *
  * @param key The key of the value to update
  * @param newValue The new value
+ * @return Whether the key exists
  */
-template<typename KeyType, typename ValueType>
-void HashTable<KeyType, ValueType>::updateValueForKey(const KeyType &key, ValueType newValue) {
-    const int startingIndex = hashKey(key, tableSize);
-    int currentHop = 0;
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+bool HashTable<KeyType, ValueType, H, Policy>::updateValueForKey(const KeyType &key, ValueType newValue) {
+    ValueType *value = findValue(key);
 
-    while (currentHop < HOP_RANGE) {
-        if (hashTable[(startingIndex + currentHop) % tableSize].key == key) {
-            hashTable[(startingIndex + currentHop) % tableSize].value = newValue;
+    if (value == nullptr) return false;
 
-            return;
-        }
+    *value = std::move(newValue);
 
-        currentHop += 1;
-    }
+    return true;
 }
 
 /**
- * Inserts a value for the given key if possible.
+ * Inserts a value for the given key if the key does not exist yet. During an incremental rehash, every insertion also
+ * migrates a bounded number of buckets from the old table.
  *
  * @param key The key to insert the value for
  * @param value The value to insert
+ * @return Whether the key was inserted; false means the key already exists and its value was left untouched
  */
-template<typename KeyType, typename ValueType>
-void HashTable<KeyType, ValueType>::insert(const KeyType &key, const ValueType &value) {
-    // If the load factor threshold is exceeded, rehash and retry insertion
-    if (loadFactor() >= loadFactorThreshold) {
-        rehash();
-        insert(key, value);
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+bool HashTable<KeyType, ValueType, H, Policy>::insert(const KeyType &key, const ValueType &value) {
+    return findOrPlace(key, [&value]() -> const ValueType & { return value; }).second;
+}
 
-        return;
-    }
+/**
+ * Inserts a value constructed from the given arguments if the key does not exist yet. Unlike insert, the value is only
+ * constructed when the key is actually inserted.
+ *
+ * @param key The key to insert the value for
+ * @param args The arguments to construct the value from
+ * @return The value of the key, and whether the key was inserted
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename... Args>
+std::pair<ValueType &, bool> HashTable<KeyType, ValueType, H, Policy>::try_emplace(const KeyType &key, Args &&... args) {
+    return findOrPlace(key, [&args...]() { return ValueType(std::forward<Args>(args)...); });
+}
 
-    const int startingIndex = hashKey(key, tableSize);
-    unsigned int currentHop = 0;
+/**
+ * Inserts the given value for the key, or assigns it to the existing value if the key already exists.
+ *
+ * @param key The key to insert or assign the value for
+ * @param value The value to insert or assign
+ * @return The value of the key, and whether the key was inserted
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename Value>
+std::pair<ValueType &, bool> HashTable<KeyType, ValueType, H, Policy>::insert_or_assign(const KeyType &key,
+                                                                                       Value &&value) {
+    bool assigned = false;
+    std::pair<ValueType &, bool> result = findOrPlace(key, [&value, &assigned]() -> Value && {
+        assigned = true;
+        return std::forward<Value>(value);
+    });
 
-    while (currentHop < HOP_RANGE) {
-        const int index = (startingIndex + currentHop) % tableSize;
+    if (!assigned) result.first = std::forward<Value>(value);
 
-        // If the key already exists in the hash table, do nothing
-        if (hashTable[index].key == key) return;
-        // If the bucket is not occupied, we can immediately insert then exit
-        if (!hashTable[index].occupied) {
-            hashTable[index].key = key;
-            hashTable[index].value = value;
-            hashTable[index].occupied = true;
-            hashTable[index].hopInfo = currentHop;
+    return result;
+}
 
-            return;
-        }
+/**
+ * Returns the value of the given key, inserting a default-constructed value first if the key does not exist yet.
+ *
+ * @param key The key to find or insert
+ * @return The value of the key, and whether the key was inserted
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+std::pair<ValueType &, bool> HashTable<KeyType, ValueType, H, Policy>::findOrInsert(const KeyType &key) {
+    return findOrPlace(key, []() { return ValueType(); });
+}
 
-        currentHop += 1;
-    }
+/**
+ * Returns the value of the key viewed by the given lookup key, inserting a default-constructed value first if the key
+ * does not exist yet. A KeyType is only built if the key has to be inserted.
+ *
+ * @param key The key to find or insert
+ * @return The value of the key, and whether the key was inserted
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename LookupKey, typename>
+std::pair<ValueType &, bool> HashTable<KeyType, ValueType, H, Policy>::findOrInsert(const LookupKey &key) {
+    return findOrPlace(KeyView(key), []() { return ValueType(); });
+}
 
-    try {
-        // If we reach this point, that means the key's home neighbourhood is full, and we should try to shift an empty
-        // bucket into it if possible
-        unsigned int emptyIndex = findFreeSlot(hashTable, startingIndex, currentHop);
-        int index = emptyIndex == 0 ? tableSize - 1 : emptyIndex - 1;
-
-        while (index != startingIndex) {
-            // If the element at the current index can be shifted
-            if (hashTable[index].occupied && hashTable[index].hopInfo < 4) {
-                Bucket temp = hashTable[index];
-
-                // Move the element at the current index to the empty bucket
-                hashTable[emptyIndex].key = temp.key;
-                hashTable[emptyIndex].value = temp.value;
-                hashTable[emptyIndex].occupied = true;
-                hashTable[emptyIndex].hopInfo = temp.hopInfo + 1;
-
-                // Check if the current index is within the home neighbourhood
-                if (
-                    index == (startingIndex + 1) % tableSize ||
-                    index == (startingIndex + 2) % tableSize ||
-                    index == (startingIndex + 3) % tableSize
-                ) {
-                    // If it is, we can immediately insert the element at the current index then exit
-                    hashTable[index].key = key;
-                    hashTable[index].value = value;
-                    hashTable[index].occupied = true;
-                    hashTable[index].hopInfo = index - startingIndex;
-
-                    return;
-                }
-                // Else, empty the current index's bucket
-                else {
-                    hashTable[index].occupied = false;
-                    emptyIndex = index;
-                }
-            }
+/**
+ * Calls the given function on the value of the key, inserting a default-constructed value first if the key does not
+ * exist yet, e.g. table.upsert(isbn, [](int &count) { count += 1; }) counts a book in a single probe.
+ *
+ * @param key The key of the value to update
+ * @param function The function to call with a reference to the value
+ * @return Whether the key was inserted
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename Function>
+bool HashTable<KeyType, ValueType, H, Policy>::upsert(const KeyType &key, Function &&function) {
+    std::pair<ValueType &, bool> result = findOrInsert(key);
 
-            index = index == 0 ? tableSize - 1 : index - 1;
-        }
+    std::forward<Function>(function)(result.first);
 
-        // If index == startingIndex, it means the empty bucket could not be moved into the home neighbourhood, meaning
-        // we must rehash and retry insertion
-        rehash();
-        insert(key, value);
-    } catch (std::runtime_error &e) {
-        // If we reach this point, that means the hash table is full
-    }
+    return result.second;
 }
 
 /**
- * Returns the value of the key if it exists.
+ * Calls the given function on the value of the key viewed by the given lookup key, inserting a default-constructed
+ * value first if the key does not exist yet.
+ *
+ * @param key The key of the value to update
+ * @param function The function to call with a reference to the value
+ * @return Whether the key was inserted
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename LookupKey, typename Function, typename>
+bool HashTable<KeyType, ValueType, H, Policy>::upsert(const LookupKey &key, Function &&function) {
+    std::pair<ValueType &, bool> result = findOrInsert(key);
+
+    std::forward<Function>(function)(result.first);
+
+    return result.second;
+}
+
+/**
+ * Returns the value of the key if it exists. Searching never migrates buckets, so pointers returned by earlier searches
+ * stay valid.
  *
  * @param key The key to search for
  * @return The value of the key if it exists
  */
-template<typename KeyType, typename ValueType>
-ValueType *HashTable<KeyType, ValueType>::search(const KeyType &key) {
-    const int startingIndex = hashKey(key, tableSize);
-    int currentHop = 0;
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+ValueType *HashTable<KeyType, ValueType, H, Policy>::search(const KeyType &key) {
+    return findValue(key);
+}
 
-    while (currentHop < HOP_RANGE) {
-        const int index = (startingIndex + currentHop) % tableSize;
+/**
+ * Returns the value of the key viewed by the given lookup key if it exists, without building a KeyType.
+ *
+ * @param key The key to search for
+ * @return The value of the key if it exists
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename LookupKey, typename>
+ValueType *HashTable<KeyType, ValueType, H, Policy>::search(const LookupKey &key) {
+    return findValue(KeyView(key));
+}
 
-        if (hashTable[index].key == key && hashTable[index].occupied) return &hashTable[index].value;
+/**
+ * Searches for every key of the given range, such as a std::vector of keys or of their views. Keys are hashed and their
+ * home buckets prefetched BATCH_SIZE keys ahead of the key being probed, so up to BATCH_SIZE cache misses are in flight
+ * at once instead of being paid one after the other. This pays off once the table no longer fits in the cache.
+ *
+ * @param keys The keys (or views of them) to search for
+ * @param results Set to one entry per key: the value of the key, or nullptr if the key does not exist
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename LookupKeys>
+void HashTable<KeyType, ValueType, H, Policy>::searchBatch(const LookupKeys &keys, std::vector<ValueType *> &results) {
+    // The hashes and home buckets of the keys between the probed key and the prefetched one
+    size_t hashes[BATCH_SIZE];
+    unsigned int homes[BATCH_SIZE];
+    auto ahead = std::begin(keys);
+    const auto last = std::end(keys);
 
-        currentHop += 1;
+    results.clear();
+
+    auto prefetchAhead = [&](const unsigned int slot) {
+        hashes[slot] = Hasher{}(KeyView(*ahead));
+        homes[slot] = IndexMapping::index(hashes[slot], tableSize);
+        hashTable.prefetch(homes[slot]);
+
+        if (oldTableSize > 0) oldTable.prefetch(IndexMapping::index(hashes[slot], oldTableSize));
+
+        ++ahead;
+    };
+
+    unsigned int pending = 0;
+
+    for (; ahead != last && pending < BATCH_SIZE; ++pending) {
+        prefetchAhead(pending);
     }
 
-    return nullptr;
+    for (auto it = std::begin(keys); pending > 0; ++it) {
+        const unsigned int slot = static_cast<unsigned int>(results.size() % BATCH_SIZE);
+        const KeyView key(*it);
+        int index = findIndex(hashTable, tableSize, key, hashes[slot], homes[slot]);
+        ValueType *value = index >= 0 ? &hashTable[index].value : nullptr;
+
+        if (value == nullptr && oldTableSize > 0) {
+            index = findIndex(oldTable, oldTableSize, key, hashes[slot]);
+            value = index >= 0 ? &oldTable[index].value : nullptr;
+        }
+
+        results.push_back(value);
+
+        // The slot of the key just probed is free for the next key to prefetch
+        if (ahead != last) {
+            prefetchAhead(slot);
+        } else {
+            pending -= 1;
+        }
+    }
 }
 
 /**
@@ -226,34 +669,108 @@ ValueType *HashTable<KeyType, ValueType>::search(const KeyType &key) {
  * @param key The key to remove
  * @return Whether the removal was successful
  */
-template<typename KeyType, typename ValueType>
-bool HashTable<KeyType, ValueType>::remove(const KeyType &key) {
-    const int startingIndex = hashKey(key, tableSize);
-    int currentHop = 0;
-
-    while (currentHop < HOP_RANGE) {
-        const int index = (startingIndex + currentHop) % tableSize;
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+bool HashTable<KeyType, ValueType, H, Policy>::remove(const KeyType &key) {
+    return removeKey(key);
+}
 
-        if (hashTable[index].key == key && hashTable[index].occupied) {
-            hashTable[index].occupied = false;
+/**
+ * Removes the key viewed by the given lookup key from the hash table if it exists, without building a KeyType.
+ *
+ * @param key The key to remove
+ * @return Whether the removal was successful
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename LookupKey, typename>
+bool HashTable<KeyType, ValueType, H, Policy>::remove(const LookupKey &key) {
+    return removeKey(KeyView(key));
+}
 
-            return true;
-        }
+/**
+ * Removes the key from the hash table if it exists, looking in the old table as well during an incremental rehash.
+ *
+ * @param key The key (or a view of it) to remove
+ * @return Whether the removal was successful
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename LookupKey>
+bool HashTable<KeyType, ValueType, H, Policy>::removeKey(const LookupKey &key) {
+    Buckets *table = &hashTable;
+    unsigned int size = tableSize;
+    int index = findIndex(hashTable, tableSize, key);
 
-        currentHop += 1;
+    // During an incremental rehash, the key may still be waiting in the old table
+    if (index < 0 && oldTableSize > 0) {
+        table = &oldTable;
+        size = oldTableSize;
+        index = findIndex(oldTable, oldTableSize, key);
     }
 
-    return false;
+    if (index < 0) return false;
+
+    vacate(*table, size, index);
+
+    // Release whatever the entry holds now, rather than whenever the bucket happens to be reused
+    table->clearEntry(index);
+
+    elementCount -= 1;
+    migrateBuckets(migrationStep);
+    shrinkIfSparse();
+
+    return true;
 }
 
 /**
  * Clears the hash table of all keys and values.
  */
-template<typename KeyType, typename ValueType>
-void HashTable<KeyType, ValueType>::clear() {
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+void HashTable<KeyType, ValueType, H, Policy>::clear() {
+    for (unsigned int i = oldTable.nextOccupied(0, oldTableSize); i < oldTableSize;
+         i = oldTable.nextOccupied(i + 1, oldTableSize)) {
+        oldTable.clearEntry(i);
+    }
+
     for (unsigned int i = 0; i < tableSize; ++i) {
+        if (hashTable[i].occupied) hashTable.clearEntry(i);
+
         hashTable[i].occupied = false;
+        hashTable[i].hopInfo = 0;
     }
+
+    oldTable.release();
+    oldTableSize = 0;
+    migrationIndex = 0;
+    elementCount = 0;
+}
+
+/**
+ * Grows the hash table so that it can hold the given number of items without rehashing. Does nothing if the table is
+ * already big enough.
+ *
+ * @param count The number of items the hash table should be able to hold
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+void HashTable<KeyType, ValueType, H, Policy>::reserve(const unsigned int count) {
+    // Insertion rehashes once the load factor reaches the threshold, so count - 1 items must stay below it
+    const unsigned int requiredSize = IndexMapping::tableSize(static_cast<unsigned int>(count / loadFactorThreshold) + 1);
+
+    if (requiredSize > tableSize) rebuild(requiredSize);
+}
+
+/**
+ * Rebuilds the hash table to the smallest size that holds its items below the given load factor, whether that shrinks
+ * or grows it. Unlike the automatic shrinking on removal, compacting may go below the initial size. Any incremental
+ * rehash in progress is finished along the way.
+ *
+ * @param targetLoadFactor The load factor to rebuild to, capped at the max load factor
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+void HashTable<KeyType, ValueType, H, Policy>::compact(const double targetLoadFactor) {
+    const double target = targetLoadFactor > 0 && targetLoadFactor < loadFactorThreshold
+                              ? targetLoadFactor
+                              : loadFactorThreshold;
+
+    resize(IndexMapping::tableSize(static_cast<unsigned int>(elementCount / target) + 1));
 }
 
 /**
@@ -261,75 +778,622 @@ void HashTable<KeyType, ValueType>::clear() {
  *
  * @return The number of items in the hash table.
  */
-template<typename KeyType, typename ValueType>
-unsigned int HashTable<KeyType, ValueType>::size() const {
-    unsigned int count = 0;
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+unsigned int HashTable<KeyType, ValueType, H, Policy>::size() const {
+    return elementCount;
+}
 
-    for (unsigned int i = 0; i < tableSize; ++i) {
-        if (hashTable[i].occupied) count += 1;
+/**
+ * Calculates the hash table's load factor.
+ * @return The hash table's load factor
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+double HashTable<KeyType, ValueType, H, Policy>::loadFactor() const {
+    double count = size();
+
+    return count / tableSize;
+}
+
+/**
+ * Returns a snapshot of the hash table's occupancy and maintenance counters. Building the probe length histogram walks
+ * every neighbourhood bitmap, so this is meant for monitoring rather than for hot paths.
+ *
+ * @return The hash table's statistics
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+HashTableStats HashTable<KeyType, ValueType, H, Policy>::stats() const {
+    HashTableStats tableStats;
+
+    tableStats.probeLengthHistogram.assign(neighbourhoodSize(), 0);
+
+    for (const auto &table: {std::make_pair(&hashTable, tableSize), std::make_pair(&oldTable, oldTableSize)}) {
+        for (unsigned int i = 0; i < table.second; ++i) {
+            std::uint64_t hopInfo = (*table.first)[i].hopInfo;
+
+            while (hopInfo != 0) {
+                const unsigned int distance = lowestSetBit(hopInfo);
+
+                if (distance >= tableStats.probeLengthHistogram.size()) {
+                    tableStats.probeLengthHistogram.resize(distance + 1, 0);
+                }
+
+                tableStats.probeLengthHistogram[distance] += 1;
+                hopInfo &= hopInfo - 1;
+            }
+        }
     }
 
-    return count;
+    tableStats.displacements = displacementCount;
+    tableStats.rehashCount = rehashCount;
+    tableStats.shrinkCount = shrinkCount;
+    tableStats.rehashTime = rehashTime;
+    tableStats.bytesUsed = sizeof(*this) + hashTable.bytesUsed() + oldTable.bytesUsed() + hashTable.storageBytesUsed();
+    tableStats.size = elementCount;
+    tableStats.tableSize = tableSize;
+    tableStats.loadFactor = loadFactor();
+
+    return tableStats;
 }
 
-template<typename KeyType, typename ValueType>
-double HashTable<KeyType, ValueType>::loadFactor() const {
-    double count = size();
+/**
+ * Enables or disables incremental rehashing. When enabled, growing the table only allocates the new bucket array; the
+ * entries are then migrated a few buckets at a time by later insertions and removals, while lookups check both arrays.
+ * This bounds the latency of the insertion that triggers the growth.
+ *
+ * @param enabled Whether rehashing should be incremental
+ * @param bucketsPerStep The number of old buckets to migrate on each insertion or removal (at least 2)
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+void HashTable<KeyType, ValueType, H, Policy>::setIncrementalRehash(const bool enabled,
+                                                                   const unsigned int bucketsPerStep) {
+    // With doubling growth and at least 2 buckets per step, a migration always completes before the new table reaches
+    // its threshold; slower growth policies may have to finish a migration early
+    migrationStep = bucketsPerStep < 2 ? 2 : bucketsPerStep;
+    incrementalRehash = enabled;
 
-    return count / tableSize;
+    if (!enabled) migrateBuckets(oldTableSize);
 }
 
 /**
- * Finds the first free slot in the given hash table.
+ * Returns whether an incremental rehash is in progress, i.e. whether some entries still live in the old table.
+ *
+ * @return Whether an incremental rehash is in progress
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+bool HashTable<KeyType, ValueType, H, Policy>::isRehashing() const {
+    return oldTableSize > 0;
+}
+
+/**
+ * Sets the load factor below which a removal shrinks the table. A shrink rebuilds the table at half the max load factor,
+ * so the threshold must stay well below that for a shrink to be followed by neither a growth nor another shrink until
+ * many more insertions or removals have happened. Defaults to a quarter of the max load factor.
+ *
+ * @param threshold The load factor to shrink below, or 0 to never shrink automatically
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+void HashTable<KeyType, ValueType, H, Policy>::setShrinkThreshold(const double threshold) {
+    // Anything from half the max load factor up would shrink straight back into the range that triggers a shrink
+    shrinkThreshold = threshold < loadFactorThreshold / 2 ? threshold : loadFactorThreshold / 4;
+}
+
+/**
+ * Finds the first free slot in the given hash table by probing linearly from the start index.
  *
  * @param cTable The hash table to find a free slot in
  * @param startIndex The starting index to start the search from
- * @param currentHop The current hop (offset)
- * @return The index of the empty slot
+ * @param currentHop The current hop (offset); set to the distance of the free slot from the start index
+ * @return The index of the empty slot, or -1 if the hash table has no free slot
  */
-template<typename KeyType, typename ValueType>
-unsigned int HashTable<KeyType, ValueType>::findFreeSlot(
-    std::vector<Bucket> &cTable,
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+int HashTable<KeyType, ValueType, H, Policy>::findFreeSlot(
+    Buckets &cTable,
     unsigned int startIndex,
     unsigned int &currentHop
 ) {
-    unsigned int currentIndex = (startIndex + currentHop) % tableSize;
+    while (currentHop < tableSize) {
+        const unsigned int currentIndex = wrapIndex(startIndex + currentHop, tableSize);
 
-    while (currentIndex != startIndex) {
-        if (!cTable[currentIndex].occupied) return currentIndex;
+        if (!cTable[currentIndex].occupied) return static_cast<int>(currentIndex);
 
-        currentIndex = (currentIndex + 1) % tableSize;
+        currentHop += 1;
     }
 
-    throw std::runtime_error("No free slot found");
+    return -1;
 }
 
 /**
  * Rehashes by:
- * 1. Building another table that is twice as big
+ * 1. Building another table that is bigger, as picked by the growth policy (twice as big by default)
  * 2. Scanning down the entire original hash table
- * 3. For each (non-deleted) item, computing the new hash value and inserting it in the new table
+ * 3. For each (non-deleted) item, computing the new home bucket from its stored hash and inserting it in the new table
+ * In incremental mode, only the first step happens here and the scan is spread over later insertions and removals.
  */
-template<typename KeyType, typename ValueType>
-void HashTable<KeyType, ValueType>::rehash() {
-    const int oldTableSize = tableSize;
-    const int newTableSize = tableSize * 2;
-    // 1. Build another table that is twice as big
-    std::vector<Bucket> newTable(newTableSize);
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+void HashTable<KeyType, ValueType, H, Policy>::rehash() {
+    const auto start = std::chrono::steady_clock::now();
 
-    // 2. Scan down the entire original hash table
-    std::vector<Bucket> oldTable(oldTableSize);
+    // A table can only be migrating into one new table at a time
+    migrateBuckets(oldTableSize);
 
-    for (unsigned int i = 0; i < oldTableSize; ++i) {
-        oldTable[i] = hashTable[i];
+    if (incrementalRehash && oldTableSize == 0) {
+        // 1. Build another, bigger table, keeping the original one live until it has been migrated
+        oldTable.swap(hashTable);
+        oldTableSize = tableSize;
+        migrationIndex = 0;
+        tableSize = grownSize(tableSize);
+        hashTable.assign(tableSize);
+    } else {
+        rebuild(grownSize(tableSize));
     }
 
-    // 3. For each (non-deleted) item, compute the new hash value and insert it in the new table
-    tableSize = newTableSize;
-    // Update the hash table to the new one
-    hashTable = newTable;
+    rehashCount += 1;
+    rehashTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+}
+
+/**
+ * Moves every entry of the table (including the ones still waiting in the old table) into a new bucket array of at
+ * least the given size, growing it further in the unlikely case that a neighbourhood overflows. Entries are moved
+ * rather than copied, and with out-of-line values only their handles move.
+ *
+ * @param newTableSize The size of the new bucket array
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+void HashTable<KeyType, ValueType, H, Policy>::rebuild(unsigned int newTableSize) {
+    // 2. Scan down the entire original hash table, and the old table of an incremental rehash
+    std::vector<std::pair<Buckets, unsigned int>> sources(2);
+    sources[0].first.swap(hashTable);
+    sources[0].second = tableSize;
+    sources[1].first.swap(oldTable);
+    sources[1].second = oldTableSize;
+    oldTableSize = 0;
+    migrationIndex = 0;
+
+    bool placedAll = false;
+
+    while (!placedAll) {
+        // 1. Build another, bigger table
+        tableSize = newTableSize;
+        hashTable.assign(newTableSize);
+        elementCount = 0;
+        placedAll = true;
+
+        // 3. For each (non-deleted) item, compute the new home bucket from the stored hash (the key itself is neither
+        // hashed nor compared) and move it to the new table
+        for (std::pair<Buckets, unsigned int> &source: sources) {
+            Buckets &table = source.first;
+
+            for (unsigned int i = table.nextOccupied(0, source.second); i < source.second;
+                 i = table.nextOccupied(i + 1, source.second)) {
+                const int index = claim(table[i].hash);
+
+                if (index < 0) {
+                    placedAll = false;
+                    break;
+                }
+
+                hashTable.transfer(index, table, i);
+                table[i].occupied = false;
+            }
+
+            if (!placedAll) break;
+        }
 
-    for (unsigned int i = 0; i < oldTableSize; ++i) {
-        if (oldTable[i].occupied) insert(oldTable[i].key, oldTable[i].value);
+        // In the unlikely case that a neighbourhood overflows in the new table, the entries moved so far are scanned
+        // again from there, and everything goes into a bigger table
+        if (!placedAll) {
+            sources.emplace_back();
+            sources.back().first.swap(hashTable);
+            sources.back().second = tableSize;
+            newTableSize = grownSize(newTableSize);
+        }
     }
 }
+
+/**
+ * Rebuilds the table at the given size and adds the time it took to the rehash time.
+ *
+ * @param newTableSize The size of the new bucket array
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+void HashTable<KeyType, ValueType, H, Policy>::resize(const unsigned int newTableSize) {
+    const auto start = std::chrono::steady_clock::now();
+
+    rebuild(newTableSize);
+
+    rehashTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+}
+
+/**
+ * Shrinks the table to half the max load factor once a removal brings its load factor below the shrink threshold. The
+ * table never shrinks below its initial size, nor while an incremental rehash is in progress; the next removal after
+ * the migration finishes shrinks it instead.
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+void HashTable<KeyType, ValueType, H, Policy>::shrinkIfSparse() {
+    if (oldTableSize > 0 || tableSize <= minimumTableSize || loadFactor() >= shrinkThreshold) return;
+
+    unsigned int newTableSize = IndexMapping::tableSize(
+        static_cast<unsigned int>(elementCount / (loadFactorThreshold / 2)) + 1);
+
+    if (newTableSize < minimumTableSize) newTableSize = minimumTableSize;
+
+    if (newTableSize >= tableSize) return;
+
+    resize(newTableSize);
+    shrinkCount += 1;
+}
+
+/**
+ * Migrates up to the given number of buckets from the old table into the new one, and releases the old table once
+ * every bucket has been migrated. Does nothing when no incremental rehash is in progress.
+ *
+ * @param count The maximum number of old buckets to migrate
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+void HashTable<KeyType, ValueType, H, Policy>::migrateBuckets(const unsigned int count) {
+    if (oldTableSize == 0) return;
+
+    const auto start = std::chrono::steady_clock::now();
+    const unsigned int lastIndex = oldTableSize - migrationIndex < count ? oldTableSize : migrationIndex + count;
+
+    for (; migrationIndex < lastIndex; ++migrationIndex) {
+        const typename Buckets::Ref bucket = oldTable[migrationIndex];
+
+        if (!bucket.occupied) continue;
+
+        // The entry is counted again once it is placed in the new table
+        elementCount -= 1;
+
+        const int index = claim(bucket.hash);
+
+        if (index < 0) {
+            // The new table's neighbourhood overflowed: fall back to moving everything into a bigger table at once
+            elementCount += 1;
+            rebuild(grownSize(tableSize));
+            break;
+        }
+
+        hashTable.transfer(index, oldTable, migrationIndex);
+        vacate(oldTable, oldTableSize, migrationIndex);
+    }
+
+    if (oldTableSize > 0 && migrationIndex == oldTableSize) {
+        oldTable.release();
+        oldTableSize = 0;
+        migrationIndex = 0;
+    }
+
+    rehashTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+}
+
+/**
+ * Returns the number of buckets in a neighbourhood, which cannot exceed the number of buckets in the table.
+ *
+ * @return The number of buckets in a neighbourhood
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+unsigned int HashTable<KeyType, ValueType, H, Policy>::neighbourhoodSize() const {
+    return tableSize < HOP_RANGE ? tableSize : HOP_RANGE;
+}
+
+/**
+ * Returns the table size that comes after the given one, as picked by the growth policy and adjusted by the index
+ * mapping.
+ *
+ * @param size The current table size
+ * @return The next table size
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+unsigned int HashTable<KeyType, ValueType, H, Policy>::grownSize(const unsigned int size) const {
+    return IndexMapping::tableSize(GrowthPolicy::nextSize(size));
+}
+
+/**
+ * Returns the index of the bucket holding the given key in the given bucket array. Only the buckets flagged in the home
+ * bucket's neighbourhood bitmap are compared.
+ *
+ * @param table The bucket array to search
+ * @param size The number of buckets in the array
+ * @param key The key (or a view of it) to search for
+ * @return The index of the bucket holding the key, or -1 if the key does not exist
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename LookupKey>
+int HashTable<KeyType, ValueType, H, Policy>::findIndex(
+    const Buckets &table,
+    const unsigned int size,
+    const LookupKey &key
+) const {
+    return findIndex(table, size, key, Hasher{}(key));
+}
+
+/**
+ * Returns the index of the bucket holding the given key in the given bucket array, given the key's hash. Keys are only
+ * compared in the buckets whose stored hash equals the key's hash, so long keys are almost never read on a miss.
+ *
+ * @param table The bucket array to search
+ * @param size The number of buckets in the array
+ * @param key The key (or a view of it) to search for
+ * @param hash The hash of the key
+ * @return The index of the bucket holding the key, or -1 if the key does not exist
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename LookupKey>
+int HashTable<KeyType, ValueType, H, Policy>::findIndex(
+    const Buckets &table,
+    const unsigned int size,
+    const LookupKey &key,
+    const size_t hash
+) const {
+    return findIndex(table, size, key, hash, IndexMapping::index(hash, size));
+}
+
+/**
+ * Returns the index of the bucket holding the given key in the given bucket array, given the key's hash and its home
+ * bucket in that array.
+ *
+ * @param table The bucket array to search
+ * @param size The number of buckets in the array
+ * @param key The key (or a view of it) to search for
+ * @param hash The hash of the key
+ * @param home The home bucket of the key
+ * @return The index of the bucket holding the key, or -1 if the key does not exist
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename LookupKey>
+int HashTable<KeyType, ValueType, H, Policy>::findIndex(
+    const Buckets &table,
+    const unsigned int size,
+    const LookupKey &key,
+    const size_t hash,
+    const unsigned int home
+) const {
+    std::uint64_t hopInfo = table[home].hopInfo;
+
+    while (hopInfo != 0) {
+        const unsigned int index = wrapIndex(home + lowestSetBit(hopInfo), size);
+
+        // Keys are only compared when their full hashes match
+        if (table[index].hash == hash && KeyEqual{}(table[index].key, key)) return static_cast<int>(index);
+
+        // Clear the lowest set bit
+        hopInfo &= hopInfo - 1;
+    }
+
+    return -1;
+}
+
+/**
+ * Returns the value of the given key, looking in the old table as well while an incremental rehash is in progress.
+ *
+ * @param key The key (or a view of it) to search for
+ * @return The value of the key, or nullptr if the key does not exist
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename LookupKey>
+ValueType *HashTable<KeyType, ValueType, H, Policy>::findValue(const LookupKey &key) {
+    return findValue(key, Hasher{}(key));
+}
+
+/**
+ * Returns the value of the given key, given the key's hash, so that both tables are searched with a single hash.
+ *
+ * @param key The key (or a view of it) to search for
+ * @param hash The hash of the key
+ * @return The value of the key, or nullptr if the key does not exist
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename LookupKey>
+ValueType *HashTable<KeyType, ValueType, H, Policy>::findValue(const LookupKey &key, const size_t hash) {
+    int index = findIndex(hashTable, tableSize, key, hash);
+
+    if (index >= 0) return &hashTable[index].value;
+    if (oldTableSize == 0) return nullptr;
+
+    index = findIndex(oldTable, oldTableSize, key, hash);
+
+    return index >= 0 ? &oldTable[index].value : nullptr;
+}
+
+/**
+ * Returns the value of the given key, placing the key with the value returned by makeValue first if it does not exist
+ * yet. The key is hashed once and its neighbourhood probed once; only a rehash triggered by the insertion makes the key
+ * look for a free bucket again. During an incremental rehash, every insertion also migrates a bounded number of
+ * buckets from the old table.
+ *
+ * @param key The key (or a view of it) to find or insert
+ * @param makeValue Returns the value to insert; only called if the key does not exist
+ * @return The value of the key, and whether the key was inserted
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename LookupKey, typename MakeValue>
+std::pair<ValueType &, bool> HashTable<KeyType, ValueType, H, Policy>::findOrPlace(const LookupKey &key,
+                                                                                  MakeValue &&makeValue) {
+    const size_t hash = Hasher{}(key);
+    ValueType *value = findValue(key, hash);
+
+    if (value != nullptr) return {*value, false};
+
+    // The key is absent from both tables, so migrating buckets cannot move it
+    migrateBuckets(migrationStep);
+
+    // If the load factor threshold is exceeded, rehash before insertion
+    if (loadFactor() >= loadFactorThreshold) rehash();
+
+    KeyType newKey(key);
+    // Bind the value to a reference: makeValue may return a reference to a value owned by the caller
+    auto &&newValue = makeValue();
+    int index = place(hash, std::move(newKey), std::forward<decltype(newValue)>(newValue));
+
+    // If the key's neighbourhood cannot take the key, rehash and retry insertion
+    while (index < 0) {
+        rehash();
+        index = place(hash, std::move(newKey), std::forward<decltype(newValue)>(newValue));
+    }
+
+    return {hashTable[index].value, true};
+}
+
+/**
+ * Places the given entries of a bulk build, which are sorted by home bucket, into the buckets before the given limit.
+ * Entries whose free bucket is outside their neighbourhood or past the limit are left for the caller, so that threads
+ * working on different blocks of buckets never touch the same bucket. The element count is left to the caller too.
+ *
+ * @param entries The entries of the bulk build, sorted by home bucket
+ * @param first The index of the first entry to place
+ * @param last The index past the last entry to place
+ * @param limit The index past the last bucket that may be written
+ * @param deferred Receives the entries that could not be placed
+ * @return The number of entries placed
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename Entry>
+unsigned int HashTable<KeyType, ValueType, H, Policy>::placeSorted(
+    const std::vector<BulkEntry<Entry>> &entries,
+    const size_t first,
+    const size_t last,
+    const unsigned int limit,
+    std::vector<const BulkEntry<Entry> *> &deferred
+) {
+    unsigned int placed = 0;
+
+    for (size_t i = first; i < last; ++i) {
+        const BulkEntry<Entry> &entry = entries[i];
+
+        // A key that appeared earlier in the range keeps its first value
+        if (findIndex(hashTable, tableSize, entry.entry->first, entry.hash) >= 0) continue;
+
+        unsigned int distance = 0;
+
+        while (distance < neighbourhoodSize() && entry.home + distance < limit &&
+               hashTable[entry.home + distance].occupied) {
+            distance += 1;
+        }
+
+        if (distance == neighbourhoodSize() || entry.home + distance >= limit) {
+            deferred.push_back(&entry);
+            continue;
+        }
+
+        hashTable[entry.home + distance].hash = entry.hash;
+        hashTable[entry.home + distance].key = entry.entry->first;
+        hashTable.setValue(entry.home + distance, entry.entry->second);
+        hashTable[entry.home + distance].occupied = true;
+        hashTable[entry.home].hopInfo |= static_cast<HopBitmap>(1) << distance;
+        placed += 1;
+    }
+
+    return placed;
+}
+
+/**
+ * Empties the given bucket and removes it from its home bucket's neighbourhood bitmap.
+ *
+ * @param table The bucket array the bucket belongs to
+ * @param size The number of buckets in the array
+ * @param index The index of the bucket to empty
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+void HashTable<KeyType, ValueType, H, Policy>::vacate(Buckets &table, const unsigned int size,
+                                                      const unsigned int index) {
+    const unsigned int home = IndexMapping::index(table[index].hash, size);
+    const unsigned int distance = index >= home ? index - home : index + size - home;
+
+    table[index].occupied = false;
+    table[home].hopInfo &= ~(static_cast<HopBitmap>(1) << distance);
+}
+
+/**
+ * Places a key that does not exist in the table yet inside its home neighbourhood, moving the closest free bucket into
+ * the neighbourhood if needed. The key and value are only moved from once the key has been placed, so a failed
+ * placement can be retried with the same arguments after a rehash.
+ *
+ * @param hash The hash of the key
+ * @param key The key to place
+ * @param value The value to place
+ * @return The index of the bucket the key was placed in, or -1 if the table must be rehashed
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+template<typename Key, typename Value>
+int HashTable<KeyType, ValueType, H, Policy>::place(const size_t hash, Key &&key, Value &&value) {
+    const int index = claim(hash);
+
+    if (index < 0) return -1;
+
+    hashTable[index].key = std::forward<Key>(key);
+    hashTable.setValue(index, std::forward<Value>(value));
+
+    return index;
+}
+
+/**
+ * Claims a free bucket inside the home neighbourhood of a key with the given hash, moving the closest free bucket into
+ * the neighbourhood if needed. The bucket is marked occupied and counted, and gets the hash; the caller fills in the
+ * key and value.
+ *
+ * @param hash The hash of the key
+ * @return The index of the claimed bucket, or -1 if the table must be rehashed
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+int HashTable<KeyType, ValueType, H, Policy>::claim(const size_t hash) {
+    const unsigned int home = IndexMapping::index(hash, tableSize);
+    unsigned int distance = 0;
+    const int freeSlot = findFreeSlot(hashTable, home, distance);
+
+    // The hash table is full
+    if (freeSlot < 0) return -1;
+
+    unsigned int freeIndex = static_cast<unsigned int>(freeSlot);
+
+    // If the free bucket is outside the key's home neighbourhood, we should try to shift it into the neighbourhood
+    while (distance >= neighbourhoodSize()) {
+        if (!moveFreeSlotCloser(freeIndex, distance)) return -1;
+    }
+
+    hashTable[freeIndex].hash = hash;
+    hashTable[freeIndex].occupied = true;
+    hashTable[home].hopInfo |= static_cast<HopBitmap>(1) << distance;
+    elementCount += 1;
+
+    return static_cast<int>(freeIndex);
+}
+
+/**
+ * Moves the free bucket closer to the home bucket by swapping it with an earlier entry that can still reach the free
+ * bucket from its own home bucket.
+ *
+ * @param freeIndex The index of the free bucket; updated to the index of the bucket that was vacated
+ * @param distance The distance of the free bucket from the home bucket; updated accordingly
+ * @return Whether an entry could be moved
+ */
+template<typename KeyType, typename ValueType, unsigned int H, typename Policy>
+bool HashTable<KeyType, ValueType, H, Policy>::moveFreeSlotCloser(unsigned int &freeIndex, unsigned int &distance) {
+    // Look at the home buckets from the furthest one that can still reach the free bucket
+    for (unsigned int homeDistance = neighbourhoodSize() - 1; homeDistance > 0; --homeDistance) {
+        const unsigned int candidateHome = wrapIndex(freeIndex + tableSize - homeDistance, tableSize);
+        const HopBitmap hopInfo = hashTable[candidateHome].hopInfo;
+
+        // Only the entries placed before the free bucket can move forward into it
+        const HopBitmap movable = hopInfo & ((static_cast<HopBitmap>(1) << homeDistance) - 1);
+
+        if (movable == 0) continue;
+
+        const unsigned int entryDistance = lowestSetBit(movable);
+        const unsigned int entryIndex = wrapIndex(candidateHome + entryDistance, tableSize);
+
+        hashTable.transfer(freeIndex, hashTable, entryIndex);
+        hashTable[freeIndex].occupied = true;
+        hashTable[entryIndex].occupied = false;
+        hashTable[candidateHome].hopInfo = (hopInfo & ~(static_cast<HopBitmap>(1) << entryDistance)) |
+                                           (static_cast<HopBitmap>(1) << homeDistance);
+
+        distance -= homeDistance - entryDistance;
+        freeIndex = entryIndex;
+        displacementCount += 1;
+
+        return true;
+    }
+
+    return false;
+}
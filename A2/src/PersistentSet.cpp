@@ -0,0 +1,470 @@
+#include "../include/PersistentSet.h"
+
+template<typename Key>
+constexpr size_t PersistentSet<Key>::DELTA;
+
+template<typename Key>
+constexpr size_t PersistentSet<Key>::RATIO;
+
+/**
+ * Constructor
+ */
+template<typename Key>
+PersistentSet<Key>::PersistentSet() : root(nullptr) {
+}
+
+/**
+ * Destructor. Releases the set's reference to its root; nodes still reached by other sets are kept.
+ */
+template<typename Key>
+PersistentSet<Key>::~PersistentSet() {
+    release(root);
+}
+
+/**
+ * Copy constructor. Shares the other set's nodes, in O(1).
+ *
+ * @param other The set to copy
+ */
+template<typename Key>
+PersistentSet<Key>::PersistentSet(const PersistentSet &other) : root(retain(other.root)) {
+}
+
+/**
+ * Move constructor. Takes the other set's root, leaving the other set empty.
+ *
+ * @param other The set to move from
+ */
+template<typename Key>
+PersistentSet<Key>::PersistentSet(PersistentSet &&other) noexcept : root(other.root) {
+    other.root = nullptr;
+}
+
+/**
+ * Copy assignment. Shares the other set's nodes and releases this set's old ones.
+ *
+ * @param other The set to copy
+ * @return This set
+ */
+template<typename Key>
+PersistentSet<Key> &PersistentSet<Key>::operator=(const PersistentSet &other) {
+    PersistentNode<Key> *oldRoot = root;
+    root = retain(other.root);
+    release(oldRoot);
+
+    return *this;
+}
+
+/**
+ * Move assignment. Swaps the roots of the two sets, so the other set releases this set's old nodes.
+ *
+ * @param other The set to move from
+ * @return This set
+ */
+template<typename Key>
+PersistentSet<Key> &PersistentSet<Key>::operator=(PersistentSet &&other) noexcept {
+    std::swap(root, other.root);
+
+    return *this;
+}
+
+/**
+ * Returns the beginning of the set. The iterator stays valid while the set, or a copy of it, is not changed.
+ *
+ * @return The beginning of the set
+ */
+template<typename Key>
+typename PersistentSet<Key>::Iterator PersistentSet<Key>::begin() const {
+    return Iterator(root);
+}
+
+/**
+ * Returns the end of the set.
+ *
+ * @return The end of the set
+ */
+template<typename Key>
+typename PersistentSet<Key>::Iterator PersistentSet<Key>::end() const {
+    return Iterator(nullptr);
+}
+
+/**
+ * Inserts the provided key into the set, copying the nodes on the path to it. Insertion fails if the key already
+ * exists, and then nothing is copied.
+ *
+ * @param key The key to insert
+ * @return Whether the insertion was successful
+ */
+template<typename Key>
+bool PersistentSet<Key>::insert(const Key &key) {
+    PersistentNode<Key> *newRoot = insertInto(root, key);
+
+    if (newRoot == nullptr) return false;
+
+    release(root);
+    root = newRoot;
+
+    return true;
+}
+
+/**
+ * Searches for the given key.
+ *
+ * @param key The key to search for
+ * @return Whether the key exists
+ */
+template<typename Key>
+bool PersistentSet<Key>::search(const Key &key) const {
+    const PersistentNode<Key> *current = root;
+
+    while (current != nullptr) {
+        if (key < current->key) {
+            current = current->left;
+        } else if (current->key < key) {
+            current = current->right;
+        } else {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Erases the given key, copying the nodes on the path to it.
+ *
+ * @param key Key to erase
+ * @return Whether the erase was successful
+ */
+template<typename Key>
+bool PersistentSet<Key>::erase(const Key &key) {
+    bool erased = false;
+    PersistentNode<Key> *newRoot = eraseFrom(root, key, erased);
+
+    if (!erased) return false;
+
+    release(root);
+    root = newRoot;
+
+    return true;
+}
+
+/**
+ * Clears the set of all keys. Only the nodes that no other set reaches are deleted.
+ */
+template<typename Key>
+void PersistentSet<Key>::clear() {
+    release(root);
+    root = nullptr;
+}
+
+/**
+ * Returns the number of keys in the set.
+ *
+ * @return The number of keys in the set
+ */
+template<typename Key>
+size_t PersistentSet<Key>::size() const {
+    return getSize(root);
+}
+
+/**
+ * Returns the number of keys of the set less than the given key, which is the key's position if the keys were listed
+ * in sorted order.
+ *
+ * @param key The key to rank
+ * @return The number of keys less than the key
+ */
+template<typename Key>
+size_t PersistentSet<Key>::rank(const Key &key) const {
+    const PersistentNode<Key> *current = root;
+    size_t count = 0;
+
+    while (current != nullptr) {
+        if (current->key < key) {
+            count += getSize(current->left) + 1;
+            current = current->right;
+        } else {
+            current = current->left;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Returns the key at the given position in sorted order.
+ *
+ * @param index The position of the key, from 0 for the smallest key
+ * @return The key at the position
+ * @throws std::out_of_range If the set has no more than index keys
+ */
+template<typename Key>
+const Key &PersistentSet<Key>::select(size_t index) const {
+    if (index >= size()) throw std::out_of_range("PersistentSet::select index is out of range");
+
+    const PersistentNode<Key> *current = root;
+
+    while (true) {
+        const size_t leftSize = getSize(current->left);
+
+        if (index == leftSize) return current->key;
+
+        if (index < leftSize) {
+            current = current->left;
+        } else {
+            index -= leftSize + 1;
+            current = current->right;
+        }
+    }
+}
+
+/**
+ * Returns an immutable view of the set as it is now, in O(1). Later changes to this set do not show in the snapshot.
+ *
+ * @return A snapshot of the set
+ */
+template<typename Key>
+PersistentSet<Key> PersistentSet<Key>::snapshot() const {
+    return PersistentSet(*this);
+}
+
+/**
+ * Takes another reference to the given node.
+ *
+ * @param node The node to reference, or nullptr
+ * @return The node
+ */
+template<typename Key>
+PersistentNode<Key> *PersistentSet<Key>::retain(PersistentNode<Key> *node) {
+    if (node != nullptr) node->references.fetch_add(1, std::memory_order_relaxed);
+
+    return node;
+}
+
+/**
+ * Drops a reference to the given node, deleting it and releasing its children if it was the last one.
+ *
+ * @param node The node to release, or nullptr
+ */
+template<typename Key>
+void PersistentSet<Key>::release(PersistentNode<Key> *node) {
+    if (node == nullptr || node->references.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+    release(node->left);
+    release(node->right);
+    delete node;
+}
+
+/**
+ * Returns the size of the subtree rooted at the given node.
+ *
+ * @param node The root node of the subtree
+ * @return The size of the subtree rooted at the given node
+ */
+template<typename Key>
+size_t PersistentSet<Key>::getSize(const PersistentNode<Key> *node) {
+    return node == nullptr ? 0 : node->size;
+}
+
+/**
+ * Builds a node over the given children, taking over their references.
+ *
+ * @param key The key of the node
+ * @param left The left child
+ * @param right The right child
+ * @return The new node
+ */
+template<typename Key>
+PersistentNode<Key> *PersistentSet<Key>::makeNode(const Key &key, PersistentNode<Key> *left,
+                                                  PersistentNode<Key> *right) {
+    return new PersistentNode<Key>(key, left, right);
+}
+
+/**
+ * Builds a node over the given children, rotating if one child outweighs the other after a single insertion or
+ * erasure below it.
+ *
+ * @param key The key of the node
+ * @param left The left child
+ * @param right The right child
+ * @return The root of the balanced subtree
+ */
+template<typename Key>
+PersistentNode<Key> *PersistentSet<Key>::balance(const Key &key, PersistentNode<Key> *left,
+                                                 PersistentNode<Key> *right) {
+    if (DELTA * (getSize(left) + 1) < getSize(right) + 1) return rotateLeft(key, left, right);
+
+    if (DELTA * (getSize(right) + 1) < getSize(left) + 1) return rotateRight(key, left, right);
+
+    return makeNode(key, left, right);
+}
+
+/**
+ * Lifts the right child, or its left child if that one is the heavier, above the new node. Only the right child is
+ * copied; its children are shared.
+ *
+ * @param key The key of the node
+ * @param left The left child
+ * @param right The right child, which outweighs the left child
+ * @return The root of the rotated subtree
+ */
+template<typename Key>
+PersistentNode<Key> *PersistentSet<Key>::rotateLeft(const Key &key, PersistentNode<Key> *left,
+                                                    PersistentNode<Key> *right) {
+    PersistentNode<Key> *inner = right->left;
+    PersistentNode<Key> *outer = right->right;
+    PersistentNode<Key> *rotated;
+
+    if (getSize(inner) + 1 < RATIO * (getSize(outer) + 1)) {
+        rotated = makeNode(right->key, makeNode(key, left, retain(inner)), retain(outer));
+    } else {
+        rotated = makeNode(inner->key, makeNode(key, left, retain(inner->left)),
+                           makeNode(right->key, retain(inner->right), retain(outer)));
+    }
+    release(right);
+
+    return rotated;
+}
+
+/**
+ * Lifts the left child, or its right child if that one is the heavier, above the new node. Only the left child is
+ * copied; its children are shared.
+ *
+ * @param key The key of the node
+ * @param left The left child, which outweighs the right child
+ * @param right The right child
+ * @return The root of the rotated subtree
+ */
+template<typename Key>
+PersistentNode<Key> *PersistentSet<Key>::rotateRight(const Key &key, PersistentNode<Key> *left,
+                                                     PersistentNode<Key> *right) {
+    PersistentNode<Key> *inner = left->right;
+    PersistentNode<Key> *outer = left->left;
+    PersistentNode<Key> *rotated;
+
+    if (getSize(inner) + 1 < RATIO * (getSize(outer) + 1)) {
+        rotated = makeNode(left->key, retain(outer), makeNode(key, retain(inner), right));
+    } else {
+        rotated = makeNode(inner->key, makeNode(left->key, retain(outer), retain(inner->left)),
+                           makeNode(key, retain(inner->right), right));
+    }
+    release(left);
+
+    return rotated;
+}
+
+/**
+ * Builds a copy of the subtree rooted at the given node, which it borrows, with the key inserted.
+ *
+ * @param node The root of the subtree
+ * @param key The key to insert
+ * @return The root of the new subtree, or nullptr if the key already exists
+ */
+template<typename Key>
+PersistentNode<Key> *PersistentSet<Key>::insertInto(PersistentNode<Key> *node, const Key &key) {
+    if (node == nullptr) return makeNode(key, nullptr, nullptr);
+
+    if (key < node->key) {
+        PersistentNode<Key> *left = insertInto(node->left, key);
+
+        return left == nullptr ? nullptr : balance(node->key, left, retain(node->right));
+    }
+
+    if (node->key < key) {
+        PersistentNode<Key> *right = insertInto(node->right, key);
+
+        return right == nullptr ? nullptr : balance(node->key, retain(node->left), right);
+    }
+
+    return nullptr;
+}
+
+/**
+ * Builds a copy of the subtree rooted at the given node, which it borrows, with the key erased.
+ *
+ * @param node The root of the subtree
+ * @param key The key to erase
+ * @param erased Set to whether the key was found
+ * @return The root of the new subtree, or nullptr if the key was not found
+ */
+template<typename Key>
+PersistentNode<Key> *PersistentSet<Key>::eraseFrom(PersistentNode<Key> *node, const Key &key, bool &erased) {
+    if (node == nullptr) {
+        erased = false;
+        return nullptr;
+    }
+
+    if (key < node->key) {
+        PersistentNode<Key> *left = eraseFrom(node->left, key, erased);
+
+        return erased ? balance(node->key, left, retain(node->right)) : nullptr;
+    }
+
+    if (node->key < key) {
+        PersistentNode<Key> *right = eraseFrom(node->right, key, erased);
+
+        return erased ? balance(node->key, retain(node->left), right) : nullptr;
+    }
+
+    erased = true;
+
+    return join(node->left, node->right);
+}
+
+/**
+ * Joins two subtrees, which it borrows, whose keys are all ordered and whose weights are balanced, by lifting the
+ * nearest key of the heavier one to their root.
+ *
+ * @param left The subtree of smaller keys
+ * @param right The subtree of larger keys
+ * @return The root of the joined subtree
+ */
+template<typename Key>
+PersistentNode<Key> *PersistentSet<Key>::join(PersistentNode<Key> *left, PersistentNode<Key> *right) {
+    if (left == nullptr) return retain(right);
+
+    if (right == nullptr) return retain(left);
+
+    if (left->size > right->size) {
+        const PersistentNode<Key> *largest = left;
+
+        while (largest->right != nullptr)
+            largest = largest->right;
+
+        return balance(largest->key, eraseMax(left), retain(right));
+    }
+
+    const PersistentNode<Key> *smallest = right;
+
+    while (smallest->left != nullptr)
+        smallest = smallest->left;
+
+    return balance(smallest->key, retain(left), eraseMin(right));
+}
+
+/**
+ * Builds a copy of the subtree rooted at the given node, which it borrows, without its smallest key.
+ *
+ * @param node The root of the subtree, which must not be empty
+ * @return The root of the new subtree
+ */
+template<typename Key>
+PersistentNode<Key> *PersistentSet<Key>::eraseMin(PersistentNode<Key> *node) {
+    if (node->left == nullptr) return retain(node->right);
+
+    return balance(node->key, eraseMin(node->left), retain(node->right));
+}
+
+/**
+ * Builds a copy of the subtree rooted at the given node, which it borrows, without its largest key.
+ *
+ * @param node The root of the subtree, which must not be empty
+ * @return The root of the new subtree
+ */
+template<typename Key>
+PersistentNode<Key> *PersistentSet<Key>::eraseMax(PersistentNode<Key> *node) {
+    if (node->right == nullptr) return retain(node->left);
+
+    return balance(node->key, retain(node->left), eraseMax(node->right));
+}
@@ -0,0 +1,423 @@
+#include "../include/SwissHashTable.h"
+
+template<typename KeyType, typename ValueType>
+constexpr unsigned int SwissHashTable<KeyType, ValueType>::GROUP_WIDTH;
+
+template<typename KeyType, typename ValueType>
+constexpr std::int8_t SwissHashTable<KeyType, ValueType>::EMPTY;
+
+template<typename KeyType, typename ValueType>
+constexpr std::int8_t SwissHashTable<KeyType, ValueType>::DELETED;
+
+/**
+ * Loads the 16 control bytes of a group.
+ *
+ * @param controlBytes The first control byte of the group
+ */
+template<typename KeyType, typename ValueType>
+SwissHashTable<KeyType, ValueType>::Group::Group(const std::int8_t *controlBytes) {
+#if defined(__SSE2__)
+    controls = _mm_loadu_si128(reinterpret_cast<const __m128i *>(controlBytes));
+#else
+    controls = controlBytes;
+#endif
+}
+
+/**
+ * Returns a bitmask of the slots in the group whose tag equals the given tag.
+ *
+ * @param tag The 7-bit tag to look for
+ * @return A bitmask with bit i set when slot i of the group matches
+ */
+template<typename KeyType, typename ValueType>
+std::uint32_t SwissHashTable<KeyType, ValueType>::Group::match(const std::int8_t tag) const {
+#if defined(__SSE2__)
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi8(tag))));
+#else
+    std::uint32_t mask = 0;
+
+    for (unsigned int i = 0; i < GROUP_WIDTH; ++i) {
+        if (controls[i] == tag) mask |= 1u << i;
+    }
+
+    return mask;
+#endif
+}
+
+/**
+ * Returns a bitmask of the empty slots in the group.
+ *
+ * @return A bitmask with bit i set when slot i of the group is empty
+ */
+template<typename KeyType, typename ValueType>
+std::uint32_t SwissHashTable<KeyType, ValueType>::Group::matchEmpty() const {
+    return match(EMPTY);
+}
+
+/**
+ * Returns a bitmask of the slots in the group that are empty or deleted, i.e. whose control byte has its top bit set.
+ *
+ * @return A bitmask with bit i set when slot i of the group can take a new entry
+ */
+template<typename KeyType, typename ValueType>
+std::uint32_t SwissHashTable<KeyType, ValueType>::Group::matchEmptyOrDeleted() const {
+#if defined(__SSE2__)
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(controls));
+#else
+    std::uint32_t mask = 0;
+
+    for (unsigned int i = 0; i < GROUP_WIDTH; ++i) {
+        if (controls[i] < 0) mask |= 1u << i;
+    }
+
+    return mask;
+#endif
+}
+
+/**
+ * Returns the 7-bit tag stored in the control byte of a full slot.
+ *
+ * @param hash The full hash of the key
+ * @return The key's tag
+ */
+inline std::int8_t swissTag(const std::size_t hash) {
+    return static_cast<std::int8_t>(hash & 0x7F);
+}
+
+/**
+ * Constructor. The number of slots is rounded up to a power of two number of groups.
+ *
+ * @param size The minimum number of slots
+ * @param threshold The max load factor, counting deleted slots
+ */
+template<typename KeyType, typename ValueType>
+SwissHashTable<KeyType, ValueType>::SwissHashTable(const unsigned int size, const double threshold) : tableSize(
+        GROUP_WIDTH), loadFactorThreshold(threshold) {
+    while (tableSize < size) {
+        tableSize *= 2;
+    }
+
+    controlBytes.assign(tableSize, EMPTY);
+    keys.resize(tableSize);
+    values.resize(tableSize);
+}
+
+/**
+ * Returns the beginning of the hash table.
+ *
+ * @return The beginning of the hash table
+ */
+template<typename KeyType, typename ValueType>
+typename SwissHashTable<KeyType, ValueType>::Iterator SwissHashTable<KeyType, ValueType>::begin() {
+    unsigned int index = 0;
+
+    // Skip to the first full slot
+    while (index < tableSize && controlBytes[index] < 0) {
+        ++index;
+    }
+
+    return Iterator(this, index);
+}
+
+/**
+ * Returns the end of the hash table.
+ *
+ * @return The end of the hash table
+ */
+template<typename KeyType, typename ValueType>
+typename SwissHashTable<KeyType, ValueType>::Iterator SwissHashTable<KeyType, ValueType>::end() {
+    return Iterator(this, tableSize);
+}
+
+/**
+ * Returns the value corresponding to the given key, inserting a default-constructed value first if the key does not
+ * exist yet. The key is only hashed once.
+ *
+ * @param key The key to retrieve the value of
+ * @return The value corresponding to the given key
+ */
+template<typename KeyType, typename ValueType>
+ValueType &SwissHashTable<KeyType, ValueType>::operator[](const KeyType &key) {
+    const std::size_t hash = std::hash<KeyType>{}(key);
+    const int index = findIndex(key, hash);
+
+    if (index >= 0) return values[index];
+
+    return values[place(key, ValueType(), hash)];
+}
+
+/**
+ * Updates the value of the given key if it exists.
+ *
+ * @param key The key of the value to update
+ * @param newValue The new value
+ * @return Whether the key exists
+ */
+template<typename KeyType, typename ValueType>
+bool SwissHashTable<KeyType, ValueType>::updateValueForKey(const KeyType &key, ValueType newValue) {
+    const int index = findIndex(key, std::hash<KeyType>{}(key));
+
+    if (index < 0) return false;
+
+    values[index] = newValue;
+
+    return true;
+}
+
+/**
+ * Inserts a value for the given key if the key does not exist yet.
+ *
+ * @param key The key to insert the value for
+ * @param value The value to insert
+ * @return Whether the key was inserted; false means the key already exists and its value was left untouched
+ */
+template<typename KeyType, typename ValueType>
+bool SwissHashTable<KeyType, ValueType>::insert(const KeyType &key, const ValueType &value) {
+    const std::size_t hash = std::hash<KeyType>{}(key);
+
+    if (findIndex(key, hash) >= 0) return false;
+
+    place(key, value, hash);
+
+    return true;
+}
+
+/**
+ * Returns the value of the key if it exists.
+ *
+ * @param key The key to search for
+ * @return The value of the key if it exists
+ */
+template<typename KeyType, typename ValueType>
+ValueType *SwissHashTable<KeyType, ValueType>::search(const KeyType &key) {
+    const int index = findIndex(key, std::hash<KeyType>{}(key));
+
+    return index >= 0 ? &values[index] : nullptr;
+}
+
+/**
+ * Removes the key from the hash table if it exists. The slot becomes empty again when its group still has an empty
+ * slot (no probe sequence can go past such a group), and a tombstone otherwise.
+ *
+ * @param key The key to remove
+ * @return Whether the removal was successful
+ */
+template<typename KeyType, typename ValueType>
+bool SwissHashTable<KeyType, ValueType>::remove(const KeyType &key) {
+    const int index = findIndex(key, std::hash<KeyType>{}(key));
+
+    if (index < 0) return false;
+
+    const unsigned int groupStart = index - index % GROUP_WIDTH;
+
+    if (Group(&controlBytes[groupStart]).matchEmpty() != 0) {
+        controlBytes[index] = EMPTY;
+    } else {
+        controlBytes[index] = DELETED;
+        deletedCount += 1;
+    }
+
+    elementCount -= 1;
+
+    return true;
+}
+
+/**
+ * Clears the hash table of all keys and values.
+ */
+template<typename KeyType, typename ValueType>
+void SwissHashTable<KeyType, ValueType>::clear() {
+    controlBytes.assign(tableSize, EMPTY);
+    elementCount = 0;
+    deletedCount = 0;
+}
+
+/**
+ * Returns the number of items in the hash table.
+ *
+ * @return The number of items in the hash table
+ */
+template<typename KeyType, typename ValueType>
+unsigned int SwissHashTable<KeyType, ValueType>::size() const {
+    return elementCount;
+}
+
+/**
+ * Calculates the hash table's load factor.
+ *
+ * @return The hash table's load factor
+ */
+template<typename KeyType, typename ValueType>
+double SwissHashTable<KeyType, ValueType>::loadFactor() const {
+    double count = size();
+
+    return count / tableSize;
+}
+
+/**
+ * Returns a snapshot of the hash table's occupancy and maintenance counters. The probe length histogram counts, for
+ * each entry, how many groups past its home group it is stored.
+ *
+ * @return The hash table's statistics
+ */
+template<typename KeyType, typename ValueType>
+HashTableStats SwissHashTable<KeyType, ValueType>::stats() const {
+    HashTableStats tableStats;
+
+    for (unsigned int index = 0; index < tableSize; ++index) {
+        if (controlBytes[index] < 0) continue;
+
+        const unsigned int group = index / GROUP_WIDTH;
+        unsigned int probeGroup = (std::hash<KeyType>{}(keys[index]) >> 7) & groupMask();
+        unsigned int probeLength = 0;
+
+        while (probeGroup != group) {
+            probeLength += 1;
+            probeGroup = (probeGroup + probeLength) & groupMask();
+        }
+
+        if (probeLength >= tableStats.probeLengthHistogram.size()) {
+            tableStats.probeLengthHistogram.resize(probeLength + 1, 0);
+        }
+
+        tableStats.probeLengthHistogram[probeLength] += 1;
+    }
+
+    tableStats.rehashCount = rehashCount;
+    tableStats.rehashTime = rehashTime;
+    tableStats.bytesUsed = sizeof(*this) + controlBytes.capacity() + keys.capacity() * sizeof(KeyType) +
+                           values.capacity() * sizeof(ValueType);
+    tableStats.size = elementCount;
+    tableStats.tableSize = tableSize;
+    tableStats.loadFactor = loadFactor();
+
+    return tableStats;
+}
+
+/**
+ * Returns the mask that maps a hash to a group index.
+ *
+ * @return The number of groups minus one
+ */
+template<typename KeyType, typename ValueType>
+unsigned int SwissHashTable<KeyType, ValueType>::groupMask() const {
+    return tableSize / GROUP_WIDTH - 1;
+}
+
+/**
+ * Returns the index of the slot holding the given key. Groups are probed quadratically from the home group, and only
+ * the slots whose tag matches are compared; the search stops at the first group with an empty slot.
+ *
+ * @param key The key to search for
+ * @param hash The full hash of the key
+ * @return The index of the slot holding the key, or -1 if the key does not exist
+ */
+template<typename KeyType, typename ValueType>
+int SwissHashTable<KeyType, ValueType>::findIndex(const KeyType &key, const std::size_t hash) const {
+    const std::int8_t tag = swissTag(hash);
+    unsigned int group = (hash >> 7) & groupMask();
+
+    for (unsigned int probeLength = 1; probeLength <= groupMask() + 1; ++probeLength) {
+        const unsigned int groupStart = group * GROUP_WIDTH;
+        const Group controls(&controlBytes[groupStart]);
+        std::uint32_t candidates = controls.match(tag);
+
+        while (candidates != 0) {
+            const unsigned int index = groupStart + lowestSetBit(candidates);
+
+            if (keys[index] == key) return static_cast<int>(index);
+
+            candidates &= candidates - 1;
+        }
+
+        if (controls.matchEmpty() != 0) return -1;
+
+        group = (group + probeLength) & groupMask();
+    }
+
+    return -1;
+}
+
+/**
+ * Returns the first empty or deleted slot along the given hash's probe sequence.
+ *
+ * @param hash The full hash of the key to insert
+ * @return The index of the slot
+ */
+template<typename KeyType, typename ValueType>
+unsigned int SwissHashTable<KeyType, ValueType>::findInsertSlot(const std::size_t hash) const {
+    unsigned int group = (hash >> 7) & groupMask();
+
+    for (unsigned int probeLength = 1;; ++probeLength) {
+        const unsigned int groupStart = group * GROUP_WIDTH;
+        const std::uint32_t available = Group(&controlBytes[groupStart]).matchEmptyOrDeleted();
+
+        if (available != 0) return groupStart + lowestSetBit(available);
+
+        group = (group + probeLength) & groupMask();
+    }
+}
+
+/**
+ * Places a key that does not exist in the table yet, growing the table (or purging its tombstones) first if the
+ * threshold would be exceeded.
+ *
+ * @param key The key to place
+ * @param value The value to place
+ * @param hash The full hash of the key
+ * @return The index of the slot the key was placed in
+ */
+template<typename KeyType, typename ValueType>
+unsigned int SwissHashTable<KeyType, ValueType>::place(const KeyType &key, const ValueType &value,
+                                                       const std::size_t hash) {
+    if (elementCount + deletedCount + 1 > tableSize * loadFactorThreshold) {
+        // When most of the used slots are tombstones, rebuilding at the same size is enough
+        rehash(elementCount + 1 > tableSize * loadFactorThreshold / 2 ? tableSize * 2 : tableSize);
+    }
+
+    const unsigned int index = findInsertSlot(hash);
+
+    if (controlBytes[index] == DELETED) deletedCount -= 1;
+
+    controlBytes[index] = swissTag(hash);
+    keys[index] = key;
+    values[index] = value;
+    elementCount += 1;
+
+    return index;
+}
+
+/**
+ * Moves every entry into new arrays of the given size, dropping the tombstones.
+ *
+ * @param newTableSize The new number of slots (a power of two number of groups)
+ */
+template<typename KeyType, typename ValueType>
+void SwissHashTable<KeyType, ValueType>::rehash(const unsigned int newTableSize) {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::int8_t> oldControlBytes(newTableSize, EMPTY);
+    std::vector<KeyType> oldKeys(newTableSize);
+    std::vector<ValueType> oldValues(newTableSize);
+
+    oldControlBytes.swap(controlBytes);
+    oldKeys.swap(keys);
+    oldValues.swap(values);
+
+    const unsigned int oldTableSize = tableSize;
+    tableSize = newTableSize;
+    deletedCount = 0;
+
+    for (unsigned int i = 0; i < oldTableSize; ++i) {
+        if (oldControlBytes[i] < 0) continue;
+
+        const std::size_t hash = std::hash<KeyType>{}(oldKeys[i]);
+        const unsigned int index = findInsertSlot(hash);
+
+        controlBytes[index] = swissTag(hash);
+        keys[index] = std::move(oldKeys[i]);
+        values[index] = std::move(oldValues[i]);
+    }
+
+    rehashCount += 1;
+    rehashTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+}
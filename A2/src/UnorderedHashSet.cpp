@@ -0,0 +1,92 @@
+#include "../include/UnorderedHashSet.h"
+
+template<typename Key, typename Hasher>
+constexpr unsigned int UnorderedSet<Key, HashBackend<Hasher>>::MIN_TABLE_SIZE;
+
+/**
+ * Constructor. No memory is allocated until the first insertion.
+ */
+template<typename Key, typename Hasher>
+UnorderedSet<Key, HashBackend<Hasher>>::UnorderedSet() : keys(MIN_TABLE_SIZE) {
+}
+
+/**
+ * Returns the beginning of the unordered set.
+ *
+ * @return The beginning of the unordered set
+ */
+template<typename Key, typename Hasher>
+typename UnorderedSet<Key, HashBackend<Hasher>>::Iterator UnorderedSet<Key, HashBackend<Hasher>>::begin() const {
+    return Iterator(keys.begin());
+}
+
+/**
+ * Returns the end of the unordered set.
+ *
+ * @return The end of the unordered set
+ */
+template<typename Key, typename Hasher>
+typename UnorderedSet<Key, HashBackend<Hasher>>::Iterator UnorderedSet<Key, HashBackend<Hasher>>::end() const {
+    return Iterator(keys.end());
+}
+
+/**
+ * Inserts the provided key into the unordered set. Insertion fails if the key already exists.
+ *
+ * @param key The key to insert
+ * @return Whether the insertion was successful
+ */
+template<typename Key, typename Hasher>
+bool UnorderedSet<Key, HashBackend<Hasher>>::insert(const Key &key) {
+    return keys.insert(key, Member{});
+}
+
+/**
+ * Searches for the given key, in O(1) expected time.
+ *
+ * @param key The key to search for
+ * @return Whether the key exists
+ */
+template<typename Key, typename Hasher>
+bool UnorderedSet<Key, HashBackend<Hasher>>::search(const Key &key) const {
+    return keys.search(key) != nullptr;
+}
+
+/**
+ * Erases the given key. The last inserted key takes the erased key's place in the iteration order.
+ *
+ * @param key Key to erase
+ * @return Whether the erase was successful
+ */
+template<typename Key, typename Hasher>
+bool UnorderedSet<Key, HashBackend<Hasher>>::erase(const Key &key) {
+    return keys.remove(key);
+}
+
+/**
+ * Clears the unordered set of all keys.
+ */
+template<typename Key, typename Hasher>
+void UnorderedSet<Key, HashBackend<Hasher>>::clear() {
+    keys.clear();
+}
+
+/**
+ * Makes room for the given number of keys, so that inserting them does not rehash.
+ *
+ * @param count The number of keys to make room for
+ */
+template<typename Key, typename Hasher>
+void UnorderedSet<Key, HashBackend<Hasher>>::reserve(const unsigned int count) {
+    keys.reserve(count);
+}
+
+/**
+ * Returns the number of keys in the unordered set.
+ *
+ * @return The number of keys in the unordered set
+ */
+template<typename Key, typename Hasher>
+size_t UnorderedSet<Key, HashBackend<Hasher>>::size() const {
+    return keys.size();
+}
@@ -0,0 +1,175 @@
+#ifndef CONCURRENTHASHTABLETESTS_H
+#define CONCURRENTHASHTABLETESTS_H
+#include <iostream>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include "TestEnvironment.h"
+#include "../include/ConcurrentHashTable.h"
+
+std::pair<int, int> concurrentHashTableTestForSingleThread() {
+    int passedTests = 0;
+    TestEnvironment env;
+    ConcurrentHashTable<std::string, Book> bookTable(8);
+    passedTests += a_assert(bookTable.insert(env.book1.ISBN, env.book1));
+    passedTests += a_assert(bookTable.insert(env.book2.ISBN, env.book2));
+    passedTests += a_assert(!bookTable.insert(env.book1.ISBN, env.book3));
+    passedTests += a_assert(bookTable.size() == 2);
+    Book found;
+    passedTests += a_assert(bookTable.search(env.book1.ISBN, found) && found.title == env.book1.title);
+    passedTests += a_assert(!bookTable.search("NonexistentISBN", found));
+    Book updatedBook = env.book2;
+    updatedBook.title = "Updated Title";
+    passedTests += a_assert(bookTable.updateValueForKey(env.book2.ISBN, updatedBook));
+    passedTests += a_assert(bookTable.search(env.book2.ISBN, found) && found.title == "Updated Title");
+    passedTests += a_assert(!bookTable.updateValueForKey(env.book3.ISBN, updatedBook));
+    passedTests += a_assert(bookTable.remove(env.book1.ISBN));
+    passedTests += a_assert(!bookTable.remove(env.book1.ISBN));
+    passedTests += a_assert(!bookTable.contains(env.book1.ISBN));
+
+    ConcurrentHashTable<int, int> intTable(16);
+    for (int i = 0; i < 5000; ++i)
+        intTable.insert(i, i * 2);
+    passedTests += a_assert(intTable.size() == 5000);
+    passedTests += a_assert(intTable.tableSize() >= 5000 / 0.7);
+    passedTests += a_assert(intTable.loadFactor() <= 0.7);
+    int allFound = 0;
+    int value = 0;
+    for (int i = 0; i < 5000; ++i)
+        allFound += intTable.search(i, value) && value == i * 2;
+    passedTests += a_assert(allFound == 5000);
+    return std::make_pair(passedTests, 16);
+}
+
+std::pair<int, int> concurrentHashTableTestForConcurrentAccess() {
+    int passedTests = 0;
+    const int writerCount = 4;
+    const int readerCount = 4;
+    const int keysPerWriter = 4000;
+    ConcurrentHashTable<std::string, int> patronTable(16);
+    for (int i = 0; i < 1000; ++i)
+        patronTable.insert("stable" + std::to_string(i), i);
+    std::atomic<bool> writing(true);
+    std::atomic<int> missedStableKeys(0);
+    std::vector<std::thread> threads;
+    // Readers must keep finding the stable keys while writers displace them and grow the table
+    for (int r = 0; r < readerCount; ++r) {
+        threads.emplace_back([&patronTable, &writing, &missedStableKeys, r]() {
+            int value = 0;
+            for (int i = r; writing.load() || i < 20000; ++i) {
+                const int key = i % 1000;
+                if (!patronTable.search("stable" + std::to_string(key), value) || value != key)
+                    missedStableKeys.fetch_add(1);
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int w = 0; w < writerCount; ++w) {
+        writers.emplace_back([&patronTable, w]() {
+            for (int i = 0; i < keysPerWriter; ++i)
+                patronTable.insert("patron" + std::to_string(w) + "-" + std::to_string(i), i);
+            for (int i = 0; i < keysPerWriter; i += 2)
+                patronTable.remove("patron" + std::to_string(w) + "-" + std::to_string(i));
+            for (int i = 1; i < keysPerWriter; i += 2)
+                patronTable.updateValueForKey("patron" + std::to_string(w) + "-" + std::to_string(i), -i);
+        });
+    }
+    for (std::thread &writer : writers)
+        writer.join();
+    writing.store(false);
+    for (std::thread &reader : threads)
+        reader.join();
+    passedTests += a_assert(missedStableKeys.load() == 0);
+    passedTests += a_assert(patronTable.size() == 1000 + writerCount * keysPerWriter / 2);
+    int consistent = 0;
+    int value = 0;
+    for (int w = 0; w < writerCount; ++w) {
+        for (int i = 0; i < keysPerWriter; ++i) {
+            const bool found = patronTable.search("patron" + std::to_string(w) + "-" + std::to_string(i), value);
+            consistent += i % 2 == 0 ? !found : found && value == -i;
+        }
+    }
+    passedTests += a_assert(consistent == writerCount * keysPerWriter);
+
+    // Racing inserts of the same keys: each key is inserted exactly once
+    ConcurrentHashTable<int, int> intTable(8);
+    std::atomic<int> successfulInserts(0);
+    threads.clear();
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&intTable, &successfulInserts, t]() {
+            for (int i = 0; i < 3000; ++i)
+                successfulInserts.fetch_add(intTable.insert(i, t) ? 1 : 0);
+        });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    passedTests += a_assert(successfulInserts.load() == 3000);
+    passedTests += a_assert(intTable.size() == 3000);
+    return std::make_pair(passedTests, 5);
+}
+
+std::pair<int, int> concurrentHashTableTestForChurnDuringResize() {
+    int passedTests = 0;
+    const int churnKeys = 64;
+    ConcurrentHashTable<int, std::string> patronTable(8);
+    for (int key = 0; key < churnKeys; ++key)
+        patronTable.insert(key, std::to_string(key));
+    std::atomic<bool> growing(true);
+    std::atomic<int> wrongValues(0);
+    std::vector<std::thread> threads;
+    // Readers keep looking up keys whose entries are replaced and removed while the table is resized under them
+    for (int r = 0; r < 2; ++r) {
+        threads.emplace_back([&patronTable, &growing, &wrongValues, r]() {
+            std::string value;
+            for (int i = r; growing.load(); ++i) {
+                const int key = i % churnKeys;
+                if (patronTable.search(key, value) && value != std::to_string(key) && value != std::to_string(-key))
+                    wrongValues.fetch_add(1);
+            }
+        });
+    }
+    for (int c = 0; c < 2; ++c) {
+        threads.emplace_back([&patronTable, &growing, c]() {
+            for (int i = c; growing.load(); ++i) {
+                const int key = i % churnKeys;
+                patronTable.updateValueForKey(key, std::to_string(-key));
+                patronTable.remove(key);
+                patronTable.insert(key, std::to_string(key));
+            }
+        });
+    }
+    // Each insertion below starts from a small table, so the table is resized many times while the others run
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < 20000; ++i)
+            patronTable.insert(churnKeys + round * 20000 + i, "grown");
+    }
+    growing.store(false);
+    for (std::thread &thread : threads)
+        thread.join();
+    passedTests += a_assert(wrongValues.load() == 0);
+    int churnFound = 0;
+    std::string value;
+    for (int key = 0; key < churnKeys; ++key)
+        churnFound += patronTable.search(key, value) && value == std::to_string(key);
+    passedTests += a_assert(churnFound == churnKeys && patronTable.size() == churnKeys + 80000);
+    return std::make_pair(passedTests, 2);
+}
+
+int concurrentHashTableTests() {
+    int passedTests = 0;
+    int totalTests = 0;
+    std::pair<int, int> r1 = concurrentHashTableTestForSingleThread();
+    passedTests += r1.first;
+    totalTests += r1.second;
+    std::pair<int, int> r2 = concurrentHashTableTestForConcurrentAccess();
+    passedTests += r2.first;
+    totalTests += r2.second;
+    std::pair<int, int> r3 = concurrentHashTableTestForChurnDuringResize();
+    passedTests += r3.first;
+    totalTests += r3.second;
+    double grade = static_cast<double>(passedTests * 100) / totalTests;
+    grade = std::round(grade * 10) / 10;
+    std::cout << "Total tests passed: " << passedTests << " out of " << totalTests << " (" << grade << "%)"  << std::endl;
+    return 0;
+}
+#endif //CONCURRENTHASHTABLETESTS_H
@@ -0,0 +1,108 @@
+#ifndef DISKHASHTABLETESTS_H
+#define DISKHASHTABLETESTS_H
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <filesystem>
+#include "TestEnvironment.h"
+#include "../include/DiskHashTable.h"
+
+std::string diskTablePath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("8042_" + name + ".pages")).string();
+}
+
+std::pair<int, int> diskHashTableTestForBooks() {
+    int passedTests = 0;
+    TestEnvironment env;
+    const std::string path = diskTablePath("books");
+    std::remove(path.c_str());
+    {
+        DiskHashTable<Book> books(path);
+        for (const Book& book : {env.book1, env.book2, env.book3, env.book4})
+            books.insert(book.ISBN, book);
+        passedTests += a_assert(books.size() == 4 && !books.insert(env.book1.ISBN, env.book5));
+        std::optional<Book> found = books.search(env.book3.ISBN);
+        passedTests += a_assert(found.has_value() && found->title == env.book3.title &&
+                                found->author == env.book3.author && found->copies == env.book3.copies);
+        passedTests += a_assert(!books.search(env.book5.ISBN).has_value() && !books.contains("NonexistentISBN"));
+        passedTests += a_assert(books.remove(env.book2.ISBN) && !books.remove(env.book2.ISBN));
+        passedTests += a_assert(!books.insert_or_assign(env.book1.ISBN, env.book5) &&
+                                books.search(env.book1.ISBN)->title == env.book5.title);
+    }
+    {
+        // The table is flushed when it is destroyed, and opened again from the same file
+        DiskHashTable<Book> reopenedBooks(path);
+        passedTests += a_assert(reopenedBooks.size() == 3 && reopenedBooks.contains(env.book4.ISBN) &&
+                                !reopenedBooks.contains(env.book2.ISBN));
+        passedTests += a_assert(reopenedBooks.search(env.book1.ISBN)->title == env.book5.title);
+    }
+    std::remove(path.c_str());
+    return std::make_pair(passedTests, 7);
+}
+
+std::pair<int, int> diskHashTableTestForSmallCaches() {
+    int passedTests = 0;
+    const std::string path = diskTablePath("borrowing_history");
+    std::remove(path.c_str());
+    {
+        // Four 512-byte pages hold a few dozen records, far fewer than the table
+        DiskHashTable<std::string> history(path, 4, 512);
+        for (int i = 0; i < 20000; ++i)
+            history.insert("user" + std::to_string(i), "isbn" + std::to_string(i * 7));
+        DiskHashTableStats stats = history.stats();
+        passedTests += a_assert(history.size() == 20000 && stats.splitCount > 500 && stats.directoryDoublings > 8);
+        passedTests += a_assert(stats.bytesUsed < 4 * 512 + 4 * (1u << stats.globalDepth) + 4096);
+        int allFound = 0;
+        for (int i = 0; i < 20000; ++i)
+            allFound += history.search("user" + std::to_string(i)).value_or("") == "isbn" + std::to_string(i * 7);
+        passedTests += a_assert(allFound == 20000);
+        passedTests += a_assert(history.stats().pageReads > stats.pageReads);
+        for (int i = 0; i < 20000; i += 2)
+            history.remove("user" + std::to_string(i));
+        passedTests += a_assert(history.size() == 10000);
+        bool rejected = false;
+        try {
+            history.insert("user-long", std::string(1000, 'x'));
+        } catch (std::length_error& e) {
+            rejected = true;
+        }
+        passedTests += a_assert(rejected && !history.contains("user-long"));
+    }
+    {
+        DiskHashTable<std::string> reopenedHistory(path, 8);
+        int halfFound = 0;
+        for (int i = 0; i < 20000; ++i)
+            halfFound += reopenedHistory.contains("user" + std::to_string(i)) == (i % 2 == 1);
+        passedTests += a_assert(reopenedHistory.size() == 10000 && halfFound == 20000);
+    }
+    std::remove(path.c_str());
+
+    const std::string otherPath = diskTablePath("not_a_table");
+    std::ofstream(otherPath) << "not a disk hash table";
+    bool rejected = false;
+    try {
+        DiskHashTable<int> notATable(otherPath);
+    } catch (std::runtime_error& e) {
+        rejected = true;
+    }
+    passedTests += a_assert(rejected);
+    std::remove(otherPath.c_str());
+    return std::make_pair(passedTests, 8);
+}
+
+int diskHashTableTests() {
+    int passedTests = 0;
+    int totalTests = 0;
+    std::pair<int, int> r1 = diskHashTableTestForBooks();
+    passedTests += r1.first;
+    totalTests += r1.second;
+    std::pair<int, int> r2 = diskHashTableTestForSmallCaches();
+    passedTests += r2.first;
+    totalTests += r2.second;
+    double grade = static_cast<double>(passedTests * 100) / totalTests;
+    grade = std::round(grade * 10) / 10;
+    std::cout << "Total tests passed: " << passedTests << " out of " << totalTests << " (" << grade << "%)"  << std::endl;
+    return 0;
+}
+#endif //DISKHASHTABLETESTS_H
@@ -0,0 +1,113 @@
+#ifndef FROZENHASHTABLETESTS_H
+#define FROZENHASHTABLETESTS_H
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include "TestEnvironment.h"
+#include "../include/FrozenHashTable.h"
+
+std::string frozenImagePath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("8042_" + name + ".frozen")).string();
+}
+
+std::pair<int, int> frozenHashTableTestForBooks() {
+    int passedTests = 0;
+    TestEnvironment env;
+    const std::string path = frozenImagePath("books");
+    HashTable<std::string, Book> allBooks;
+    for (const Book& book : {env.book1, env.book2, env.book3, env.book4, env.book5})
+        allBooks.insert(book.ISBN, book);
+    FrozenHashTable<Book>::freeze(allBooks, path);
+    {
+        FrozenHashTable<Book> frozenBooks(path);
+        passedTests += a_assert(frozenBooks.size() == 5);
+        passedTests += a_assert(frozenBooks.slotCount() == 16);
+        std::optional<FrozenBook> found = frozenBooks.search(env.book3.ISBN);
+        passedTests += a_assert(found.has_value() && found->title == env.book3.title);
+        passedTests += a_assert(found.has_value() && found->author == env.book3.author &&
+                                found->copies == env.book3.copies);
+        passedTests += a_assert(!frozenBooks.search("NonexistentISBN").has_value());
+        passedTests += a_assert(frozenBooks.contains(env.book5.ISBN) && !frozenBooks.contains(env.book6.ISBN));
+        FrozenHashTable<Book> movedBooks(std::move(frozenBooks));
+        passedTests += a_assert(movedBooks.contains(env.book1.ISBN));
+    }
+    // An image written for one value type cannot be opened as another
+    bool rejected = false;
+    try {
+        FrozenHashTable<int> wrongType(path);
+    } catch (std::runtime_error& e) {
+        rejected = true;
+    }
+    passedTests += a_assert(rejected);
+    std::remove(path.c_str());
+    return std::make_pair(passedTests, 8);
+}
+
+std::pair<int, int> frozenHashTableTestForLargeImages() {
+    int passedTests = 0;
+    const std::string path = frozenImagePath("borrowing_time");
+    HashTable<std::string, int> bookBorrowingTime;
+    for (int i = 0; i < 20000; ++i)
+        bookBorrowingTime.insert("isbn" + std::to_string(i), i * 3);
+    FrozenHashTable<int>::freeze(bookBorrowingTime, path);
+    FrozenHashTable<int> frozenTimes(path);
+    passedTests += a_assert(frozenTimes.size() == 20000);
+    int allFound = 0;
+    for (int i = 0; i < 20000; ++i)
+        allFound += frozenTimes.search("isbn" + std::to_string(i)).value_or(-1) == i * 3;
+    passedTests += a_assert(allFound == 20000);
+    int noneFound = 0;
+    for (int i = 20000; i < 30000; ++i)
+        noneFound += !frozenTimes.contains("isbn" + std::to_string(i));
+    passedTests += a_assert(noneFound == 10000);
+    // Values of the same size are told apart by the value type written into the image
+    int rejectedTypes = 0;
+    try {
+        FrozenHashTable<float> floatTimes(path);
+    } catch (std::runtime_error& e) {
+        rejectedTypes += 1;
+    }
+    try {
+        FrozenHashTable<unsigned int> unsignedTimes(path);
+    } catch (std::runtime_error& e) {
+        rejectedTypes += 1;
+    }
+    passedTests += a_assert(rejectedTypes == 2);
+    std::remove(path.c_str());
+
+    const std::string namePath = frozenImagePath("names");
+    HashTable<std::string, std::string> patronNames;
+    patronNames.insert("user1", "Ada Lovelace");
+    patronNames.insert("user2", "");
+    FrozenHashTable<std::string>::freeze(patronNames, namePath);
+    FrozenHashTable<std::string> frozenNames(namePath);
+    passedTests += a_assert(frozenNames.search("user1").value_or("") == "Ada Lovelace");
+    passedTests += a_assert(frozenNames.search("user2").has_value() && frozenNames.search("user2")->empty());
+    std::remove(namePath.c_str());
+
+    bool rejected = false;
+    try {
+        FrozenHashTable<int> missingImage(frozenImagePath("missing"));
+    } catch (std::runtime_error& e) {
+        rejected = true;
+    }
+    passedTests += a_assert(rejected);
+    return std::make_pair(passedTests, 7);
+}
+
+int frozenHashTableTests() {
+    int passedTests = 0;
+    int totalTests = 0;
+    std::pair<int, int> r1 = frozenHashTableTestForBooks();
+    passedTests += r1.first;
+    totalTests += r1.second;
+    std::pair<int, int> r2 = frozenHashTableTestForLargeImages();
+    passedTests += r2.first;
+    totalTests += r2.second;
+    double grade = static_cast<double>(passedTests * 100) / totalTests;
+    grade = std::round(grade * 10) / 10;
+    std::cout << "Total tests passed: " << passedTests << " out of " << totalTests << " (" << grade << "%)"  << std::endl;
+    return 0;
+}
+#endif //FROZENHASHTABLETESTS_H
@@ -0,0 +1,583 @@
+#ifndef HASHTABLEBENCHMARKS_H
+#define HASHTABLEBENCHMARKS_H
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include "../include/HashTable.h"
+#include "../include/SwissHashTable.h"
+#include "../include/StaticHashTable.h"
+#include "../include/ConcurrentHashTable.h"
+#include "../include/FrozenHashTable.h"
+#include "../include/DenseHashTable.h"
+#include "../include/DiskHashTable.h"
+#include "../include/UnorderedHashSet.h"
+#include "../include/Utils.h"
+
+/**
+ * Returns the given number of distinct ISBN-10 style keys, e.g. "0486411044".
+ */
+std::vector<std::string> benchmarkISBNKeys(unsigned int count, unsigned int seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<long long> digits(0, 999999999);
+    std::unordered_map<std::string, bool> seen;
+    std::vector<std::string> keys;
+    while (keys.size() < count) {
+        std::string isbn = std::to_string(digits(generator));
+        isbn = std::string(9 - isbn.size(), '0') + isbn;
+        int checksum = 0;
+        for (int i = 0; i < 9; ++i)
+            checksum += (10 - i) * (isbn[i] - '0');
+        int check = (11 - checksum % 11) % 11;
+        isbn += check == 10 ? 'X' : static_cast<char>('0' + check);
+        if (seen.insert({isbn, true}).second)
+            keys.push_back(isbn);
+    }
+    return keys;
+}
+
+/**
+ * Returns the given number of patron ID keys, e.g. "user123", starting at the given ID.
+ */
+std::vector<std::string> benchmarkPatronKeys(unsigned int count, unsigned int firstID) {
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (unsigned int i = 0; i < count; ++i)
+        keys.push_back("user" + std::to_string(firstID + i));
+    return keys;
+}
+
+/**
+ * Returns the given number of long book title keys sharing a long prefix, starting at the given volume number.
+ */
+std::vector<std::string> benchmarkTitleKeys(unsigned int count, unsigned int firstVolume) {
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (unsigned int i = 0; i < count; ++i)
+        keys.push_back("The Complete Annotated Works of the Library, Volume " + std::to_string(firstVolume + i));
+    return keys;
+}
+
+double nanosecondsPerOperation(std::chrono::steady_clock::time_point start, size_t operations) {
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / operations;
+}
+
+/**
+ * Times inserts, successful lookups and failed lookups of the given keys and prints the cost of each in ns/op.
+ * The checksum keeps the compiler from dropping the lookups.
+ */
+template <typename Table, typename Key>
+void benchmarkTable(const std::string& name, const std::vector<Key>& keys, const std::vector<Key>& missingKeys) {
+    Table table;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < keys.size(); ++i)
+        table.insert(keys[i], i);
+    double insertCost = nanosecondsPerOperation(start, keys.size());
+    unsigned long long checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (const Key& key : keys) {
+        const auto* value = table.search(key);
+        checksum += value != nullptr ? *value : 0;
+    }
+    double hitCost = nanosecondsPerOperation(start, keys.size());
+    start = std::chrono::steady_clock::now();
+    for (const Key& key : missingKeys)
+        checksum += table.search(key) != nullptr;
+    double missCost = nanosecondsPerOperation(start, missingKeys.size());
+    std::cout << "   " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << insertCost << std::setw(10) << hitCost << std::setw(10) << missCost
+              << "   (checksum " << checksum << ")" << std::endl;
+}
+
+/**
+ * Adapts std::unordered_map to the insert/search interface of the hash tables.
+ */
+struct StdUnorderedMap {
+    std::unordered_map<std::string, unsigned int> map;
+
+    void insert(const std::string& key, unsigned int value) {
+        map.insert({key, value});
+    }
+
+    unsigned int* search(const std::string& key) {
+        auto found = map.find(key);
+        return found != map.end() ? &found->second : nullptr;
+    }
+};
+
+void benchmarkKeySet(const std::string& title, const std::vector<std::string>& keys,
+                     const std::vector<std::string>& missingKeys) {
+    std::cout << title << " (" << keys.size() << " keys)" << std::endl;
+    std::cout << "   " << std::left << std::setw(22) << "engine" << std::right << std::setw(10) << "insert"
+              << std::setw(10) << "hit" << std::setw(10) << "miss" << "   ns/op" << std::endl;
+    benchmarkTable<HashTable<std::string, unsigned int>>("hopscotch (H = 32)", keys, missingKeys);
+    benchmarkTable<SwissHashTable<std::string, unsigned int>>("swiss (16-wide groups)", keys, missingKeys);
+    benchmarkTable<DenseHashTable<std::string, unsigned int>>("dense (packed entries)", keys, missingKeys);
+    benchmarkTable<StdUnorderedMap>("std::unordered_map", keys, missingKeys);
+}
+
+/**
+ * Compares the index mappings on integer keys that are multiples of 64, which all share their low bits.
+ */
+void benchmarkIndexMappings(unsigned int keyCount) {
+    std::vector<unsigned int> keys;
+    std::vector<unsigned int> missingKeys;
+    for (unsigned int i = 0; i < keyCount; ++i) {
+        keys.push_back(i * 64);
+        missingKeys.push_back(i * 64 + 1);
+    }
+    std::cout << "Strided integer keys (" << keyCount << " keys)" << std::endl;
+    std::cout << "   " << std::left << std::setw(22) << "hasher / mapping" << std::right << std::setw(10) << "insert"
+              << std::setw(10) << "hit" << std::setw(10) << "miss" << "   ns/op" << std::endl;
+    benchmarkTable<HashTable<unsigned int, unsigned int>>("std::hash / modulo", keys, missingKeys);
+    benchmarkTable<HashTable<unsigned int, unsigned int, 32,
+                             HashTablePolicy<unsigned int, MixingHasher<unsigned int>, std::equal_to<>, DoublingGrowth,
+                                             PowerOfTwoIndexMapping>>>("mixing / mask", keys, missingKeys);
+    benchmarkTable<HashTable<unsigned int, unsigned int, 32,
+                             HashTablePolicy<unsigned int, DefaultHasher<unsigned int>, std::equal_to<>,
+                                             DoublingGrowth, FibonacciIndexMapping>>>("std::hash / fibonacci",
+                                                                                      keys, missingKeys);
+    benchmarkTable<HashTable<unsigned int, unsigned int, 32,
+                             HashTablePolicy<unsigned int, MixingHasher<unsigned int>, std::equal_to<>, DoublingGrowth,
+                                             FastRangeIndexMapping>>>("mixing / fastrange", keys, missingKeys);
+}
+
+/**
+ * Times inserts, successful lookups, failed lookups and a full iteration of a book catalogue keyed by ISBN, like
+ * LibraryRestructuring::allBooks, and prints the cost of each in ns/op.
+ */
+template <typename Table>
+void benchmarkBookTable(const std::string& name, const std::vector<std::string>& isbns,
+                        const std::vector<std::string>& missingISBNs) {
+    Table table;
+    Book book;
+    book.title = "The Art of Computer Programming, Volume 3: Sorting and Searching";
+    book.author = "Donald E. Knuth";
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& isbn : isbns) {
+        book.ISBN = isbn;
+        table.insert(isbn, book);
+    }
+    double insertCost = nanosecondsPerOperation(start, isbns.size());
+    unsigned long long checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (const std::string& isbn : isbns) {
+        const Book* found = table.search(isbn);
+        checksum += found != nullptr ? found->ISBN.size() : 0;
+    }
+    double hitCost = nanosecondsPerOperation(start, isbns.size());
+    start = std::chrono::steady_clock::now();
+    for (const std::string& isbn : missingISBNs)
+        checksum += table.search(isbn) != nullptr;
+    double missCost = nanosecondsPerOperation(start, missingISBNs.size());
+    start = std::chrono::steady_clock::now();
+    for (auto it = table.begin(); it != table.end(); ++it)
+        checksum += (*it)->key.size();
+    double iterationCost = nanosecondsPerOperation(start, isbns.size());
+    std::cout << "   " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << insertCost << std::setw(10) << hitCost << std::setw(10) << missCost
+              << std::setw(10) << iterationCost << "   (checksum " << checksum << ")" << std::endl;
+}
+
+void benchmarkBucketLayouts(const std::vector<std::string>& isbns, const std::vector<std::string>& missingISBNs) {
+    std::cout << "HashTable<std::string, Book> (" << isbns.size() << " books, " << sizeof(Book) << "-byte values)"
+              << std::endl;
+    std::cout << "   " << std::left << std::setw(22) << "layout" << std::right << std::setw(10) << "insert"
+              << std::setw(10) << "hit" << std::setw(10) << "miss" << std::setw(10) << "iterate" << "   ns/op"
+              << std::endl;
+    benchmarkBookTable<HashTable<std::string, Book>>("array of structs", isbns, missingISBNs);
+    benchmarkBookTable<HashTable<std::string, Book, 32,
+                                 HashTablePolicy<std::string, DefaultHasher<std::string>, std::equal_to<>,
+                                                 DoublingGrowth, ModuloIndexMapping, StructOfArraysLayout>>>(
+            "struct of arrays", isbns, missingISBNs);
+    benchmarkBookTable<HashTable<std::string, Book, 32, SlabValuePolicy<std::string>>>("slab values", isbns,
+                                                                                       missingISBNs);
+}
+
+/**
+ * Compares a read-only book catalogue keyed by ISBN in a StaticHashTable with the same catalogue in a HashTable.
+ */
+void benchmarkStaticCatalog(const std::vector<std::string>& isbns, const std::vector<std::string>& missingISBNs) {
+    std::vector<std::pair<std::string, Book>> books;
+    for (const std::string& isbn : isbns) {
+        Book book;
+        book.ISBN = isbn;
+        book.title = "The Art of Computer Programming, Volume 3: Sorting and Searching";
+        books.emplace_back(isbn, book);
+    }
+    std::cout << "Read-only catalogue of " << books.size() << " books" << std::endl;
+    std::cout << "   " << std::left << std::setw(22) << "engine" << std::right << std::setw(10) << "build"
+              << std::setw(10) << "hit" << std::setw(10) << "miss" << "   ns/op" << std::endl;
+    auto report = [&](const std::string& name, auto& table, double buildCost, const std::string& note) {
+        unsigned long long checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const std::string& isbn : isbns) {
+            const Book* found = table.search(isbn);
+            checksum += found != nullptr ? found->ISBN.size() : 0;
+        }
+        double hitCost = nanosecondsPerOperation(start, isbns.size());
+        start = std::chrono::steady_clock::now();
+        for (const std::string& isbn : missingISBNs)
+            checksum += table.search(isbn) != nullptr;
+        double missCost = nanosecondsPerOperation(start, missingISBNs.size());
+        std::cout << "   " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << buildCost << std::setw(10) << hitCost << std::setw(10) << missCost << "   ("
+                  << note << "checksum " << checksum << ")" << std::endl;
+    };
+    auto start = std::chrono::steady_clock::now();
+    HashTable<std::string, Book> hashTable = HashTable<std::string, Book>::buildFrom(books);
+    report("hopscotch", hashTable, nanosecondsPerOperation(start, books.size()), "");
+    start = std::chrono::steady_clock::now();
+    StaticHashTable<std::string, Book> staticTable(books);
+    const double buildCost = nanosecondsPerOperation(start, books.size());
+    std::ostringstream note;
+    note << std::fixed << std::setprecision(2) << staticTable.bitsPerKey() << " bits/key, ";
+    report("static (PTHash-style)", staticTable, buildCost, note.str());
+}
+
+/**
+ * Compares search() in a loop with searchBatch() for random lookups of present keys, on tables from cache-sized up to
+ * well beyond the last level cache.
+ */
+void benchmarkBatchSearch() {
+    std::cout << "Random lookups of title keys, one by one and batched" << std::endl;
+    std::cout << "   " << std::left << std::setw(22) << "table" << std::right << std::setw(10) << "search"
+              << std::setw(10) << "batch" << "   ns/op" << std::endl;
+    const unsigned int lookupCount = 1000000;
+    for (unsigned int keyCount : {20000u, 400000u, 4000000u}) {
+        const std::vector<std::string> keys = benchmarkTitleKeys(keyCount, 0);
+        HashTable<std::string, unsigned int> table;
+        table.reserve(keyCount);
+        for (unsigned int i = 0; i < keyCount; ++i)
+            table.insert(keys[i], i);
+        std::mt19937 generator(8042);
+        std::uniform_int_distribution<unsigned int> pick(0, keyCount - 1);
+        std::vector<std::string_view> lookups(lookupCount);
+        for (std::string_view& key : lookups)
+            key = keys[pick(generator)];
+        unsigned long long checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (std::string_view key : lookups)
+            checksum += *table.search(key);
+        const double searchCost = nanosecondsPerOperation(start, lookupCount);
+        std::vector<unsigned int*> results;
+        start = std::chrono::steady_clock::now();
+        table.searchBatch(lookups, results);
+        for (unsigned int* value : results)
+            checksum -= *value;
+        const double batchCost = nanosecondsPerOperation(start, lookupCount);
+        const size_t megabytes = (table.stats().bytesUsed + keyCount * keys[0].capacity()) >> 20;
+        std::cout << "   " << std::left << std::setw(22) << std::to_string(megabytes) + " MB" << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(10) << searchCost << std::setw(10) << batchCost
+                  << "   (checksum " << checksum << ")" << std::endl;
+    }
+}
+
+/**
+ * Times a full iteration over tables of a fixed size holding an increasing share of occupied buckets.
+ */
+void benchmarkSparseScan(const std::vector<std::string>& keys, unsigned int tableSize) {
+    std::cout << "Full scan of a " << tableSize << "-bucket table" << std::endl;
+    std::cout << "   " << std::left << std::setw(22) << "load" << std::right << std::setw(10) << "scan" << "   ms"
+              << std::endl;
+    for (unsigned int percent : {1u, 5u, 25u, 60u}) {
+        HashTable<std::string, unsigned int> table(tableSize);
+        const unsigned int count = std::min<unsigned int>(keys.size(), tableSize / 100 * percent);
+        for (unsigned int i = 0; i < count; ++i)
+            table.insert(keys[i], i);
+        unsigned long long checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (auto it = table.begin(); it != table.end(); ++it)
+            checksum += (*it)->value;
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "   " << std::left << std::setw(22) << std::to_string(percent) + "%" << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(10) << elapsed.count() << "   (checksum " << checksum << ")"
+                  << std::endl;
+    }
+}
+
+/**
+ * Times a full scan of patron tables with millions of entries, hopscotch against dense, and the rate at which the dense
+ * scan reads its packed entries.
+ */
+void benchmarkDenseScan() {
+    std::cout << "Full scan of patron tables" << std::endl;
+    std::cout << "   " << std::left << std::setw(22) << "patrons" << std::right << std::setw(10) << "hopscotch"
+              << std::setw(10) << "dense" << "   ms" << std::endl;
+    for (unsigned int keyCount : {1000000u, 4000000u}) {
+        const std::vector<std::string> keys = benchmarkPatronKeys(keyCount, 0);
+        unsigned long long checksum = 0;
+        std::chrono::duration<double, std::milli> hopscotchScan{};
+        {
+            HashTable<std::string, unsigned int> table;
+            table.reserve(keyCount);
+            for (unsigned int i = 0; i < keyCount; ++i)
+                table.insert(keys[i], i);
+            auto start = std::chrono::steady_clock::now();
+            for (auto it = table.begin(); it != table.end(); ++it)
+                checksum += (*it)->key.size() + (*it)->value;
+            hopscotchScan = std::chrono::steady_clock::now() - start;
+        }
+        DenseHashTable<std::string, unsigned int> table;
+        table.reserve(keyCount);
+        for (unsigned int i = 0; i < keyCount; ++i)
+            table.insert(keys[i], i);
+        auto start = std::chrono::steady_clock::now();
+        for (auto it = table.begin(); it != table.end(); ++it)
+            checksum -= (*it)->key.size() + (*it)->value;
+        std::chrono::duration<double, std::milli> denseScan = std::chrono::steady_clock::now() - start;
+        const double gigabytesPerSecond = keyCount * sizeof(*table.begin()) / denseScan.count() / 1e6;
+        std::cout << "   " << std::left << std::setw(22) << keyCount << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(10) << hopscotchScan.count() << std::setw(10)
+                  << denseScan.count() << "   (" << std::setprecision(1) << gigabytesPerSecond << " GB/s, checksum "
+                  << checksum << ")" << std::endl;
+    }
+}
+
+/**
+ * Fills a table with the given keys, purges all but 5% of them, then times a full scan of what is left with automatic
+ * shrinking off and on.
+ */
+void benchmarkPurge(const std::vector<std::string>& keys) {
+    std::cout << "Purging 95% of " << keys.size() << " keys" << std::endl;
+    std::cout << "   " << std::left << std::setw(22) << "policy" << std::right << std::setw(10) << "purge"
+              << std::setw(10) << "scan" << "   ms" << std::endl;
+    for (bool shrinking : {false, true}) {
+        HashTable<std::string, unsigned int> table;
+        if (!shrinking) table.setShrinkThreshold(0);
+        for (unsigned int i = 0; i < keys.size(); ++i)
+            table.insert(keys[i], i);
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < keys.size(); ++i)
+            if (i % 20 != 0) table.remove(keys[i]);
+        std::chrono::duration<double, std::milli> purge = std::chrono::steady_clock::now() - start;
+        unsigned long long checksum = 0;
+        start = std::chrono::steady_clock::now();
+        for (auto it = table.begin(); it != table.end(); ++it)
+            checksum += (*it)->value;
+        std::chrono::duration<double, std::milli> scan = std::chrono::steady_clock::now() - start;
+        std::cout << "   " << std::left << std::setw(22) << (shrinking ? "shrink" : "no shrink") << std::right
+                  << std::fixed << std::setprecision(3) << std::setw(10) << purge.count() << std::setw(10)
+                  << scan.count() << "   (" << table.stats().tableSize << " buckets, checksum " << checksum << ")"
+                  << std::endl;
+    }
+}
+
+/**
+ * Compares ways of filling a table with the given keys: inserting one by one into a default-sized table (which rehashes
+ * as it grows), inserting after reserve(), and buildFrom with one and several threads.
+ */
+void benchmarkBulkBuild(const std::vector<std::string>& keys) {
+    std::vector<std::pair<std::string, unsigned int>> entries;
+    entries.reserve(keys.size());
+    for (unsigned int i = 0; i < keys.size(); ++i)
+        entries.emplace_back(keys[i], i);
+    std::cout << "Building a table of " << keys.size() << " keys" << std::endl;
+    std::cout << "   " << std::left << std::setw(22) << "method" << std::right << std::setw(10) << "build"
+              << "   ns/op" << std::endl;
+    auto report = [&keys](const std::string& name, std::chrono::steady_clock::time_point start,
+                          HashTable<std::string, unsigned int>& table) {
+        const double cost = nanosecondsPerOperation(start, keys.size());
+        std::cout << "   " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << cost << "   (size " << table.size() << ", "
+                  << table.stats().rehashCount << " rehashes)" << std::endl;
+    };
+    auto start = std::chrono::steady_clock::now();
+    HashTable<std::string, unsigned int> grownTable;
+    for (const std::pair<std::string, unsigned int>& entry : entries)
+        grownTable.insert(entry.first, entry.second);
+    report("insert", start, grownTable);
+    start = std::chrono::steady_clock::now();
+    HashTable<std::string, unsigned int> reservedTable;
+    reservedTable.reserve(entries.size());
+    for (const std::pair<std::string, unsigned int>& entry : entries)
+        reservedTable.insert(entry.first, entry.second);
+    report("reserve + insert", start, reservedTable);
+    for (unsigned int threadCount : {1u, 4u}) {
+        start = std::chrono::steady_clock::now();
+        HashTable<std::string, unsigned int> builtTable =
+                HashTable<std::string, unsigned int>::buildFrom(entries, 0.7, threadCount);
+        report("buildFrom (" + std::to_string(threadCount) + " thread" + (threadCount > 1 ? "s)" : ")"), start,
+               builtTable);
+    }
+}
+
+/**
+ * Compares starting up from a frozen image with rebuilding the table by inserting every entry, then compares lookups
+ * against the mapped image with lookups against the rebuilt table.
+ */
+void benchmarkFrozenImage(const std::vector<std::string>& keys, const std::vector<std::string>& missingKeys) {
+    const std::string path = (std::filesystem::temp_directory_path() / "8042_benchmark.frozen").string();
+    std::cout << "Frozen image of " << keys.size() << " keys" << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    HashTable<std::string, unsigned int> table;
+    for (unsigned int i = 0; i < keys.size(); ++i)
+        table.insert(keys[i], i);
+    std::chrono::duration<double, std::milli> rebuildTime = std::chrono::steady_clock::now() - start;
+    FrozenHashTable<unsigned int>::freeze(table, path);
+    start = std::chrono::steady_clock::now();
+    FrozenHashTable<unsigned int> frozenTable(path);
+    std::chrono::duration<double, std::milli> openTime = std::chrono::steady_clock::now() - start;
+    std::cout << "   startup: rebuild " << std::fixed << std::setprecision(3) << rebuildTime.count() << " ms, open "
+              << openTime.count() << " ms" << std::endl;
+    unsigned long long checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (const std::string& key : keys)
+        checksum += frozenTable.search(key).value_or(0);
+    double hitCost = nanosecondsPerOperation(start, keys.size());
+    start = std::chrono::steady_clock::now();
+    for (const std::string& key : missingKeys)
+        checksum += frozenTable.contains(key);
+    double missCost = nanosecondsPerOperation(start, missingKeys.size());
+    std::cout << "   mapped lookups: hit " << std::setprecision(1) << hitCost << " ns/op, miss " << missCost
+              << " ns/op   (checksum " << checksum << ")" << std::endl;
+    std::remove(path.c_str());
+}
+
+/**
+ * Times inserts, successful lookups and failed lookups on a disk-backed table with page caches of increasing size, and
+ * prints how many pages had to be read from the file for each.
+ */
+void benchmarkDiskTable(const std::vector<std::string>& keys, const std::vector<std::string>& missingKeys) {
+    const std::string path = (std::filesystem::temp_directory_path() / "8042_benchmark.pages").string();
+    std::cout << "Disk-backed table of " << keys.size() << " keys (4 KB pages)" << std::endl;
+    std::cout << "   " << std::left << std::setw(22) << "cache" << std::right << std::setw(10) << "insert"
+              << std::setw(10) << "hit" << std::setw(10) << "miss" << "   ns/op" << std::endl;
+    for (unsigned int cachePages : {64u, 1024u, 8192u}) {
+        std::remove(path.c_str());
+        DiskHashTable<unsigned int> table(path, cachePages);
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < keys.size(); ++i)
+            table.insert(keys[i], i);
+        double insertCost = nanosecondsPerOperation(start, keys.size());
+        const unsigned long long readsBefore = table.stats().pageReads;
+        unsigned long long checksum = 0;
+        start = std::chrono::steady_clock::now();
+        for (const std::string& key : keys)
+            checksum += table.search(key).value_or(0);
+        double hitCost = nanosecondsPerOperation(start, keys.size());
+        start = std::chrono::steady_clock::now();
+        for (const std::string& key : missingKeys)
+            checksum += table.contains(key);
+        double missCost = nanosecondsPerOperation(start, missingKeys.size());
+        const DiskHashTableStats stats = table.stats();
+        std::cout << "   " << std::left << std::setw(22) << std::to_string(cachePages * 4) + " KB" << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(10) << insertCost << std::setw(10) << hitCost
+                  << std::setw(10) << missCost << "   (" << stats.pageCount << " pages, "
+                  << stats.pageReads - readsBefore << " lookup reads, checksum " << checksum << ")" << std::endl;
+    }
+    std::remove(path.c_str());
+}
+
+/**
+ * Runs a 95% read / 5% insert workload on a shared ConcurrentHashTable with an increasing number of threads and prints
+ * the total throughput, which should grow with the thread count up to the number of cores.
+ */
+void benchmarkConcurrentReads(const std::vector<std::string>& keys, unsigned int operationsPerThread) {
+    const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "Concurrent 95% read workload (" << cores << " cores)" << std::endl;
+    std::cout << "   " << std::left << std::setw(22) << "threads" << std::right << std::setw(10) << "Mops/s" << std::endl;
+    for (unsigned int threadCount = 1; threadCount <= std::max(4u, cores); threadCount *= 2) {
+        ConcurrentHashTable<std::string, unsigned int> table(keys.size() * 2);
+        for (unsigned int i = 0; i < keys.size() / 2; ++i)
+            table.insert(keys[i], i);
+        std::atomic<unsigned long long> checksum(0);
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                std::mt19937 generator(t);
+                std::uniform_int_distribution<unsigned int> pick(0, keys.size() / 2 - 1);
+                unsigned long long found = 0;
+                unsigned int value = 0;
+                for (unsigned int i = 0; i < operationsPerThread; ++i) {
+                    if (i % 20 == 0) {
+                        unsigned int index = keys.size() / 2 + (t + i * threadCount) % (keys.size() / 2);
+                        table.insert(keys[index], index);
+                    } else {
+                        found += table.search(keys[pick(generator)], value);
+                    }
+                }
+                checksum.fetch_add(found);
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "   " << std::left << std::setw(22) << threadCount << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(10) << threadCount * operationsPerThread / elapsed.count() / 1e6
+                  << "   (checksum " << checksum.load() << ")" << std::endl;
+    }
+}
+
+/**
+ * Times book membership tests against borrow sets of growing sizes, stored in the red-black tree and in the hash
+ * backend of UnorderedSet. Half of the books searched for are in the set.
+ */
+void benchmarkSetBackends(const std::vector<std::string>& isbns) {
+    const unsigned int searchCount = 1000000;
+    std::cout << "Book membership tests in borrow sets" << std::endl;
+    std::cout << "   " << std::left << std::setw(22) << "books" << std::right << std::setw(10) << "tree"
+              << std::setw(10) << "hash" << "   ns/search" << std::endl;
+    std::vector<Book> books;
+    std::string publisher = "Dover";
+    std::string year = "1998";
+    std::string copies = "3";
+    for (unsigned int i = 0; i < 2 * 65536; ++i) {
+        std::string isbn = isbns[i];
+        std::string title = "Volume " + std::to_string(i);
+        std::string author = "Author " + std::to_string(i % 977);
+        books.emplace_back(isbn, title, author, publisher, year, copies);
+    }
+    for (unsigned int bookCount : {16u, 1024u, 65536u}) {
+        UnorderedSet<Book> tree;
+        UnorderedSet<Book, HashBackend<>> hash;
+        for (unsigned int i = 0; i < bookCount; ++i) {
+            tree.insert(books[2 * i]);
+            hash.insert(books[2 * i]);
+        }
+        unsigned int found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < searchCount; ++i)
+            found += tree.search(books[i % (2 * bookCount)]);
+        std::chrono::duration<double, std::nano> treeTime = std::chrono::steady_clock::now() - start;
+        start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < searchCount; ++i)
+            found -= hash.search(books[i % (2 * bookCount)]);
+        std::chrono::duration<double, std::nano> hashTime = std::chrono::steady_clock::now() - start;
+        std::cout << "   " << std::left << std::setw(22) << bookCount << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(10) << treeTime.count() / searchCount << std::setw(10)
+                  << hashTime.count() / searchCount << "   (difference " << found << ")" << std::endl;
+    }
+}
+
+int hashTableBenchmarks() {
+    const unsigned int keyCount = 500000;
+    std::cout << std::endl;
+    std::vector<std::string> isbns = benchmarkISBNKeys(2 * keyCount, 8042);
+    std::vector<std::string> missingISBNs(isbns.begin() + keyCount, isbns.end());
+    isbns.resize(keyCount);
+    benchmarkKeySet("ISBN keys", isbns, missingISBNs);
+    benchmarkBucketLayouts(isbns, missingISBNs);
+    benchmarkStaticCatalog(isbns, missingISBNs);
+    benchmarkBulkBuild(isbns);
+    benchmarkSparseScan(isbns, 2 * keyCount);
+    benchmarkPurge(isbns);
+    benchmarkDenseScan();
+    benchmarkSetBackends(isbns);
+    benchmarkBatchSearch();
+    benchmarkFrozenImage(isbns, missingISBNs);
+    benchmarkDiskTable(isbns, missingISBNs);
+    benchmarkKeySet("Patron ID keys", benchmarkPatronKeys(keyCount, 0), benchmarkPatronKeys(keyCount, keyCount));
+    benchmarkKeySet("Title keys", benchmarkTitleKeys(keyCount, 0), benchmarkTitleKeys(keyCount, keyCount));
+    benchmarkIndexMappings(keyCount);
+    benchmarkConcurrentReads(benchmarkPatronKeys(keyCount, 0), 1000000);
+    return 0;
+}
+#endif //HASHTABLEBENCHMARKS_H
@@ -6,9 +6,14 @@
 #define HASHTABLETESTS_H
 #include <iostream>
 #include <cmath>
+#include <map>
+#include <memory>
 #include "../include/Utils.h"
 #include "TestEnvironment.h"
 #include "../include/HashTable.h"
+#include "../include/SwissHashTable.h"
+#include "../include/StaticHashTable.h"
+#include "../include/DenseHashTable.h"
 
 std::pair<int, int> hashTableTestForBookDataStructure() {
     int passedTests = 0;
@@ -143,6 +148,743 @@ std::pair<int, int> hashTableTestForGeneralDataStructures() {
     return std::make_pair(passedTests, 22);
 }
 
+std::pair<int, int> hashTableTestForHopscotchNeighbourhoods() {
+    int passedTests = 0;
+    HashTable<int, int, 4> smallTable(16, 1.0);
+    smallTable.insert(1, 1);
+    smallTable.insert(2, 2);
+    smallTable.insert(3, 3);
+    smallTable.insert(0, 0);
+    smallTable.insert(16, 16); // home bucket 0 is full up to bucket 3, so key 1 has to hop out of the way
+    passedTests += a_assert(smallTable.tableSize == 16);
+    passedTests += a_assert(smallTable.size() == 5);
+    int found = 0;
+    for (int key : {0, 1, 2, 3, 16})
+        found += smallTable.search(key) != nullptr && *smallTable.search(key) == key;
+    passedTests += a_assert(found == 5);
+    smallTable.insert(32, 32);
+    smallTable.insert(48, 48);
+    passedTests += a_assert(smallTable.tableSize == 16);
+    smallTable.insert(64, 64); // a fifth key for home bucket 0 cannot fit in a neighbourhood of 4
+    passedTests += a_assert(smallTable.tableSize == 32);
+    passedTests += a_assert(smallTable.size() == 8);
+    passedTests += a_assert(smallTable.remove(16));
+    passedTests += a_assert(smallTable.search(16) == nullptr);
+    passedTests += a_assert(*smallTable.search(64) == 64);
+
+    HashTable<int, int> denseTable(1000, 0.95);
+    unsigned int key = 12345;
+    std::vector<int> keys;
+    for (int i = 0; i < 900; ++i) {
+        key = key * 1103515245u + 12345u;
+        keys.push_back(static_cast<int>(key >> 1));
+        denseTable.insert(keys.back(), i);
+    }
+    passedTests += a_assert(denseTable.tableSize == 1000); // stable at a load factor of 0.9
+    passedTests += a_assert(denseTable.size() == 900);
+    int allFound = 0;
+    for (int i = 0; i < 900; ++i)
+        allFound += denseTable.search(keys[i]) != nullptr && *denseTable.search(keys[i]) == i;
+    passedTests += a_assert(allFound == 900);
+    return std::make_pair(passedTests, 12);
+}
+std::pair<int, int> hashTableTestForStatistics() {
+    int passedTests = 0;
+    HashTable<int, int> intTable(8);
+    HashTableStats stats = intTable.stats();
+    passedTests += a_assert(stats.size == 0);
+    passedTests += a_assert(stats.rehashCount == 0);
+    for (int i = 0; i < 10; ++i)
+        intTable.insert(i * 8, i); // every key has the same home bucket before the table grows
+    stats = intTable.stats();
+    passedTests += a_assert(stats.size == 10);
+    passedTests += a_assert(stats.tableSize == 16);
+    passedTests += a_assert(stats.rehashCount == 1);
+    passedTests += a_assert(stats.loadFactor == 0.625);
+    unsigned int histogramTotal = 0;
+    for (unsigned int count : stats.probeLengthHistogram)
+        histogramTotal += count;
+    passedTests += a_assert(histogramTotal == 10);
+    passedTests += a_assert(stats.probeLengthHistogram[0] == 2); // homes 0 and 8 each hold one key in place
+    passedTests += a_assert(stats.bytesUsed >= 16 * sizeof(int) * 2);
+    intTable.remove(0);
+    intTable.remove(8);
+    passedTests += a_assert(intTable.size() == 8);
+    passedTests += a_assert(intTable.stats().probeLengthHistogram[0] == 0);
+
+    HashTable<int, int, 4> smallTable(16, 1.0);
+    for (int key : {1, 2, 3, 0, 16})
+        smallTable.insert(key, key);
+    passedTests += a_assert(smallTable.stats().displacements == 1);
+    passedTests += a_assert(smallTable.stats().rehashCount == 0);
+    return std::make_pair(passedTests, 13);
+}
+std::pair<int, int> hashTableTestForIncrementalRehash() {
+    int passedTests = 0;
+    HashTable<int, int> intTable(20);
+    intTable.setIncrementalRehash(true, 4);
+    for (int i = 1; i <= 14; ++i)
+        intTable.insert(i, i * 100);
+    passedTests += a_assert(!intTable.isRehashing());
+    intTable.insert(15, 1500); // 14 elements / 20 slots reaches the threshold
+    passedTests += a_assert(intTable.isRehashing());
+    passedTests += a_assert(intTable.tableSize == 40);
+    passedTests += a_assert(intTable.size() == 15);
+    int allFound = 0;
+    for (int i = 1; i <= 15; ++i)
+        allFound += intTable.search(i) != nullptr && *intTable.search(i) == i * 100;
+    passedTests += a_assert(allFound == 15); // lookups are served from both tables
+    passedTests += a_assert(intTable.remove(14));
+    passedTests += a_assert(!intTable.remove(14));
+    intTable.insert(16, 1600);
+    intTable.insert(17, 1700);
+    intTable[18] = 1800;
+    passedTests += a_assert(intTable.isRehashing());
+    intTable.insert(19, 1900);
+    passedTests += a_assert(!intTable.isRehashing()); // 5 steps of 4 buckets migrated the 20 old buckets
+    passedTests += a_assert(intTable.size() == 18);
+    allFound = 0;
+    for (int i = 1; i <= 19; ++i)
+        allFound += intTable.search(i) != nullptr && *intTable.search(i) == i * 100;
+    passedTests += a_assert(allFound == 18);
+    passedTests += a_assert(intTable.stats().rehashCount == 1);
+
+    HashTable<std::string, int> stringTable(16);
+    stringTable.setIncrementalRehash(true);
+    for (int i = 0; i < 5000; ++i)
+        stringTable.insert("patron" + std::to_string(i), i);
+    allFound = 0;
+    for (int i = 0; i < 5000; ++i)
+        allFound += stringTable.search("patron" + std::to_string(i)) != nullptr;
+    passedTests += a_assert(allFound == 5000);
+    int count = 0;
+    for (auto it = stringTable.begin(); it != stringTable.end(); ++it)
+        ++count;
+    passedTests += a_assert(count == 5000);
+    passedTests += a_assert(!stringTable.isRehashing());
+    return std::make_pair(passedTests, 15);
+}
+std::pair<int, int> hashTableTestForHeterogeneousLookup() {
+    int passedTests = 0;
+    TestEnvironment env;
+    HashTable<std::string, Book> bookTable(8);
+    bookTable.insert(env.book1.ISBN, env.book1);
+    bookTable.insert(env.book2.ISBN, env.book2);
+    const std::string line = env.book1.ISBN + "," + env.book2.ISBN + ",NonexistentISBN";
+    const std::string_view fields(line);
+    const size_t firstComma = fields.find(',');
+    const size_t secondComma = fields.find(',', firstComma + 1);
+    Book* foundBook = bookTable.search(fields.substr(0, firstComma));
+    passedTests += a_assert(foundBook != nullptr && foundBook->ISBN == env.book1.ISBN);
+    foundBook = bookTable.search(fields.substr(firstComma + 1, secondComma - firstComma - 1));
+    passedTests += a_assert(foundBook != nullptr && foundBook->ISBN == env.book2.ISBN);
+    passedTests += a_assert(bookTable.search(fields.substr(secondComma + 1)) == nullptr);
+    passedTests += a_assert(bookTable.search(env.book2.ISBN.c_str()) != nullptr);
+    bookTable[std::string_view(env.book3.ISBN)] = env.book3;
+    passedTests += a_assert(bookTable.size() == 3);
+    passedTests += a_assert(bookTable[std::string_view(env.book3.ISBN)].title == env.book3.title);
+    passedTests += a_assert(bookTable.remove(std::string_view(env.book1.ISBN)));
+    passedTests += a_assert(!bookTable.remove(env.book1.ISBN.c_str()));
+
+    HashTable<std::string, int> patronTable(16);
+    patronTable.setIncrementalRehash(true, 2);
+    for (int i = 0; i < 14; ++i)
+        patronTable.insert("user" + std::to_string(i), i);
+    passedTests += a_assert(patronTable.isRehashing());
+    int allFound = 0;
+    for (int i = 0; i < 14; ++i) {
+        const std::string patronID = "user" + std::to_string(i);
+        allFound += patronTable.search(std::string_view(patronID)) != nullptr; // served from either table
+    }
+    passedTests += a_assert(allFound == 14);
+    return std::make_pair(passedTests, 10);
+}
+template <typename Table>
+int countSequentialKeys(Table& table, int count) {
+    for (int i = 0; i < count; ++i)
+        table.insert(i * 64, i); // multiples of 64 share their low bits
+    int found = 0;
+    for (int i = 0; i < count; ++i)
+        found += table.search(i * 64) != nullptr && *table.search(i * 64) == i;
+    return found + (table.search(1) == nullptr);
+}
+std::pair<int, int> hashTableTestForPolicies() {
+    int passedTests = 0;
+    HashTable<int, int, 32, HashTablePolicy<int, MixingHasher<int>, std::equal_to<>, DoublingGrowth,
+                                            PowerOfTwoIndexMapping>> maskTable(100);
+    passedTests += a_assert(maskTable.tableSize == 128);
+    passedTests += a_assert(countSequentialKeys(maskTable, 5000) == 5001);
+    passedTests += a_assert(maskTable.tableSize == 8192);
+    HashTable<int, int, 32, HashTablePolicy<int, DefaultHasher<int>, std::equal_to<>, DoublingGrowth,
+                                            FibonacciIndexMapping>> fibonacciTable(1);
+    passedTests += a_assert(fibonacciTable.tableSize == 2);
+    passedTests += a_assert(countSequentialKeys(fibonacciTable, 5000) == 5001);
+    HashTable<int, int, 32, HashTablePolicy<int, MixingHasher<int>, std::equal_to<>, DoublingGrowth,
+                                            FastRangeIndexMapping>> fastRangeTable(100);
+    passedTests += a_assert(fastRangeTable.tableSize == 100);
+    passedTests += a_assert(countSequentialKeys(fastRangeTable, 5000) == 5001);
+    HashTable<int, int, 32, HashTablePolicy<int, DefaultHasher<int>, std::equal_to<>, HalfAgainGrowth>> slowGrowthTable(20);
+    for (int i = 0; i < 15; ++i)
+        slowGrowthTable.insert(i, i);
+    passedTests += a_assert(slowGrowthTable.tableSize == 30); // 14 elements / 20 slots reached the threshold
+    slowGrowthTable.clear();
+    slowGrowthTable.setIncrementalRehash(true, 2);
+    passedTests += a_assert(countSequentialKeys(slowGrowthTable, 3000) == 3001);
+
+    HashTable<std::string, int, 32, HashTablePolicy<std::string, MixingHasher<std::string>, std::equal_to<>,
+                                                    DoublingGrowth, FibonacciIndexMapping>> patronTable;
+    for (int i = 0; i < 1000; ++i)
+        patronTable.insert("user" + std::to_string(i), i);
+    int allFound = 0;
+    for (int i = 0; i < 1000; ++i) {
+        const std::string patronID = "user" + std::to_string(i);
+        allFound += patronTable.search(std::string_view(patronID)) != nullptr;
+    }
+    passedTests += a_assert(allFound == 1000);
+    return std::make_pair(passedTests, 10);
+}
+std::pair<int, int> hashTableTestForUpsert() {
+    int passedTests = 0;
+    TestEnvironment env;
+    HashTable<std::string, Book> bookTable(8);
+    passedTests += a_assert(bookTable.insert(env.book1.ISBN, env.book1));
+    passedTests += a_assert(!bookTable.insert(env.book1.ISBN, env.book2));
+    passedTests += a_assert(bookTable.updateValueForKey(env.book1.ISBN, env.book1));
+    passedTests += a_assert(!bookTable.updateValueForKey(env.book2.ISBN, env.book2));
+    std::pair<Book&, bool> emplaced = bookTable.try_emplace(env.book2.ISBN, env.book2);
+    passedTests += a_assert(emplaced.second && emplaced.first.title == env.book2.title);
+    std::pair<Book&, bool> notEmplaced = bookTable.try_emplace(env.book2.ISBN, env.book3);
+    passedTests += a_assert(!notEmplaced.second && notEmplaced.first.title == env.book2.title);
+    std::pair<Book&, bool> assigned = bookTable.insert_or_assign(env.book2.ISBN, env.book3);
+    passedTests += a_assert(!assigned.second && bookTable.search(env.book2.ISBN)->title == env.book3.title);
+    passedTests += a_assert(bookTable.insert_or_assign(env.book3.ISBN, env.book3).second && bookTable.size() == 3);
+    std::pair<Book&, bool> found = bookTable.findOrInsert(env.book1.ISBN);
+    passedTests += a_assert(!found.second && &found.first == bookTable.search(env.book1.ISBN));
+    std::pair<Book&, bool> inserted = bookTable.findOrInsert(std::string_view("NewISBN"));
+    passedTests += a_assert(inserted.second && inserted.first.title.empty() && bookTable.size() == 4);
+
+    HashTable<std::string, int> frequencyMap(4);
+    frequencyMap.setIncrementalRehash(true, 2);
+    int newKeys = 0;
+    for (int i = 0; i < 3000; ++i)
+        newKeys += frequencyMap.upsert("isbn" + std::to_string(i % 1000), [](int &count) { count += 1; });
+    passedTests += a_assert(newKeys == 1000);
+    int allCounted = 0;
+    for (int i = 0; i < 1000; ++i)
+        allCounted += *frequencyMap.search("isbn" + std::to_string(i)) == 3;
+    passedTests += a_assert(allCounted == 1000);
+    passedTests += a_assert(!frequencyMap.upsert(std::string_view("isbn7"), [](int &count) { count = -1; }));
+    passedTests += a_assert(frequencyMap["isbn7"] == -1);
+    return std::make_pair(passedTests, 14);
+}
+
+std::pair<int, int> hashTableTestForBulkBuild() {
+    int passedTests = 0;
+    HashTable<int, int> intTable(8);
+    intTable.insert(1, 10);
+    intTable.reserve(1000);
+    passedTests += a_assert(intTable.tableSize >= 1000 / 0.7);
+    passedTests += a_assert(*intTable.search(1) == 10);
+    const unsigned int reservedSize = intTable.tableSize;
+    for (int i = 0; i < 1000; ++i)
+        intTable.insert(i, i);
+    passedTests += a_assert(intTable.tableSize == reservedSize);
+    passedTests += a_assert(intTable.stats().rehashCount == 0);
+    intTable.reserve(10);
+    passedTests += a_assert(intTable.tableSize == reservedSize); // reserve never shrinks the table
+
+    std::vector<std::pair<std::string, int>> patrons;
+    for (int i = 0; i < 20000; ++i)
+        patrons.emplace_back("user" + std::to_string(i % 15000), i);
+    for (unsigned int threadCount : {1u, 4u}) {
+        HashTable<std::string, int> patronTable = HashTable<std::string, int>::buildFrom(patrons, 0.7, threadCount);
+        passedTests += a_assert(patronTable.size() == 15000);
+        passedTests += a_assert(patronTable.stats().rehashCount == 0);
+        int allFound = 0;
+        for (int i = 0; i < 15000; ++i)
+            allFound += *patronTable.search("user" + std::to_string(i)) == i; // the first occurrence is kept
+        passedTests += a_assert(allFound == 15000);
+        patronTable.insert("user15000", 15000);
+        passedTests += a_assert(patronTable.size() == 15001);
+    }
+    std::vector<std::pair<int, int>> readers;
+    for (int i = 0; i < 10000; ++i)
+        readers.emplace_back(i, -i);
+    HashTable<int, int> readerTable = HashTable<int, int>::buildFrom(readers, 0.7, 7);
+    passedTests += a_assert(readerTable.tableSize / 7 % 64 != 0); // even blocks would split occupancy words
+    int readersFound = 0;
+    for (int i = 0; i < 10000; ++i)
+        readersFound += readerTable.search(i) != nullptr && *readerTable.search(i) == -i;
+    passedTests += a_assert(readersFound == 10000);
+    unsigned int readersVisited = 0;
+    for (auto it = readerTable.begin(); it != readerTable.end(); ++it)
+        readersVisited += 1;
+    passedTests += a_assert(readersVisited == 10000); // iteration follows the occupancy bits
+    std::map<int, int> sortedEntries;
+    for (int i = 1; i <= 494; ++i)
+        sortedEntries[i] = i;
+    for (int i = 1; i <= 6; ++i)
+        sortedEntries[i * 715] = i; // 500 entries get 715 buckets, so these 6 share a neighbourhood of 4
+    HashTable<int, int, 4> crowdedTable = HashTable<int, int, 4>::buildFrom(sortedEntries);
+    passedTests += a_assert(crowdedTable.size() == 500);
+    int allFound = 0;
+    for (const std::pair<const int, int> &entry : sortedEntries)
+        allFound += crowdedTable.search(entry.first) != nullptr && *crowdedTable.search(entry.first) == entry.second;
+    passedTests += a_assert(allFound == 500);
+    return std::make_pair(passedTests, 18);
+}
+
+std::pair<int, int> hashTableTestForSparseIteration() {
+    int passedTests = 0;
+    HashTable<int, int> intTable(130);
+    passedTests += a_assert(intTable.begin() == intTable.end());
+    for (int key : {0, 63, 64, 127, 128, 129}) // the first and last buckets of each 64-bucket word, and the last bucket
+        intTable.insert(key, key * 10);
+    std::vector<int> keys;
+    for (auto it = intTable.begin(); it != intTable.end(); ++it)
+        keys.push_back((*it)->key);
+    passedTests += a_assert(keys == std::vector<int>({0, 63, 64, 127, 128, 129}));
+    intTable.remove(0);
+    intTable.remove(129);
+    keys.clear();
+    for (auto it = intTable.begin(); it != intTable.end(); ++it)
+        keys.push_back((*it)->key);
+    passedTests += a_assert(keys == std::vector<int>({63, 64, 127, 128}));
+
+    HashTable<int, int, 32, HashTablePolicy<int, DefaultHasher<int>, std::equal_to<>, DoublingGrowth,
+                                            ModuloIndexMapping, StructOfArraysLayout>> sparseTable(100000);
+    for (int i = 0; i < 100; ++i)
+        sparseTable.insert(i * 997, i);
+    int sum = 0;
+    int count = 0;
+    for (auto it = sparseTable.begin(); it != sparseTable.end(); ++it) {
+        sum += (*it)->value;
+        count += (*it)->occupied;
+    }
+    passedTests += a_assert(count == 100 && sum == 99 * 100 / 2);
+    return std::make_pair(passedTests, 4);
+}
+
+// Count how often a table hashes and compares keys
+unsigned int hashCalls = 0;
+unsigned int keyComparisons = 0;
+
+struct CountingHasher {
+    size_t operator()(std::string_view key) const {
+        hashCalls += 1;
+        return std::hash<std::string_view>{}(key);
+    }
+};
+
+struct CountingKeyEqual {
+    bool operator()(const std::string& a, std::string_view b) const {
+        keyComparisons += 1;
+        return a == b;
+    }
+};
+
+std::pair<int, int> hashTableTestForCachedHashes() {
+    int passedTests = 0;
+    HashTable<std::string, int, 32, HashTablePolicy<std::string, CountingHasher, CountingKeyEqual>> titleTable(8);
+    hashCalls = 0;
+    for (int i = 0; i < 1000; ++i)
+        titleTable.insert("A Very Long Book Title, Volume " + std::to_string(i), i);
+    // Growing from 8 to 2048 buckets reuses the stored hashes
+    passedTests += a_assert(titleTable.stats().rehashCount == 8 && hashCalls == 1000);
+    keyComparisons = 0;
+    int found = 0;
+    for (int i = 0; i < 1000; ++i)
+        found += titleTable.search("A Very Long Book Title, Volume " + std::to_string(i)) != nullptr;
+    passedTests += a_assert(found == 1000 && keyComparisons == 1000);
+    keyComparisons = 0;
+    for (int i = 1000; i < 2000; ++i)
+        found += titleTable.search("A Very Long Book Title, Volume " + std::to_string(i)) != nullptr;
+    passedTests += a_assert(found == 1000 && keyComparisons == 0);
+    for (int i = 0; i < 1000; i += 2)
+        titleTable.remove("A Very Long Book Title, Volume " + std::to_string(i));
+    hashCalls = 0;
+    titleTable.compact(0.5);
+    found = 0;
+    for (int i = 1; i < 1000; i += 2)
+        found += titleTable.search("A Very Long Book Title, Volume " + std::to_string(i)) != nullptr;
+    passedTests += a_assert(found == 500 && hashCalls == 500);
+
+    HashTable<std::string, int, 32, HashTablePolicy<std::string, DefaultHasher<std::string>, std::equal_to<>,
+                                                    DoublingGrowth, ModuloIndexMapping, StructOfArraysLayout>>
+        layoutTable(8);
+    for (int i = 0; i < 300; ++i)
+        layoutTable.insert("title" + std::to_string(i), i);
+    for (int i = 0; i < 300; i += 3)
+        layoutTable.remove("title" + std::to_string(i));
+    found = 0;
+    for (int i = 0; i < 300; ++i)
+        found += layoutTable.search("title" + std::to_string(i)) != nullptr;
+    passedTests += a_assert(found == 200 && layoutTable.size() == 200);
+    return std::make_pair(passedTests, 5);
+}
+
+std::pair<int, int> hashTableTestForBatchSearch() {
+    int passedTests = 0;
+    HashTable<std::string, int> isbnTable(8);
+    for (int i = 0; i < 1000; ++i)
+        isbnTable.insert("isbn" + std::to_string(i), i);
+    // 101 keys: not a multiple of the group size, with every third key missing
+    std::vector<std::string> keys;
+    for (int i = 0; i < 101; ++i)
+        keys.push_back("isbn" + std::to_string(i % 3 == 2 ? i + 5000 : i * 7));
+    std::vector<int*> results;
+    isbnTable.searchBatch(keys, results);
+    int matching = 0;
+    for (int i = 0; i < 101; ++i)
+        matching += results[i] == isbnTable.search(keys[i]) && (results[i] == nullptr) == (i % 3 == 2);
+    passedTests += a_assert(results.size() == 101 && matching == 101);
+    std::vector<std::string_view> views(keys.begin(), keys.end());
+    std::vector<int*> viewResults;
+    isbnTable.searchBatch(views, viewResults);
+    passedTests += a_assert(viewResults == results);
+    isbnTable.searchBatch(std::vector<std::string>(), results);
+    passedTests += a_assert(results.empty());
+
+    // Keys still waiting in the old table are found during an incremental rehash
+    HashTable<int, int> intTable(64);
+    intTable.setIncrementalRehash(true, 2);
+    std::vector<int> intKeys;
+    for (int i = 0; i < 50; ++i) {
+        intTable.insert(i, i * 2);
+        intKeys.push_back(i);
+    }
+    std::vector<int*> intResults;
+    intTable.searchBatch(intKeys, intResults);
+    int found = 0;
+    for (int i = 0; i < 50; ++i)
+        found += intResults[i] != nullptr && *intResults[i] == i * 2;
+    passedTests += a_assert(intTable.isRehashing() && found == 50);
+    return std::make_pair(passedTests, 4);
+}
+
+std::pair<int, int> hashTableTestForShrinking() {
+    int passedTests = 0;
+    HashTable<std::string, std::string> patronTable(8);
+    for (int i = 0; i < 1000; ++i)
+        patronTable.insert("user" + std::to_string(i), std::string(100, 'x'));
+    passedTests += a_assert(patronTable.stats().tableSize == 2048);
+    for (int i = 10; i < 1000; ++i)
+        patronTable.remove("user" + std::to_string(i));
+    passedTests += a_assert(patronTable.stats().tableSize < 64 && patronTable.stats().shrinkCount > 0);
+    int found = 0;
+    for (int i = 0; i < 10; ++i) {
+        const std::string* value = patronTable.search("user" + std::to_string(i));
+        found += value != nullptr && value->size() == 100;
+    }
+    passedTests += a_assert(found == 10 && patronTable.size() == 10);
+    // Right after a shrink, alternating insertions and removals must neither grow nor shrink the table again
+    const HashTableStats afterShrink = patronTable.stats();
+    for (int i = 0; i < 100; ++i) {
+        patronTable.insert("visitor", "");
+        patronTable.remove("visitor");
+    }
+    passedTests += a_assert(patronTable.stats().tableSize == afterShrink.tableSize &&
+                            patronTable.stats().rehashCount == afterShrink.rehashCount &&
+                            patronTable.stats().shrinkCount == afterShrink.shrinkCount);
+
+    // Removals never shrink below the initial size
+    HashTable<int, int> intTable(1024);
+    for (int i = 0; i < 500; ++i)
+        intTable.insert(i, i);
+    for (int i = 0; i < 500; ++i)
+        intTable.remove(i);
+    passedTests += a_assert(intTable.stats().tableSize == 1024 && intTable.stats().shrinkCount == 0);
+
+    HashTable<int, int> compactTable(8);
+    compactTable.setShrinkThreshold(0);
+    for (int i = 0; i < 1000; ++i)
+        compactTable.insert(i, i * 2);
+    for (int i = 0; i < 1000; i += 2)
+        compactTable.remove(i);
+    passedTests += a_assert(compactTable.stats().tableSize == 2048 && compactTable.stats().shrinkCount == 0);
+    compactTable.compact(0.5);
+    passedTests += a_assert(compactTable.loadFactor() <= 0.5 && compactTable.stats().tableSize < 1024);
+    found = 0;
+    for (int i = 1; i < 1000; i += 2)
+        found += compactTable.search(i) != nullptr && *compactTable.search(i) == i * 2;
+    passedTests += a_assert(found == 500 && compactTable.search(0) == nullptr);
+
+    // A removed value is destroyed at once, not when its bucket is reused
+    HashTable<int, std::shared_ptr<int>> sharedTable(8);
+    std::shared_ptr<int> shared = std::make_shared<int>(42);
+    std::weak_ptr<int> watcher = shared;
+    sharedTable.insert(1, shared);
+    sharedTable.insert(2, std::make_shared<int>(7));
+    shared.reset();
+    sharedTable.remove(1);
+    passedTests += a_assert(watcher.expired());
+    watcher = *sharedTable.search(2);
+    sharedTable.clear();
+    passedTests += a_assert(watcher.expired());
+    return std::make_pair(passedTests, 10);
+}
+
+template <typename KeyType>
+using StructOfArraysPolicy = HashTablePolicy<KeyType, DefaultHasher<KeyType>, std::equal_to<>, DoublingGrowth,
+                                             ModuloIndexMapping, StructOfArraysLayout>;
+
+std::pair<int, int> hashTableTestForStructOfArraysLayout() {
+    int passedTests = 0;
+    TestEnvironment env;
+    HashTable<std::string, Book, 32, StructOfArraysPolicy<std::string>> bookTable(8);
+    bookTable.insert(env.book1.ISBN, env.book1);
+    bookTable.insert(env.book2.ISBN, env.book2);
+    passedTests += a_assert(bookTable.size() == 2);
+    passedTests += a_assert(bookTable.search(env.book1.ISBN)->title == env.book1.title);
+    bookTable[env.book3.ISBN] = env.book3;
+    passedTests += a_assert(bookTable.search(env.book3.ISBN)->author == env.book3.author);
+    passedTests += a_assert(bookTable.remove(env.book2.ISBN));
+    passedTests += a_assert(bookTable.search(env.book2.ISBN) == nullptr);
+    int count = 0;
+    for (auto it = bookTable.begin(); it != bookTable.end(); ++it)
+        count += (*it)->occupied && (*it)->key == (*it)->value.ISBN;
+    passedTests += a_assert(count == 2);
+    passedTests += a_assert(bookTable.stats().bytesUsed < 8 * (sizeof(std::string) + sizeof(Book) + 8) + 64);
+
+    HashTable<int, int, 32, StructOfArraysPolicy<int>> intTable(16);
+    intTable.setIncrementalRehash(true, 4);
+    for (int i = 0; i < 5000; ++i)
+        intTable.insert(i, i * 2);
+    int allFound = 0;
+    for (int i = 0; i < 5000; ++i)
+        allFound += intTable.search(i) != nullptr && *intTable.search(i) == i * 2;
+    passedTests += a_assert(allFound == 5000);
+    for (int i = 0; i < 5000; i += 2)
+        intTable.remove(i);
+    passedTests += a_assert(intTable.size() == 2500);
+    HashTable<int, int, 32, StructOfArraysPolicy<int>> copiedTable = intTable;
+    passedTests += a_assert(copiedTable.search(4999) != nullptr && copiedTable.search(4998) == nullptr);
+    return std::make_pair(passedTests, 9);
+}
+
+std::pair<int, int> hashTableTestForSlabValueLayout() {
+    int passedTests = 0;
+    TestEnvironment env;
+    HashTable<std::string, Book, 32, SlabValuePolicy<std::string>> bookTable(8);
+    bookTable.insert(env.book1.ISBN, env.book1);
+    bookTable.insert(env.book2.ISBN, env.book2);
+    Book& book1 = *bookTable.search(env.book1.ISBN);
+    // Growing from 8 to 2048 buckets moves handles only, so the reference stays valid
+    for (int i = 0; i < 1000; ++i)
+        bookTable.insert("isbn" + std::to_string(i), env.book3);
+    passedTests += a_assert(bookTable.stats().rehashCount > 0 && &book1 == bookTable.search(env.book1.ISBN) &&
+                            book1.title == env.book1.title);
+    passedTests += a_assert(bookTable.remove(env.book2.ISBN) && bookTable.search(env.book2.ISBN) == nullptr);
+    int count = 0;
+    for (auto it = bookTable.begin(); it != bookTable.end(); ++it)
+        count += (*it)->key == env.book1.ISBN ? (*it)->value.title == env.book1.title
+                                              : (*it)->value.title == env.book3.title;
+    passedTests += a_assert(count == 1001);
+    bookTable.compact(0.5);
+    HashTable<std::string, Book, 32, SlabValuePolicy<std::string>> movedTable(std::move(bookTable));
+    passedTests += a_assert(&book1 == movedTable.search(env.book1.ISBN) && movedTable.size() == 1001);
+
+    // A removed value is released to the slab at once, and its slot is reused by the next insertion
+    HashTable<int, std::shared_ptr<int>, 32, SlabValuePolicy<int>> sharedTable(8);
+    std::weak_ptr<int> watcher;
+    {
+        std::shared_ptr<int> shared = std::make_shared<int>(42);
+        watcher = shared;
+        sharedTable.insert(1, shared);
+    }
+    std::shared_ptr<int>* slot = sharedTable.search(1);
+    sharedTable.remove(1);
+    passedTests += a_assert(watcher.expired());
+    sharedTable.insert(2, std::make_shared<int>(7));
+    passedTests += a_assert(sharedTable.search(2) == slot && **sharedTable.search(2) == 7);
+    sharedTable.clear();
+    passedTests += a_assert(sharedTable.size() == 0 && sharedTable.search(2) == nullptr);
+
+    HashTable<int, int, 32, SlabValuePolicy<int>> intTable(16);
+    intTable.setIncrementalRehash(true, 4);
+    for (int i = 0; i < 5000; ++i)
+        intTable.insert(i, i * 2);
+    for (int i = 0; i < 5000; i += 2)
+        intTable.remove(i);
+    int allFound = 0;
+    for (int i = 0; i < 5000; ++i)
+        allFound += i % 2 == 0 ? intTable.search(i) == nullptr : *intTable.search(i) == i * 2;
+    passedTests += a_assert(allFound == 5000 && intTable.size() == 2500);
+    std::vector<std::pair<int, int>> entries;
+    for (int i = 0; i < 20000; ++i)
+        entries.emplace_back(i, i + 1);
+    auto builtTable = HashTable<int, int, 32, SlabValuePolicy<int>>::buildFrom(entries, 0.7, 4);
+    allFound = 0;
+    for (int i = 0; i < 20000; ++i)
+        allFound += builtTable.search(i) != nullptr && *builtTable.search(i) == i + 1;
+    passedTests += a_assert(allFound == 20000);
+    return std::make_pair(passedTests, 9);
+}
+std::pair<int, int> hashTableTestForStaticEngine() {
+    int passedTests = 0;
+    TestEnvironment env;
+    std::vector<std::pair<std::string, Book>> books;
+    for (const Book& book : {env.book1, env.book2, env.book3, env.book4, env.book1})
+        books.emplace_back(book.ISBN, book);
+    books.back().second.title = "Duplicate";
+    StaticHashTable<std::string, Book> catalog(books);
+    passedTests += a_assert(catalog.size() == 4); // the duplicate of book1 is dropped
+    passedTests += a_assert(catalog.search(env.book1.ISBN)->title == env.book1.title);
+    passedTests += a_assert(catalog.search(std::string_view(env.book4.ISBN))->author == env.book4.author);
+    passedTests += a_assert(catalog.search(env.book5.ISBN) == nullptr);
+    catalog.search(env.book2.ISBN)->copies = 42;
+    passedTests += a_assert(catalog.search(env.book2.ISBN)->copies == 42);
+    int count = 0;
+    for (auto it = catalog.begin(); it != catalog.end(); ++it)
+        count += (*it)->key == (*it)->value.ISBN;
+    passedTests += a_assert(count == 4);
+    StaticHashTable<std::string, Book> emptyCatalog(std::vector<std::pair<std::string, Book>>{});
+    passedTests += a_assert(emptyCatalog.size() == 0 && emptyCatalog.search(env.book1.ISBN) == nullptr);
+
+    std::map<int, int> multiples;
+    for (int i = 0; i < 100000; ++i)
+        multiples[i * 7] = i * 3;
+    StaticHashTable<int, int> multipleTable(multiples);
+    passedTests += a_assert(multipleTable.size() == 100000);
+    int allFound = 0;
+    for (const std::pair<const int, int>& entry : multiples)
+        allFound += multipleTable.search(entry.first) != nullptr && *multipleTable.search(entry.first) == entry.second;
+    passedTests += a_assert(allFound == 100000);
+    int noneFound = 0;
+    for (int i = 0; i < 100000; ++i)
+        noneFound += !multipleTable.contains(i * 7 + 1);
+    passedTests += a_assert(noneFound == 100000);
+    passedTests += a_assert(multipleTable.bitsPerKey() < 5);
+    return std::make_pair(passedTests, 11);
+}
+std::pair<int, int> hashTableTestForSwissEngine() {
+    int passedTests = 0;
+    TestEnvironment env;
+    SwissHashTable<std::string, Book> bookTable(8);
+    passedTests += a_assert(bookTable.tableSize == 16); // rounded up to one group of 16 slots
+    bookTable.insert(env.book1.ISBN, env.book1);
+    passedTests += a_assert(bookTable.insert(env.book2.ISBN, env.book2));
+    passedTests += a_assert(!bookTable.insert(env.book1.ISBN, env.book3));
+    passedTests += a_assert(bookTable.size() == 2);
+    passedTests += a_assert(bookTable.search(env.book1.ISBN)->title == env.book1.title);
+    passedTests += a_assert(bookTable.updateValueForKey(env.book2.ISBN, env.book2) &&
+                            !bookTable.updateValueForKey(env.book3.ISBN, env.book3));
+    bookTable[env.book3.ISBN] = env.book3;
+    passedTests += a_assert(bookTable.search(env.book3.ISBN) != nullptr);
+    passedTests += a_assert(bookTable.remove(env.book2.ISBN));
+    passedTests += a_assert(!bookTable.remove(env.book2.ISBN));
+    passedTests += a_assert(bookTable.search(env.book2.ISBN) == nullptr);
+    int count = 0;
+    for (auto it = bookTable.begin(); it != bookTable.end(); ++it)
+        count += (*it)->occupied && (*it)->key == (*it)->value.ISBN;
+    passedTests += a_assert(count == 2);
+
+    SwissHashTable<std::string, int> patronTable(16);
+    for (int i = 0; i < 20000; ++i)
+        patronTable.insert("user" + std::to_string(i), i);
+    passedTests += a_assert(patronTable.size() == 20000);
+    passedTests += a_assert(patronTable.loadFactor() <= 0.875);
+    int allFound = 0;
+    for (int i = 0; i < 20000; ++i)
+        allFound += patronTable.search("user" + std::to_string(i)) != nullptr &&
+                    *patronTable.search("user" + std::to_string(i)) == i;
+    passedTests += a_assert(allFound == 20000);
+    for (int i = 0; i < 20000; i += 2)
+        patronTable.remove("user" + std::to_string(i));
+    int missing = 0;
+    for (int i = 0; i < 20000; ++i)
+        missing += patronTable.search("user" + std::to_string(i)) == nullptr;
+    passedTests += a_assert(missing == 10000);
+    unsigned int tableSize = patronTable.tableSize;
+    for (int round = 0; round < 20; ++round) { // churn through tombstones without growing the table
+        for (int i = 0; i < 2000; ++i)
+            patronTable.insert("churn" + std::to_string(round) + "-" + std::to_string(i), i);
+        for (int i = 0; i < 2000; ++i)
+            patronTable.remove("churn" + std::to_string(round) + "-" + std::to_string(i));
+    }
+    passedTests += a_assert(patronTable.size() == 10000);
+    passedTests += a_assert(patronTable.tableSize == tableSize);
+    HashTableStats stats = patronTable.stats();
+    unsigned int histogramTotal = 0;
+    for (unsigned int groups : stats.probeLengthHistogram)
+        histogramTotal += groups;
+    passedTests += a_assert(histogramTotal == 10000);
+    patronTable.clear();
+    passedTests += a_assert(patronTable.size() == 0 && patronTable.begin() == patronTable.end());
+    return std::make_pair(passedTests, 19);
+}
+std::pair<int, int> hashTableTestForDenseEngine() {
+    int passedTests = 0;
+    TestEnvironment env;
+    DenseHashTable<std::string, Book> bookTable(4);
+    passedTests += a_assert(bookTable.tableSize == 8);
+    for (const Book& book : {env.book1, env.book2, env.book3, env.book4, env.book5})
+        bookTable.insert(book.ISBN, book);
+    passedTests += a_assert(!bookTable.insert(env.book1.ISBN, env.book3));
+    passedTests += a_assert(bookTable.size() == 5 && bookTable.search(env.book1.ISBN)->title == env.book1.title);
+    std::vector<std::string> order;
+    for (auto it = bookTable.begin(); it != bookTable.end(); ++it)
+        order.push_back((*it)->key);
+    passedTests += a_assert(order == std::vector<std::string>({env.book1.ISBN, env.book2.ISBN, env.book3.ISBN,
+                                                               env.book4.ISBN, env.book5.ISBN}));
+    passedTests += a_assert(bookTable.remove(env.book2.ISBN) && !bookTable.remove(env.book2.ISBN));
+    order.clear();
+    for (const auto& entry : bookTable)
+        order.push_back(entry.key);
+    // The last entry moved into the removed entry's place
+    passedTests += a_assert(order == std::vector<std::string>({env.book1.ISBN, env.book5.ISBN, env.book3.ISBN,
+                                                               env.book4.ISBN}));
+    passedTests += a_assert(bookTable.search(env.book5.ISBN)->author == env.book5.author &&
+                            bookTable.search(env.book2.ISBN) == nullptr);
+    passedTests += a_assert(bookTable.upsert(env.book2.ISBN, [](Book& book) { book.copies = 7; }) &&
+                            !bookTable.upsert(env.book2.ISBN, [](Book& book) { book.copies += 1; }) &&
+                            bookTable.search(env.book2.ISBN)->copies == 8);
+
+    DenseHashTable<int, int> multipleTable;
+    for (int i = 0; i < 50000; ++i)
+        multipleTable[i * 64] = i;
+    for (int i = 0; i < 50000; i += 3)
+        multipleTable.remove(i * 64);
+    passedTests += a_assert(multipleTable.size() == 33333 && multipleTable.loadFactor() <= 0.7);
+    int allFound = 0;
+    for (int i = 0; i < 50000; ++i)
+        allFound += i % 3 == 0 ? multipleTable.search(i * 64) == nullptr
+                               : multipleTable.search(i * 64) != nullptr && *multipleTable.search(i * 64) == i;
+    passedTests += a_assert(allFound == 50000);
+    long long sum = 0;
+    unsigned int scanned = 0;
+    for (const auto& entry : multipleTable) {
+        sum += entry.value;
+        scanned += entry.key == entry.value * 64;
+    }
+    passedTests += a_assert(scanned == 33333 && sum == 833316667LL);
+    std::vector<int> lookups = {64, 0, 128, 63};
+    std::vector<int*> values;
+    multipleTable.searchBatch(lookups, values);
+    passedTests += a_assert(values.size() == 4 && *values[0] == 1 && values[1] == nullptr && *values[2] == 2 &&
+                            values[3] == nullptr);
+    HashTableStats stats = multipleTable.stats();
+    unsigned int histogramTotal = 0;
+    for (unsigned int slots : stats.probeLengthHistogram)
+        histogramTotal += slots;
+    passedTests += a_assert(histogramTotal == 33333 && stats.rehashCount > 0);
+    multipleTable.clear();
+    passedTests += a_assert(multipleTable.size() == 0 && multipleTable.begin() == multipleTable.end());
+    multipleTable.reserve(100000);
+    unsigned int reservedSize = multipleTable.tableSize;
+    for (int i = 0; i < 100000; ++i)
+        multipleTable.insert(i, i);
+    passedTests += a_assert(multipleTable.tableSize == reservedSize && multipleTable.size() == 100000);
+    // Tables that have not allocated their index yet, or lost it to a move, still report their statistics
+    DenseHashTable<std::string, int> emptyTable;
+    DenseHashTable<int, int> movedTable(std::move(multipleTable));
+    HashTableStats emptyStats = emptyTable.stats();
+    HashTableStats movedFromStats = multipleTable.stats();
+    passedTests += a_assert(emptyStats.size == 0 && emptyStats.probeLengthHistogram.empty() &&
+                            movedFromStats.size == 0 && movedFromStats.probeLengthHistogram.empty() &&
+                            movedTable.stats().size == 100000);
+    return std::make_pair(passedTests, 16);
+}
 
 int hashTableTests() {
     int passedTests = 0;
@@ -156,6 +898,54 @@ int hashTableTests() {
     std::pair<int, int> r3 = hashTableTestForGeneralDataStructures();
     passedTests += r3.first;
     totalTests += r3.second;
+    std::pair<int, int> r4 = hashTableTestForHopscotchNeighbourhoods();
+    passedTests += r4.first;
+    totalTests += r4.second;
+    std::pair<int, int> r5 = hashTableTestForStatistics();
+    passedTests += r5.first;
+    totalTests += r5.second;
+    std::pair<int, int> r6 = hashTableTestForIncrementalRehash();
+    passedTests += r6.first;
+    totalTests += r6.second;
+    std::pair<int, int> r7 = hashTableTestForHeterogeneousLookup();
+    passedTests += r7.first;
+    totalTests += r7.second;
+    std::pair<int, int> r8 = hashTableTestForPolicies();
+    passedTests += r8.first;
+    totalTests += r8.second;
+    std::pair<int, int> r9 = hashTableTestForUpsert();
+    passedTests += r9.first;
+    totalTests += r9.second;
+    std::pair<int, int> r10 = hashTableTestForBulkBuild();
+    passedTests += r10.first;
+    totalTests += r10.second;
+    std::pair<int, int> r11 = hashTableTestForStructOfArraysLayout();
+    passedTests += r11.first;
+    totalTests += r11.second;
+    std::pair<int, int> r12 = hashTableTestForSwissEngine();
+    passedTests += r12.first;
+    totalTests += r12.second;
+    std::pair<int, int> r13 = hashTableTestForStaticEngine();
+    passedTests += r13.first;
+    totalTests += r13.second;
+    std::pair<int, int> r14 = hashTableTestForSparseIteration();
+    passedTests += r14.first;
+    totalTests += r14.second;
+    std::pair<int, int> r15 = hashTableTestForShrinking();
+    passedTests += r15.first;
+    totalTests += r15.second;
+    std::pair<int, int> r16 = hashTableTestForCachedHashes();
+    passedTests += r16.first;
+    totalTests += r16.second;
+    std::pair<int, int> r17 = hashTableTestForBatchSearch();
+    passedTests += r17.first;
+    totalTests += r17.second;
+    std::pair<int, int> r18 = hashTableTestForSlabValueLayout();
+    passedTests += r18.first;
+    totalTests += r18.second;
+    std::pair<int, int> r19 = hashTableTestForDenseEngine();
+    passedTests += r19.first;
+    totalTests += r19.second;
     double grade = static_cast<double>(passedTests * 100) / totalTests;
     grade = std::round(grade * 10) / 10;
     std::cout << "Total tests passed: " << passedTests << " out of " << totalTests << " (" << grade << "%)"  << std::endl;
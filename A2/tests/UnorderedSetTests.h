@@ -6,9 +6,15 @@
 #define UNORDEREDSETTESTS_H
 #include <iostream>
 #include <cmath>
+#include <set>
+#include <random>
+#include <thread>
+#include <vector>
 #include "../include/Utils.h"
 #include "TestEnvironment.h"
 #include "../include/UnorderedSet.h"
+#include "../include/PersistentSet.h"
+#include "../include/UnorderedHashSet.h"
 
 std::pair<int, int> unorderedSetTestForBookDataStructure() {
     int passedTests = 0;
@@ -229,6 +235,217 @@ std::pair<int, int> unorderedSetTestForGeneralDataStructures() {
 }
 
 
+std::pair<int, int> unorderedSetTestForOrderStatistics() {
+    int passedTests = 0;
+    UnorderedSet<int> intSet;
+    for (int key : {50, 20, 80, 10, 30, 70, 90, 60})
+        intSet.insert(key);
+    passedTests += a_assert(intSet.size() == 8);
+    passedTests += a_assert(intSet.rank(10) == 0 && intSet.rank(60) == 4 && intSet.rank(55) == 4 &&
+                            intSet.rank(100) == 8);
+    passedTests += a_assert(intSet.select(0) == 10 && intSet.select(4) == 60 && intSet.select(7) == 90);
+    passedTests += a_assert(intSet.countInRange(20, 70) == 5 && intSet.countInRange(21, 69) == 3 &&
+                            intSet.countInRange(70, 20) == 0 && intSet.countInRange(91, 99) == 0);
+    bool rejected = false;
+    try {
+        intSet.select(8);
+    } catch (std::out_of_range& e) {
+        rejected = true;
+    }
+    passedTests += a_assert(rejected);
+
+    // Subtree sizes must survive every rotation of a long run of random insertions and erasures
+    std::mt19937 generator(8042);
+    std::uniform_int_distribution<int> keys(0, 3000);
+    std::set<int> expected;
+    UnorderedSet<int> randomSet;
+    for (int i = 0; i < 20000; ++i) {
+        const int key = keys(generator);
+        if (i % 3 == 2) {
+            randomSet.erase(key);
+            expected.erase(key);
+        } else {
+            randomSet.insert(key);
+            expected.insert(key);
+        }
+    }
+    passedTests += a_assert(randomSet.size() == expected.size());
+    size_t matches = 0;
+    size_t index = 0;
+    for (int key : expected) {
+        matches += randomSet.select(index) == key && randomSet.rank(key) == index;
+        index += 1;
+    }
+    passedTests += a_assert(matches == expected.size());
+    passedTests += a_assert(randomSet.countInRange(1000, 1999) ==
+                            static_cast<size_t>(std::distance(expected.lower_bound(1000), expected.upper_bound(1999))));
+    randomSet.clear();
+    passedTests += a_assert(randomSet.size() == 0 && randomSet.rank(5) == 0 && randomSet.countInRange(0, 10) == 0);
+    return std::make_pair(passedTests, 9);
+}
+
+
+std::pair<int, int> unorderedSetTestForNodeSlabs() {
+    int passedTests = 0;
+    TestEnvironment env;
+    UnorderedSet<Book> bookSet;
+    bookSet.insert(env.book1);
+    bookSet.insert(env.book2);
+    // Copies own their nodes, so changing one set leaves the other untouched
+    UnorderedSet<Book> copiedSet(bookSet);
+    copiedSet.insert(env.book3);
+    copiedSet.erase(env.book1);
+    passedTests += a_assert(bookSet.size() == 2 && bookSet.search(env.book1) && !bookSet.search(env.book3));
+    passedTests += a_assert(copiedSet.size() == 2 && copiedSet.search(env.book3) && !copiedSet.search(env.book1));
+    UnorderedSet<Book> movedSet(std::move(copiedSet));
+    passedTests += a_assert(movedSet.size() == 2 && copiedSet.size() == 0 && copiedSet.begin() == copiedSet.end());
+    bookSet = movedSet;
+    movedSet.clear();
+    passedTests += a_assert(bookSet.size() == 2 && bookSet.search(env.book2) && bookSet.search(env.book3));
+
+    UnorderedSet<int> intSet;
+    passedTests += a_assert(intSet.bytesUsed() == 0);
+    for (int i = 0; i < 1000; ++i)
+        intSet.insert(i);
+    const size_t bytesUsed = intSet.bytesUsed();
+    for (int i = 0; i < 1000; i += 2)
+        intSet.erase(i);
+    for (int i = 1000; i < 1500; ++i)
+        intSet.insert(i);
+    // Erased nodes are reused before the slabs grow
+    passedTests += a_assert(intSet.size() == 1000 && intSet.bytesUsed() == bytesUsed);
+    intSet.clear();
+    passedTests += a_assert(intSet.size() == 0 && intSet.bytesUsed() == 0 && intSet.insert(7) && intSet.search(7));
+    return std::make_pair(passedTests, 7);
+}
+
+std::pair<int, int> unorderedSetTestForPersistentSnapshots() {
+    int passedTests = 0;
+    TestEnvironment env;
+    PersistentSet<Book> bookSet;
+    bookSet.insert(env.book1);
+    bookSet.insert(env.book2);
+    PersistentSet<Book> copiedSet(bookSet);
+    copiedSet.insert(env.book3);
+    copiedSet.erase(env.book1);
+    passedTests += a_assert(bookSet.size() == 2 && bookSet.search(env.book1) && !bookSet.search(env.book3));
+    passedTests += a_assert(copiedSet.size() == 2 && copiedSet.search(env.book3) && !copiedSet.search(env.book1));
+    passedTests += a_assert(!bookSet.insert(env.book2) && !copiedSet.erase(env.book1));
+
+    // Every snapshot keeps the keys the set had when it was taken
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> keys(0, 2000);
+    PersistentSet<int> intSet;
+    std::set<int> expected;
+    std::vector<std::pair<PersistentSet<int>, std::set<int>>> snapshots;
+    for (int i = 0; i < 20000; ++i) {
+        const int key = keys(generator);
+        if (i % 3 == 0) {
+            intSet.erase(key);
+            expected.erase(key);
+        } else {
+            intSet.insert(key);
+            expected.insert(key);
+        }
+        if (i % 1000 == 0) snapshots.emplace_back(intSet.snapshot(), expected);
+    }
+    bool snapshotsHold = true;
+    for (const auto& snapshot : snapshots) {
+        std::vector<int> snapshotKeys;
+        for (int key : snapshot.first)
+            snapshotKeys.push_back(key);
+        snapshotsHold = snapshotsHold && snapshot.first.size() == snapshot.second.size() &&
+                        std::equal(snapshotKeys.begin(), snapshotKeys.end(), snapshot.second.begin(),
+                                   snapshot.second.end());
+    }
+    passedTests += a_assert(snapshotsHold && snapshots.size() == 20);
+    bool ranksHold = true;
+    size_t position = 0;
+    for (int key : expected) {
+        ranksHold = ranksHold && intSet.rank(key) == position && intSet.select(position) == key;
+        ++position;
+    }
+    passedTests += a_assert(ranksHold && intSet.size() == expected.size());
+
+    // A change copies the nodes on one path and shares every other key with the set it was copied from
+    PersistentSet<int> sharedSet;
+    for (int i = 0; i < 4096; ++i)
+        sharedSet.insert(i);
+    PersistentSet<int> changedSet = sharedSet;
+    changedSet.erase(1000);
+    changedSet.insert(1000);
+    int copiedKeys = 0;
+    for (size_t i = 0; i < sharedSet.size(); ++i)
+        copiedKeys += &sharedSet.select(i) != &changedSet.select(i);
+    passedTests += a_assert(copiedKeys > 0 && copiedKeys < 64 && changedSet.size() == 4096);
+
+    // A reader can walk its snapshot while the set it was taken from changes on another thread
+    PersistentSet<int> readerSnapshot = sharedSet.snapshot();
+    long long readerSum = 0;
+    std::thread reader([&readerSnapshot, &readerSum]() {
+        for (int pass = 0; pass < 20; ++pass)
+            for (int key : readerSnapshot)
+                readerSum += key;
+    });
+    for (int i = 0; i < 4096; i += 2)
+        sharedSet.erase(i);
+    changedSet.clear();
+    reader.join();
+    passedTests += a_assert(readerSum == 20LL * 4095 * 4096 / 2 && sharedSet.size() == 2048 &&
+                            readerSnapshot.size() == 4096);
+
+    bool rejected = false;
+    try {
+        sharedSet.select(2048);
+    } catch (std::out_of_range& e) {
+        rejected = true;
+    }
+    passedTests += a_assert(rejected && PersistentSet<int>().begin() == PersistentSet<int>().end());
+    return std::make_pair(passedTests, 8);
+}
+
+std::pair<int, int> unorderedSetTestForHashBackend() {
+    int passedTests = 0;
+    TestEnvironment env;
+    UnorderedSet<Book, HashBackend<>> bookSet;
+    passedTests += a_assert(bookSet.size() == 0 && bookSet.begin() == bookSet.end() && !bookSet.search(env.book1));
+    bookSet.insert(env.book1);
+    bookSet.insert(env.book2);
+    bookSet.insert(env.book3);
+    passedTests += a_assert(bookSet.size() == 3 && !bookSet.insert(env.book2) && bookSet.search(env.book3));
+    passedTests += a_assert(bookSet.erase(env.book1) && !bookSet.erase(env.book1) && !bookSet.search(env.book1));
+    // Copies own their keys, and a set that was moved from is empty and usable
+    UnorderedSet<Book, HashBackend<>> copiedSet(bookSet);
+    copiedSet.insert(env.book4);
+    UnorderedSet<Book, HashBackend<>> movedSet(std::move(copiedSet));
+    passedTests += a_assert(bookSet.size() == 2 && !bookSet.search(env.book4) && movedSet.size() == 3 &&
+                            copiedSet.size() == 0 && !copiedSet.search(env.book2));
+    passedTests += a_assert(copiedSet.insert(env.book5) && copiedSet.search(env.book5) && copiedSet.size() == 1);
+
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> keys(0, 5000);
+    UnorderedSet<std::string, HashBackend<>> stringSet;
+    std::set<std::string> expected;
+    bool matches = true;
+    for (int i = 0; i < 20000; ++i) {
+        const std::string key = "user" + std::to_string(keys(generator));
+        if (i % 3 == 0) {
+            matches = matches && stringSet.erase(key) == (expected.erase(key) == 1);
+        } else {
+            matches = matches && stringSet.insert(key) == expected.insert(key).second;
+        }
+    }
+    passedTests += a_assert(matches && stringSet.size() == expected.size());
+    std::set<std::string> iterated;
+    for (const std::string& key : stringSet)
+        iterated.insert(key);
+    passedTests += a_assert(iterated == expected);
+    stringSet.clear();
+    passedTests += a_assert(stringSet.size() == 0 && stringSet.begin() == stringSet.end() && !stringSet.search("user1"));
+    return std::make_pair(passedTests, 8);
+}
+
+
 int unorderedSetTests() {
     int passedTests = 0;
     int totalTests = 0;
@@ -244,6 +461,18 @@ int unorderedSetTests() {
     std::pair<int, int> r4 = unorderedSetTestBalacingFunctionality();
     passedTests += r4.first;
     totalTests += r4.second;
+    std::pair<int, int> r5 = unorderedSetTestForOrderStatistics();
+    passedTests += r5.first;
+    totalTests += r5.second;
+    std::pair<int, int> r6 = unorderedSetTestForNodeSlabs();
+    passedTests += r6.first;
+    totalTests += r6.second;
+    std::pair<int, int> r7 = unorderedSetTestForPersistentSnapshots();
+    passedTests += r7.first;
+    totalTests += r7.second;
+    std::pair<int, int> r8 = unorderedSetTestForHashBackend();
+    passedTests += r8.first;
+    totalTests += r8.second;
     double grade = static_cast<double>(passedTests * 100) / totalTests;
     grade = std::round(grade * 10) / 10;
     std::cout << "Total tests passed: " << passedTests << " out of " << totalTests << " (" << grade << "%)"  << std::endl;
@@ -8,38 +8,580 @@
  * Implementation of a hash table.
  */
 #include <string>
+#include <string_view>
 #include <vector>
 #include <limits>
 #include <type_traits>
+#include <cstdint>
+#include <stdexcept>
+#include <chrono>
+#include <functional>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <thread>
+#include <memory>
+#include <new>
+
+/**
+ * Snapshot of a hash table's occupancy and maintenance counters, used to tune table sizes and neighbourhoods.
+ */
+struct HashTableStats {
+    // probeLengthHistogram[i] is the number of entries stored i buckets away from their home bucket
+    std::vector<unsigned int> probeLengthHistogram;
+    unsigned long long displacements = 0;
+    unsigned int rehashCount = 0;
+    unsigned int shrinkCount = 0;
+    std::chrono::nanoseconds rehashTime{0};
+    size_t bytesUsed = 0;
+    unsigned int size = 0;
+    unsigned int tableSize = 0;
+    double loadFactor = 0;
+};
+
+/**
+ * The type a key can be looked up by without building a KeyType first, e.g. std::string_view for std::string keys. The
+ * std::hash of a view must equal the std::hash of the key it views, and views must be comparable to keys with ==.
+ * Specialize it to enable heterogeneous lookup for other key types.
+ */
+template <typename KeyType>
+struct HashKeyView {
+    using type = const KeyType&;
+};
+
+template <>
+struct HashKeyView<std::string> {
+    using type = std::string_view;
+};
+
+/**
+ * The default hasher: std::hash, applied to the key's view so that keys and their views hash alike.
+ */
+template <typename KeyType>
+struct DefaultHasher {
+    size_t operator()(typename HashKeyView<KeyType>::type key) const;
+};
+
+/**
+ * std::hash followed by a 64-bit finalizer. std::hash is the identity for integers, which leaves the low bits of
+ * sequential keys correlated; use this hasher for integer keys with the mask, Fibonacci or fastrange index mappings.
+ */
+template <typename KeyType>
+struct MixingHasher {
+    size_t operator()(typename HashKeyView<KeyType>::type key) const;
+};
+
+/**
+ * Growth policies return the next table size when the table grows. The index mapping may round it up further.
+ */
+struct DoublingGrowth {
+    static unsigned int nextSize(unsigned int size);
+};
+
+struct HalfAgainGrowth {
+    static unsigned int nextSize(unsigned int size);
+};
+
+/**
+ * Index mappings turn a hash into a bucket index. tableSize() adjusts a requested table size to one the mapping
+ * supports, and index() maps a hash to [0, size).
+ */
+// hash % size: works with any size and any hasher, but pays an integer division per probe
+struct ModuloIndexMapping {
+    static unsigned int tableSize(unsigned int requestedSize);
+    static unsigned int index(size_t hash, unsigned int size);
+};
+
+// hash & (size - 1): a single AND, on a power of two size; only the low bits of the hash are used
+struct PowerOfTwoIndexMapping {
+    static unsigned int tableSize(unsigned int requestedSize);
+    static unsigned int index(size_t hash, unsigned int size);
+};
+
+// The top bits of hash * 2^64 / phi, on a power of two size; spreads the low bits of weak hashes across the table
+struct FibonacciIndexMapping {
+    static unsigned int tableSize(unsigned int requestedSize);
+    static unsigned int index(size_t hash, unsigned int size);
+};
+
+// Lemire's fastrange (hash * size) >> 64: a multiplication on any size; only the high bits of the hash are used
+struct FastRangeIndexMapping {
+    static unsigned int tableSize(unsigned int requestedSize);
+    static unsigned int index(size_t hash, unsigned int size);
+};
+
+/**
+ * A reference to the occupancy bit of one bucket, which reads and assigns like a bool&.
+ */
+template <bool Const>
+class OccupancyBit {
+public:
+    using Word = typename std::conditional<Const, const std::uint64_t, std::uint64_t>::type;
+
+    OccupancyBit(Word& word, std::uint64_t mask) : word(word), mask(mask) {}
+
+    operator bool() const {
+        return (word & mask) != 0;
+    }
+
+    OccupancyBit& operator=(bool occupied) {
+        word = occupied ? word | mask : word & ~mask;
+        return *this;
+    }
+
+    OccupancyBit& operator=(const OccupancyBit& other) {
+        return *this = static_cast<bool>(other);
+    }
 
-template <typename KeyType, typename ValueType>
-class HashTable {
 private:
-    static constexpr unsigned int HOP_RANGE = 4;
+    Word& word;
+    std::uint64_t mask;
+};
 
-    struct Bucket {
-        KeyType key;
-        ValueType value;
-        bool occupied;
-        unsigned int hopInfo;
+/**
+ * One bit per bucket, set while the bucket holds an entry. Scans for occupied buckets read 64 buckets per word and jump
+ * straight to the next set bit, so iterating over a lightly loaded table does not touch the empty buckets at all.
+ */
+class OccupancyBitmap {
+public:
+    OccupancyBitmap() = default;
+    explicit OccupancyBitmap(unsigned int size);
+    OccupancyBit<false> operator[](unsigned int index);
+    OccupancyBit<true> operator[](unsigned int index) const;
+    unsigned int next(unsigned int index, unsigned int end) const;
+    void assign(unsigned int size);
+    void swap(OccupancyBitmap& other);
+    void release();
+    size_t bytesUsed() const;
 
-        Bucket() : occupied(false), hopInfo(0) {}
+private:
+    std::vector<std::uint64_t> words;
+};
+
+// Asks the CPU to start loading the cache line holding the given address, without waiting for it
+inline void prefetchForRead(const void* address);
+
+/**
+ * References to the parts of one bucket, whichever layout stores them. Iterating over a HashTable yields these, and
+ * (*it)->key / bucket->value work on them as they would on a bucket pointer. hash is the full hash of the bucket's key,
+ * kept so that probes and rehashes do not have to read or hash the key again.
+ */
+template <typename KeyType, typename ValueType, typename HopBitmap, bool Const>
+struct BucketRef {
+    typename std::conditional<Const, const KeyType, KeyType>::type& key;
+    typename std::conditional<Const, const ValueType, ValueType>::type& value;
+    OccupancyBit<Const> occupied;
+    typename std::conditional<Const, const HopBitmap, HopBitmap>::type& hopInfo;
+    typename std::conditional<Const, const size_t, size_t>::type& hash;
+
+    const BucketRef* operator->() const {
+        return this;
+    }
+};
+
+/**
+ * Stable storage for values kept out of line. Values are constructed in fixed-size chunks that never move, so a value
+ * keeps its address until it is released, whatever happens to the buckets pointing at it. Released values are reset to
+ * a default value at once, to free what they hold, and reused by later allocations.
+ */
+template <typename ValueType>
+class ValueSlab {
+public:
+    ValueSlab() = default;
+    ~ValueSlab();
+    ValueSlab(const ValueSlab&) = delete;
+    ValueSlab& operator=(const ValueSlab&) = delete;
+    template <typename Value>
+    ValueType* allocate(Value&& value);
+    void release(ValueType* value);
+    size_t bytesUsed() const;
+
+private:
+    static constexpr unsigned int CHUNK_SIZE = 256;
+
+    // Raw storage for one value; values are only constructed once a chunk slot is first handed out
+    struct alignas(ValueType) Slot {
+        unsigned char bytes[sizeof(ValueType)];
     };
 
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    std::vector<ValueType*> freeValues;
+    size_t constructedCount = 0;
+};
+
+/**
+ * Bucket layouts decide how a HashTable stores its buckets. Bucket i is accessed as a BucketRef, so the table's
+ * algorithms do not depend on the layout. All layouts keep the occupied flags in an OccupancyBitmap, and
+ * nextOccupied() finds the first occupied bucket in [index, end), or returns end.
+ *
+ * Entries are written through setValue() and transfer(), and emptied through clearEntry(), so that a layout can store
+ * values elsewhere than in the bucket array. storageBytesUsed() reports memory shared by every bucket array of a table,
+ * which shareStorage() hands to a new array; PARALLEL_PLACEMENT says whether several threads may fill distinct buckets.
+ */
+// Each bucket keeps its hop bitmap, key and value together, so a probe that finds its key has the value at hand
+struct ArrayOfStructsLayout {
+    template <typename KeyType, typename ValueType, typename HopBitmap>
+    class Buckets {
+    public:
+        using Ref = BucketRef<KeyType, ValueType, HopBitmap, false>;
+        using ConstRef = BucketRef<KeyType, ValueType, HopBitmap, true>;
+
+        Buckets() = default;
+        explicit Buckets(unsigned int size) : buckets(size), occupancy(size) {}
+
+        Ref operator[](unsigned int index) {
+            Bucket& bucket = buckets[index];
+            return Ref{bucket.key, bucket.value, occupancy[index], bucket.hopInfo, bucket.hash};
+        }
+
+        ConstRef operator[](unsigned int index) const {
+            const Bucket& bucket = buckets[index];
+            return ConstRef{bucket.key, bucket.value, occupancy[index], bucket.hopInfo, bucket.hash};
+        }
+
+        void prefetch(unsigned int index) const {
+            prefetchForRead(&buckets[index]);
+        }
+
+        unsigned int nextOccupied(unsigned int index, unsigned int end) const {
+            return occupancy.next(index, end);
+        }
+
+        void assign(unsigned int size) {
+            buckets.assign(size, Bucket());
+            occupancy.assign(size);
+        }
+
+        void swap(Buckets& other) {
+            buckets.swap(other.buckets);
+            occupancy.swap(other.occupancy);
+        }
+
+        void release() {
+            std::vector<Bucket>().swap(buckets);
+            occupancy.release();
+        }
+
+        size_t bytesUsed() const {
+            return buckets.capacity() * sizeof(Bucket) + occupancy.bytesUsed();
+        }
+
+        template <typename Value>
+        void setValue(unsigned int index, Value&& value) {
+            buckets[index].value = std::forward<Value>(value);
+        }
+
+        void transfer(unsigned int index, Buckets& from, unsigned int fromIndex) {
+            Bucket& bucket = buckets[index];
+            Bucket& source = from.buckets[fromIndex];
+            bucket.key = std::move(source.key);
+            bucket.value = std::move(source.value);
+            bucket.hash = source.hash;
+        }
+
+        void clearEntry(unsigned int index) {
+            buckets[index].key = KeyType();
+            buckets[index].value = ValueType();
+        }
+
+        void shareStorage(const Buckets&) {}
+
+        size_t storageBytesUsed() const {
+            return 0;
+        }
+
+        static constexpr bool PARALLEL_PLACEMENT = true;
+
+    private:
+        struct Bucket {
+            KeyType key;
+            ValueType value;
+            size_t hash;
+            HopBitmap hopInfo;
+
+            Bucket() : hash(0), hopInfo(0) {}
+        };
+
+        std::vector<Bucket> buckets;
+        OccupancyBitmap occupancy;
+    };
+};
+
+// Hop bitmaps, hashes, keys and values live in separate arrays, so probes over large values only touch metadata and key
+// lines, and probes that miss only touch metadata
+struct StructOfArraysLayout {
+    template <typename KeyType, typename ValueType, typename HopBitmap>
+    class Buckets {
+    public:
+        using Ref = BucketRef<KeyType, ValueType, HopBitmap, false>;
+        using ConstRef = BucketRef<KeyType, ValueType, HopBitmap, true>;
+
+        Buckets() = default;
+        explicit Buckets(unsigned int size)
+                : hopInfo(size, 0), occupancy(size), hashes(size, 0), keys(size), values(size) {}
+
+        Ref operator[](unsigned int index) {
+            return Ref{keys[index], values[index], occupancy[index], hopInfo[index], hashes[index]};
+        }
+
+        ConstRef operator[](unsigned int index) const {
+            return ConstRef{keys[index], values[index], occupancy[index], hopInfo[index], hashes[index]};
+        }
+
+        void prefetch(unsigned int index) const {
+            prefetchForRead(&hopInfo[index]);
+            prefetchForRead(&hashes[index]);
+        }
+
+        unsigned int nextOccupied(unsigned int index, unsigned int end) const {
+            return occupancy.next(index, end);
+        }
+
+        void assign(unsigned int size) {
+            hopInfo.assign(size, 0);
+            occupancy.assign(size);
+            hashes.assign(size, 0);
+            keys.assign(size, KeyType());
+            values.assign(size, ValueType());
+        }
+
+        void swap(Buckets& other) {
+            hopInfo.swap(other.hopInfo);
+            occupancy.swap(other.occupancy);
+            hashes.swap(other.hashes);
+            keys.swap(other.keys);
+            values.swap(other.values);
+        }
+
+        void release() {
+            std::vector<HopBitmap>().swap(hopInfo);
+            occupancy.release();
+            std::vector<size_t>().swap(hashes);
+            std::vector<KeyType>().swap(keys);
+            std::vector<ValueType>().swap(values);
+        }
+
+        size_t bytesUsed() const {
+            return hopInfo.capacity() * sizeof(HopBitmap) + occupancy.bytesUsed() + hashes.capacity() * sizeof(size_t) +
+                   keys.capacity() * sizeof(KeyType) + values.capacity() * sizeof(ValueType);
+        }
+
+        template <typename Value>
+        void setValue(unsigned int index, Value&& value) {
+            values[index] = std::forward<Value>(value);
+        }
+
+        void transfer(unsigned int index, Buckets& from, unsigned int fromIndex) {
+            keys[index] = std::move(from.keys[fromIndex]);
+            values[index] = std::move(from.values[fromIndex]);
+            hashes[index] = from.hashes[fromIndex];
+        }
+
+        void clearEntry(unsigned int index) {
+            keys[index] = KeyType();
+            values[index] = ValueType();
+        }
+
+        void shareStorage(const Buckets&) {}
+
+        size_t storageBytesUsed() const {
+            return 0;
+        }
+
+        static constexpr bool PARALLEL_PLACEMENT = true;
+
+    private:
+        std::vector<HopBitmap> hopInfo;
+        OccupancyBitmap occupancy;
+        std::vector<size_t> hashes;
+        std::vector<KeyType> keys;
+        std::vector<ValueType> values;
+    };
+};
+
+/**
+ * Keeps every value in a ValueSlab shared by all the bucket arrays of a table, and only an 8-byte pointer to it in the
+ * bucket. Displacements, rehashes and migrations move the pointers, so large values are never copied or moved, and
+ * references to values stay valid until their key is removed. Empty buckets point at a shared default value.
+ *
+ * The bucket arrays of a table share one slab, so tables using this layout can be moved but not copied. The slab is
+ * not thread-safe, so bulk builds place entries on a single thread.
+ */
+struct SlabValueLayout {
+    template <typename KeyType, typename ValueType, typename HopBitmap>
+    class Buckets {
+    public:
+        using Ref = BucketRef<KeyType, ValueType, HopBitmap, false>;
+        using ConstRef = BucketRef<KeyType, ValueType, HopBitmap, true>;
+
+        Buckets() = default;
+        explicit Buckets(unsigned int size)
+                : hopInfo(size, 0), occupancy(size), hashes(size, 0), keys(size), handles(size, vacantValue()),
+                  slab(std::make_shared<ValueSlab<ValueType>>()) {}
+        Buckets(const Buckets&) = delete;
+        Buckets& operator=(const Buckets&) = delete;
+        Buckets(Buckets&&) = default;
+        Buckets& operator=(Buckets&&) = default;
+
+        Ref operator[](unsigned int index) {
+            return Ref{keys[index], *handles[index], occupancy[index], hopInfo[index], hashes[index]};
+        }
+
+        ConstRef operator[](unsigned int index) const {
+            return ConstRef{keys[index], *handles[index], occupancy[index], hopInfo[index], hashes[index]};
+        }
+
+        void prefetch(unsigned int index) const {
+            prefetchForRead(&hopInfo[index]);
+            prefetchForRead(&hashes[index]);
+        }
+
+        unsigned int nextOccupied(unsigned int index, unsigned int end) const {
+            return occupancy.next(index, end);
+        }
+
+        // The slab belongs to the table rather than to one array, so it is kept by assign(), swap() and release()
+        void assign(unsigned int size) {
+            hopInfo.assign(size, 0);
+            occupancy.assign(size);
+            hashes.assign(size, 0);
+            keys.assign(size, KeyType());
+            handles.assign(size, vacantValue());
+
+            if (!slab) slab = std::make_shared<ValueSlab<ValueType>>();
+        }
+
+        void swap(Buckets& other) {
+            hopInfo.swap(other.hopInfo);
+            occupancy.swap(other.occupancy);
+            hashes.swap(other.hashes);
+            keys.swap(other.keys);
+            handles.swap(other.handles);
+        }
+
+        void release() {
+            std::vector<HopBitmap>().swap(hopInfo);
+            occupancy.release();
+            std::vector<size_t>().swap(hashes);
+            std::vector<KeyType>().swap(keys);
+            std::vector<ValueType*>().swap(handles);
+        }
+
+        size_t bytesUsed() const {
+            return hopInfo.capacity() * sizeof(HopBitmap) + occupancy.bytesUsed() + hashes.capacity() * sizeof(size_t) +
+                   keys.capacity() * sizeof(KeyType) + handles.capacity() * sizeof(ValueType*);
+        }
+
+        template <typename Value>
+        void setValue(unsigned int index, Value&& value) {
+            if (handles[index] == vacantValue()) {
+                handles[index] = slab->allocate(std::forward<Value>(value));
+            } else {
+                *handles[index] = std::forward<Value>(value);
+            }
+        }
+
+        void transfer(unsigned int index, Buckets& from, unsigned int fromIndex) {
+            keys[index] = std::move(from.keys[fromIndex]);
+            hashes[index] = from.hashes[fromIndex];
+            handles[index] = from.handles[fromIndex];
+            from.handles[fromIndex] = vacantValue();
+        }
+
+        void clearEntry(unsigned int index) {
+            keys[index] = KeyType();
+
+            if (handles[index] != vacantValue()) slab->release(handles[index]);
+
+            handles[index] = vacantValue();
+        }
+
+        void shareStorage(const Buckets& other) {
+            slab = other.slab;
+        }
+
+        size_t storageBytesUsed() const {
+            return slab ? slab->bytesUsed() : 0;
+        }
+
+        static constexpr bool PARALLEL_PLACEMENT = false;
+
+    private:
+        std::vector<HopBitmap> hopInfo;
+        OccupancyBitmap occupancy;
+        std::vector<size_t> hashes;
+        std::vector<KeyType> keys;
+        std::vector<ValueType*> handles;
+        std::shared_ptr<ValueSlab<ValueType>> slab;
+
+        // Never written: setValue() replaces the pointer before anything is stored
+        static ValueType* vacantValue() {
+            static ValueType vacant{};
+            return &vacant;
+        }
+    };
+};
+
+/**
+ * Bundles the compile-time policies of a HashTable. All of them are stateless and called statically, so picking a
+ * different combination costs nothing at run time.
+ *
+ * @tparam Hasher Hashes keys (and their views, for heterogeneous lookup)
+ * @tparam KeyEqual Compares stored keys with looked up keys (or their views)
+ * @tparam GrowthPolicy Picks the next table size when the table grows
+ * @tparam IndexMapping Maps hashes to bucket indices
+ * @tparam Layout Stores the buckets
+ */
+template <typename KeyType, typename Hasher = DefaultHasher<KeyType>, typename KeyEqual = std::equal_to<>,
+          typename GrowthPolicy = DoublingGrowth, typename IndexMapping = ModuloIndexMapping,
+          typename Layout = ArrayOfStructsLayout>
+struct HashTablePolicy {
+    using hasher = Hasher;
+    using key_equal = KeyEqual;
+    using growth_policy = GrowthPolicy;
+    using index_mapping = IndexMapping;
+    using layout = Layout;
+};
+
+// The default policies with values kept out of line, for tables whose values are large or must not move
+template <typename KeyType>
+using SlabValuePolicy = HashTablePolicy<KeyType, DefaultHasher<KeyType>, std::equal_to<>, DoublingGrowth,
+                                        ModuloIndexMapping, SlabValueLayout>;
+
+template <typename KeyType, typename ValueType, unsigned int H = 32, typename Policy = HashTablePolicy<KeyType>>
+class HashTable {
+private:
+    static_assert(H > 0 && H <= 64, "The hopscotch neighbourhood must fit in a 64-bit bitmap");
+    static constexpr unsigned int HOP_RANGE = H;
+    // Number of lookups whose home buckets searchBatch() loads at the same time
+    static constexpr unsigned int BATCH_SIZE = 16;
+    // Bit i of a bucket's hopInfo is set when bucket (home + i) holds an entry whose home bucket is this one
+    using HopBitmap = typename std::conditional<(H <= 32), std::uint32_t, std::uint64_t>::type;
+
+    using Buckets = typename Policy::layout::template Buckets<KeyType, ValueType, HopBitmap>;
+    using Hasher = typename Policy::hasher;
+    using KeyEqual = typename Policy::key_equal;
+    using GrowthPolicy = typename Policy::growth_policy;
+    using IndexMapping = typename Policy::index_mapping;
+    using KeyView = typename HashKeyView<KeyType>::type;
+    // Lookups by anything convertible to the key's view (but not the key itself) go through the view overloads
+    template <typename LookupKey>
+    using EnableIfLookupKey = typename std::enable_if<!std::is_same<KeyView, const KeyType&>::value &&
+                                                      !std::is_same<typename std::decay<LookupKey>::type, KeyType>::value &&
+                                                      std::is_convertible<const LookupKey&, KeyView>::value &&
+                                                      std::is_invocable<const Hasher&, KeyView>::value>::type;
+
 public:
     unsigned int tableSize;
     double loadFactorThreshold;
-    std::vector<Bucket> hashTable;
+    Buckets hashTable;
     class Iterator {
     public:
-        Iterator(typename std::vector<Bucket>::iterator current, typename std::vector<Bucket>::iterator end)
-                : current(current), end(end) {}
+        Iterator(Buckets* buckets, unsigned int current, unsigned int end)
+                : buckets(buckets), current(current), end(end) {}
 
         Iterator& operator++() {
-            ++current;
-            while (current != end && !current->occupied) {
-                ++current;
-            }
+            current = buckets->nextOccupied(current + 1, end);
             return *this;
         }
 
@@ -51,37 +593,115 @@ public:
             return current == other.current;
         }
 
-        typename std::vector<Bucket>::iterator operator*() {
-            return current;
+        typename Buckets::Ref operator*() {
+            return (*buckets)[current];
         }
 
     private:
-        typename std::vector<Bucket>::iterator current;
-        typename std::vector<Bucket>::iterator end;
+        Buckets* buckets;
+        unsigned int current;
+        unsigned int end;
     };
     // TODO implement the following functions in ../src/HashTable.cpp
     //Hint: you will also need to implement a hashKey function which will allow you to
     // create hash values for different KeyTypes
     explicit HashTable(unsigned int size = 100, double threshold = 0.7);
+    template <typename Range>
+    static HashTable buildFrom(const Range& entries, double threshold = 0.7, unsigned int threadCount = 1);
     Iterator begin();
     Iterator end();
     ValueType& operator[](const KeyType& key);
-    void updateValueForKey(const KeyType& key, ValueType newValue);
-    void insert(const KeyType& key, const ValueType& value);
+    template <typename LookupKey, typename = EnableIfLookupKey<LookupKey>>
+    ValueType& operator[](const LookupKey& key);
+    bool updateValueForKey(const KeyType& key, ValueType newValue);
+    bool insert(const KeyType& key, const ValueType& value);
+    template <typename... Args>
+    std::pair<ValueType&, bool> try_emplace(const KeyType& key, Args&&... args);
+    template <typename Value>
+    std::pair<ValueType&, bool> insert_or_assign(const KeyType& key, Value&& value);
+    std::pair<ValueType&, bool> findOrInsert(const KeyType& key);
+    template <typename LookupKey, typename = EnableIfLookupKey<LookupKey>>
+    std::pair<ValueType&, bool> findOrInsert(const LookupKey& key);
+    template <typename Function>
+    bool upsert(const KeyType& key, Function&& function);
+    template <typename LookupKey, typename Function, typename = EnableIfLookupKey<LookupKey>>
+    bool upsert(const LookupKey& key, Function&& function);
     ValueType* search(const KeyType& key);
+    template <typename LookupKey, typename = EnableIfLookupKey<LookupKey>>
+    ValueType* search(const LookupKey& key);
+    template <typename LookupKeys>
+    void searchBatch(const LookupKeys& keys, std::vector<ValueType*>& results);
     bool remove(const KeyType& key);
+    template <typename LookupKey, typename = EnableIfLookupKey<LookupKey>>
+    bool remove(const LookupKey& key);
     void clear();
+    void reserve(unsigned int count);
+    void compact(double targetLoadFactor = 0.5);
     unsigned int size() const;
     double loadFactor() const;
+    HashTableStats stats() const;
+    void setIncrementalRehash(bool enabled, unsigned int bucketsPerStep = 64);
+    bool isRehashing() const;
+    void setShrinkThreshold(double threshold);
 
 private:
-    unsigned int hopRange = HOP_RANGE;
+    // While an incremental rehash is in progress, oldTable holds the buckets that have not been migrated yet
+    Buckets oldTable;
+    unsigned int oldTableSize = 0;
+    unsigned int migrationIndex = 0;
+    bool incrementalRehash = false;
+    unsigned int migrationStep = 64;
+    // Removals shrink the table once its load factor falls below shrinkThreshold, but never below minimumTableSize
+    unsigned int minimumTableSize;
+    double shrinkThreshold;
+    unsigned int elementCount = 0;
+    unsigned long long displacementCount = 0;
+    unsigned int rehashCount = 0;
+    unsigned int shrinkCount = 0;
+    std::chrono::nanoseconds rehashTime{0};
+
+    // An entry of a bulk build, sorted by home bucket before it is placed
+    template <typename Entry>
+    struct BulkEntry {
+        unsigned int home;
+        size_t hash;
+        const Entry* entry;
+    };
+
     // TODO implement the following functions in ../src/HashTable.cpp
-    unsigned int findFreeSlot(std::vector<Bucket>& cTable, unsigned int startIndex, unsigned int& currentHop);
+    int findFreeSlot(Buckets& cTable, unsigned int startIndex, unsigned int& currentHop);
     void rehash();
+    void rebuild(unsigned int newTableSize);
+    void resize(unsigned int newTableSize);
+    void shrinkIfSparse();
+    void migrateBuckets(unsigned int count);
+    unsigned int neighbourhoodSize() const;
+    unsigned int grownSize(unsigned int size) const;
+    template <typename LookupKey>
+    int findIndex(const Buckets& table, unsigned int size, const LookupKey& key) const;
+    template <typename LookupKey>
+    int findIndex(const Buckets& table, unsigned int size, const LookupKey& key, size_t hash) const;
+    template <typename LookupKey>
+    int findIndex(const Buckets& table, unsigned int size, const LookupKey& key, size_t hash, unsigned int home) const;
+    template <typename LookupKey>
+    ValueType* findValue(const LookupKey& key);
+    template <typename LookupKey>
+    ValueType* findValue(const LookupKey& key, size_t hash);
+    template <typename LookupKey, typename MakeValue>
+    std::pair<ValueType&, bool> findOrPlace(const LookupKey& key, MakeValue&& makeValue);
+    template <typename LookupKey>
+    bool removeKey(const LookupKey& key);
+    template <typename Entry>
+    unsigned int placeSorted(const std::vector<BulkEntry<Entry>>& entries, size_t first, size_t last,
+                             unsigned int limit, std::vector<const BulkEntry<Entry>*>& deferred);
+    void vacate(Buckets& table, unsigned int size, unsigned int index);
+    template <typename Key, typename Value>
+    int place(size_t hash, Key&& key, Value&& value);
+    int claim(size_t hash);
+    bool moveFreeSlotCloser(unsigned int& freeIndex, unsigned int& distance);
 };
 
 #include "../src/HashTable.cpp"
 
 
-#endif //HASHTABLE_H
\ No newline at end of file
+#endif //HASHTABLE_H
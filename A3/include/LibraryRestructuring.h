@@ -12,6 +12,7 @@
 #include "Utils.h"
 #include "UnorderedSet.h"
 #include "HashTable.h"
+#include "StaticHashTable.h"
 #include "RadixSort.h"
 #include "MergeSort.h"
 
@@ -31,8 +32,9 @@ private:
     HashTable<std::string, UnorderedSet<std::string>> graph;
     // Stores the sum of borrowing time for each book
     HashTable<std::string, int> bookBorrowingTime;
-    // Stores all the available books in the library, created when the constructor is called
-    HashTable<std::string, Book> allBooks;
+    // Stores all the available books in the library, created when the constructor is called. The catalogue never
+    // changes afterwards, so it is built once over a perfect hash function and every lookup reads a single entry.
+    StaticHashTable<std::string, Book> allBooks;
     // TODO implement the following functions in ../src/LibraryRestructuring.cpp
     // perform a DFS search to find all the nodes connected to the pointed current ISBN
     void dfs(const std::string& current, std::vector<std::string>& cluster, HashTable<std::string, bool>& visited);
@@ -9,10 +9,14 @@
 LibraryRestructuring::LibraryRestructuring(
     const UnorderedSet<BorrowRecord> &records,
     const UnorderedSet<Book> &bookCollection
-) : graph(bookCollection.size() * 2),
-    bookBorrowingTime(bookCollection.size() * 2),
-    allBooks(bookCollection.size() * 2) {
+) {
     auto bookCollectionIter = bookCollection.begin();
+    std::vector<std::pair<std::string, Book>> books;
+
+    // Size the tables for the whole collection up front, so they never rehash while being filled
+    graph.reserve(bookCollection.size());
+    bookBorrowingTime.reserve(bookCollection.size());
+    books.reserve(bookCollection.size());
 
     // Store the book collection, initialize the graph with the books' ISBN as the key, and initialize each book's borrowing
     // time
@@ -20,25 +24,23 @@ LibraryRestructuring::LibraryRestructuring(
         const Book book = *bookCollectionIter;
         const UnorderedSet<std::string> bookAdjacencyList{};
 
-        allBooks.insert(book.ISBN, book);
+        books.emplace_back(book.ISBN, book);
         graph.insert(book.ISBN, bookAdjacencyList);
         bookBorrowingTime[book.ISBN] = 0;
 
         ++bookCollectionIter;
     }
 
+    allBooks = StaticHashTable<std::string, Book>(books);
+
     auto recordsIter = records.begin();
 
     // Calculate each book's borrowing time
     while (recordsIter != records.end()) {
         const BorrowRecord &record = *recordsIter;
-        const auto *borrowingTime = bookBorrowingTime.search(record.bookISBN);
+        const int duration = Date::diffDuration(record.returnDate, record.checkoutDate);
 
-        if (borrowingTime == nullptr) {
-            bookBorrowingTime[record.bookISBN] = Date::diffDuration(record.returnDate, record.checkoutDate);
-        } else {
-            bookBorrowingTime[record.bookISBN] += Date::diffDuration(record.returnDate, record.checkoutDate);
-        }
+        bookBorrowingTime.upsert(record.bookISBN, [duration](int &borrowingTime) { borrowingTime += duration; });
 
         auto iter = recordsIter;
 
@@ -78,7 +80,7 @@ std::vector<std::vector<std::string> > LibraryRestructuring::clusterAndSort(cons
     HashTable<std::string, bool> visited(allBooks.size() * 2);
 
     for (const auto &book: allBooks) {
-        if (book->occupied) visited[book->key] = false;
+        visited[book->key] = false;
     }
 
     auto visitedIter = visited.begin();
@@ -158,9 +160,14 @@ void LibraryRestructuring::dfs(const std::string &current, std::vector<std::stri
  */
 double LibraryRestructuring::getAverageBorrowingTime(const std::vector<std::string> &cluster) {
     double sum = 0;
+    std::vector<int *> borrowingTimes;
+
+    // Every book of the cluster is looked up at once, so that their buckets are loaded in parallel
+    bookBorrowingTime.searchBatch(cluster, borrowingTimes);
 
-    for (const std::string &isbn: cluster) {
-        sum += bookBorrowingTime[isbn];
+    for (const int *borrowingTime: borrowingTimes) {
+        // A book that is not part of the collection counts as 0 days
+        if (borrowingTime != nullptr) sum += *borrowingTime;
     }
 
     return sum / cluster.size();
@@ -0,0 +1,337 @@
+#include "../include/StaticHashTable.h"
+
+template<typename KeyType, typename ValueType, typename Hasher>
+constexpr unsigned int StaticHashTable<KeyType, ValueType, Hasher>::BUCKET_SIZE;
+
+template<typename KeyType, typename ValueType, typename Hasher>
+constexpr double StaticHashTable<KeyType, ValueType, Hasher>::POSITION_LOAD;
+
+template<typename KeyType, typename ValueType, typename Hasher>
+constexpr unsigned int StaticHashTable<KeyType, ValueType, Hasher>::MAX_PILOT;
+
+template<typename KeyType, typename ValueType, typename Hasher>
+constexpr unsigned int StaticHashTable<KeyType, ValueType, Hasher>::MAX_SEEDS;
+
+/**
+ * Constructor. Builds the table from a range of (key, value) pairs, such as a std::vector<std::pair<KeyType, ValueType>>
+ * or a std::map. When a key appears more than once, its first occurrence is kept.
+ *
+ * @param source The (key, value) pairs to build the table from; its iterators must yield references, not copies
+ * @throws std::runtime_error If no perfect hash function was found, which is astronomically unlikely
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+template<typename Range>
+StaticHashTable<KeyType, ValueType, Hasher>::StaticHashTable(const Range &source) {
+    using Source = typename std::decay<decltype(*std::begin(source))>::type;
+
+    // The keys being placed point into the range, so it has to hold its pairs rather than produce them on the fly
+    static_assert(std::is_lvalue_reference<decltype(*std::begin(source))>::value,
+                  "StaticHashTable needs a range whose iterators yield references to stored pairs");
+
+    std::vector<const Source *> sources;
+
+    for (const Source &entry: source) {
+        sources.push_back(&entry);
+    }
+
+    std::vector<PendingKey> keys;
+    bool built = false;
+
+    // A different seed gives a different hash function; one is enough unless two keys share a 64-bit hash
+    for (unsigned int attempt = 0; attempt < MAX_SEEDS && !built; ++attempt) {
+        seed = mix(attempt);
+        keys.clear();
+
+        for (size_t i = 0; i < sources.size(); ++i) {
+            keys.push_back({keyHash(sources[i]->first), i, 0, 0});
+        }
+
+        // Sorting by hash brings duplicate keys together, with their first occurrence first
+        std::sort(keys.begin(), keys.end(), [](const PendingKey &a, const PendingKey &b) {
+            return a.hash != b.hash ? a.hash < b.hash : a.source < b.source;
+        });
+
+        bool hashCollision = false;
+        size_t uniqueCount = 0;
+
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (uniqueCount > 0 && keys[uniqueCount - 1].hash == keys[i].hash) {
+                // Identical keys collapse into one; different keys with the same hash need another seed
+                if (!std::equal_to<>{}(sources[keys[uniqueCount - 1].source]->first, sources[keys[i].source]->first)) {
+                    hashCollision = true;
+                    break;
+                }
+
+                continue;
+            }
+
+            keys[uniqueCount++] = keys[i];
+        }
+
+        if (hashCollision) continue;
+
+        keys.resize(uniqueCount);
+
+        const auto keyCount = static_cast<unsigned int>(keys.size());
+
+        positionCount = std::max(keyCount, static_cast<unsigned int>(keyCount / POSITION_LOAD));
+        pilots.assign(std::max(1u, (keyCount + BUCKET_SIZE - 1) / BUCKET_SIZE), 0);
+
+        for (PendingKey &key: keys) {
+            key.bucket = FastRangeIndexMapping::index(key.hash, static_cast<unsigned int>(pilots.size()));
+        }
+
+        built = findPilots(keys);
+    }
+
+    if (!built) throw std::runtime_error("Failed to build a perfect hash function");
+
+    // Make the hash minimal: every taken position past the last slot moves into a free slot below it
+    const auto keyCount = static_cast<unsigned int>(keys.size());
+    std::vector<bool> taken(positionCount, false);
+
+    for (const PendingKey &key: keys) {
+        taken[key.position] = true;
+    }
+
+    remapped.assign(positionCount - keyCount, 0);
+
+    for (unsigned int position = keyCount, freeSlot = 0; position < positionCount; ++position) {
+        if (!taken[position]) continue;
+
+        while (taken[freeSlot]) {
+            freeSlot += 1;
+        }
+
+        remapped[position - keyCount] = freeSlot++;
+    }
+
+    entries.resize(keyCount);
+
+    for (const PendingKey &key: keys) {
+        Entry &entry = entries[key.position < keyCount ? key.position : remapped[key.position - keyCount]];
+
+        entry.fingerprint = static_cast<std::uint32_t>(key.hash);
+        entry.key = sources[key.source]->first;
+        entry.value = sources[key.source]->second;
+    }
+}
+
+/**
+ * Returns the beginning of the table.
+ *
+ * @return The beginning of the table
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+typename StaticHashTable<KeyType, ValueType, Hasher>::Iterator StaticHashTable<KeyType, ValueType, Hasher>::begin() {
+    return Iterator(entries.data());
+}
+
+/**
+ * Returns the end of the table.
+ *
+ * @return The end of the table
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+typename StaticHashTable<KeyType, ValueType, Hasher>::Iterator StaticHashTable<KeyType, ValueType, Hasher>::end() {
+    return Iterator(entries.data() + entries.size());
+}
+
+/**
+ * Returns the value of the key if it exists. Reads the pilot of the key's bucket and then exactly one entry; keys are
+ * only compared when the entry's fingerprint matches.
+ *
+ * @param key The key (or a view of it) to search for
+ * @return The value of the key if it exists
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+ValueType *StaticHashTable<KeyType, ValueType, Hasher>::search(const KeyView key) {
+    return const_cast<ValueType *>(static_cast<const StaticHashTable *>(this)->search(key));
+}
+
+/**
+ * Returns the value of the key if it exists.
+ *
+ * @param key The key (or a view of it) to search for
+ * @return The value of the key if it exists
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+const ValueType *StaticHashTable<KeyType, ValueType, Hasher>::search(const KeyView key) const {
+    if (entries.empty()) return nullptr;
+
+    const std::uint64_t hash = keyHash(key);
+    const Entry &entry = entries[slot(hash)];
+
+    if (entry.fingerprint != static_cast<std::uint32_t>(hash) || !std::equal_to<>{}(entry.key, key)) return nullptr;
+
+    return &entry.value;
+}
+
+/**
+ * Returns whether the key exists in the table.
+ *
+ * @param key The key (or a view of it) to search for
+ * @return Whether the key exists
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+bool StaticHashTable<KeyType, ValueType, Hasher>::contains(const KeyView key) const {
+    return search(key) != nullptr;
+}
+
+/**
+ * Returns the number of items in the table.
+ *
+ * @return The number of items in the table
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+unsigned int StaticHashTable<KeyType, ValueType, Hasher>::size() const {
+    return static_cast<unsigned int>(entries.size());
+}
+
+/**
+ * Returns the size of the perfect hash function (the pilots and the remapped positions) in bits per key. The 32-bit
+ * fingerprints stored next to the entries are not included.
+ *
+ * @return The number of bits the perfect hash function takes per key
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+double StaticHashTable<KeyType, ValueType, Hasher>::bitsPerKey() const {
+    if (entries.empty()) return 0;
+
+    const double bits = pilots.size() * 8.0 * sizeof(std::uint16_t) + remapped.size() * 8.0 * sizeof(std::uint32_t);
+
+    return bits / entries.size();
+}
+
+/**
+ * Mixes every bit of the value into every other one with the SplitMix64 finalizer.
+ *
+ * @param value The value to mix
+ * @return The mixed value
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+std::uint64_t StaticHashTable<KeyType, ValueType, Hasher>::mix(std::uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+
+    return value ^ (value >> 31);
+}
+
+/**
+ * Returns the 64-bit hash of the key under the current seed.
+ *
+ * @param key The key (or a view of it) to hash
+ * @return The hash of the key
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+std::uint64_t StaticHashTable<KeyType, ValueType, Hasher>::keyHash(const KeyView key) const {
+    return mix(static_cast<std::uint64_t>(Hasher{}(key)) ^ seed);
+}
+
+/**
+ * Returns the position a key with the given hash takes under the given pilot.
+ *
+ * @param hash The hash of the key
+ * @param pilot The pilot of the key's bucket
+ * @return The position of the key, smaller than positionCount
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+unsigned int StaticHashTable<KeyType, ValueType, Hasher>::position(const std::uint64_t hash,
+                                                                   const unsigned int pilot) const {
+    return FastRangeIndexMapping::index(mix(hash ^ mix(pilot + seed)), positionCount);
+}
+
+/**
+ * Returns the slot of the entry a key with the given hash would be stored in.
+ *
+ * @param hash The hash of the key
+ * @return The slot of the key's entry
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+unsigned int StaticHashTable<KeyType, ValueType, Hasher>::slot(const std::uint64_t hash) const {
+    const unsigned int bucket = FastRangeIndexMapping::index(hash, static_cast<unsigned int>(pilots.size()));
+    const unsigned int keyPosition = position(hash, pilots[bucket]);
+
+    return keyPosition < entries.size() ? keyPosition : remapped[keyPosition - entries.size()];
+}
+
+/**
+ * Finds a pilot for every bucket, from the largest bucket to the smallest, such that all the keys of the bucket land on
+ * distinct positions that no earlier bucket took. Sets the position of every key.
+ *
+ * @param keys The keys to place, with their bucket set; reordered by bucket
+ * @return Whether every bucket got a pilot; false means another seed must be tried
+ */
+template<typename KeyType, typename ValueType, typename Hasher>
+bool StaticHashTable<KeyType, ValueType, Hasher>::findPilots(std::vector<PendingKey> &keys) {
+    const auto bucketCount = static_cast<unsigned int>(pilots.size());
+    std::vector<unsigned int> bucketStarts(bucketCount + 1, 0);
+
+    // Counting sort of the keys by bucket
+    for (const PendingKey &key: keys) {
+        bucketStarts[key.bucket + 1] += 1;
+    }
+
+    for (unsigned int i = 0; i < bucketCount; ++i) {
+        bucketStarts[i + 1] += bucketStarts[i];
+    }
+
+    std::vector<PendingKey> sortedKeys(keys.size());
+    std::vector<unsigned int> nextKey(bucketStarts.begin(), bucketStarts.end() - 1);
+
+    for (const PendingKey &key: keys) {
+        sortedKeys[nextKey[key.bucket]++] = key;
+    }
+
+    keys.swap(sortedKeys);
+
+    std::vector<unsigned int> bucketOrder(bucketCount);
+
+    for (unsigned int i = 0; i < bucketCount; ++i) {
+        bucketOrder[i] = i;
+    }
+
+    // Large buckets are the hardest to place, so they go first while most positions are still free
+    std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&bucketStarts](unsigned int a, unsigned int b) {
+        return bucketStarts[a + 1] - bucketStarts[a] > bucketStarts[b + 1] - bucketStarts[b];
+    });
+
+    std::vector<std::uint64_t> takenPositions((positionCount + 63) / 64, 0);
+    std::vector<unsigned int> candidates;
+
+    for (const unsigned int bucket: bucketOrder) {
+        const unsigned int first = bucketStarts[bucket];
+        const unsigned int last = bucketStarts[bucket + 1];
+
+        if (first == last) break;
+
+        bool placed = false;
+
+        for (unsigned int pilot = 0; pilot <= MAX_PILOT && !placed; ++pilot) {
+            candidates.clear();
+            placed = true;
+
+            for (unsigned int i = first; i < last && placed; ++i) {
+                const unsigned int candidate = position(keys[i].hash, pilot);
+
+                placed = !((takenPositions[candidate / 64] >> (candidate % 64)) & 1) &&
+                         std::find(candidates.begin(), candidates.end(), candidate) == candidates.end();
+                candidates.push_back(candidate);
+            }
+
+            if (!placed) continue;
+
+            pilots[bucket] = static_cast<std::uint16_t>(pilot);
+
+            for (unsigned int i = first; i < last; ++i) {
+                keys[i].position = candidates[i - first];
+                takenPositions[keys[i].position / 64] |= static_cast<std::uint64_t>(1) << (keys[i].position % 64);
+            }
+        }
+
+        if (!placed) return false;
+    }
+
+    return true;
+}
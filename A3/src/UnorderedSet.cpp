@@ -1,17 +1,232 @@
 #include "../include/UnorderedSet.h"
 
+template<typename Key>
+constexpr size_t NodeSlab<Key>::FIRST_SLAB_SIZE;
+
+template<typename Key>
+constexpr size_t NodeSlab<Key>::MAX_SLAB_SIZE;
+
 /**
- * Constructor
+ * Destructor. Frees the slabs; the nodes in them must have been released or freed already.
+ */
+template<typename Key>
+NodeSlab<Key>::~NodeSlab() {
+    release(nullptr);
+}
+
+/**
+ * Move constructor. The other slab is left empty.
+ *
+ * @param other The slab to take the nodes from
+ */
+template<typename Key>
+NodeSlab<Key>::NodeSlab(NodeSlab &&other) noexcept
+        : lastSlab(other.lastSlab), lastSlabUsed(other.lastSlabUsed), freeSlots(other.freeSlots) {
+    other.lastSlab = nullptr;
+    other.lastSlabUsed = 0;
+    other.freeSlots = nullptr;
+}
+
+/**
+ * Move assignment. Swaps the slabs, so the other slab frees this one's slabs when it is destroyed.
+ *
+ * @param other The slab to take the nodes from
+ * @return This slab
+ */
+template<typename Key>
+NodeSlab<Key> &NodeSlab<Key>::operator=(NodeSlab &&other) noexcept {
+    std::swap(lastSlab, other.lastSlab);
+    std::swap(lastSlabUsed, other.lastSlabUsed);
+    std::swap(freeSlots, other.freeSlots);
+
+    return *this;
+}
+
+/**
+ * Constructs a node for the given key in a free slot if there is one, or else in the next unused slot, adding a slab
+ * twice the size of the last one when it is full.
+ *
+ * @param key The key of the node
+ * @return The new node
+ */
+template<typename Key>
+Node<Key> *NodeSlab<Key>::allocate(const Key &key) {
+    Slot *slot = freeSlots;
+
+    if (slot != nullptr) {
+        freeSlots = nextFree(slot);
+    } else {
+        if (lastSlab == nullptr || lastSlabUsed == header(lastSlab).size) {
+            const size_t size = lastSlab == nullptr ? FIRST_SLAB_SIZE : std::min(2 * header(lastSlab).size,
+                                                                                  MAX_SLAB_SIZE);
+            // Slot 0 of the new slab holds its header
+            Slot *slab = new Slot[size + 1];
+
+            new(slab) SlabHeader{lastSlab, size};
+            lastSlab = slab;
+            lastSlabUsed = 0;
+        }
+
+        lastSlabUsed += 1;
+        slot = lastSlab + lastSlabUsed;
+    }
+
+    return new(slot) Node<Key>(key);
+}
+
+/**
+ * Destroys the given node and puts its slot on the free list.
+ *
+ * @param node The node to free
+ */
+template<typename Key>
+void NodeSlab<Key>::free(Node<Key> *node) {
+    node->~Node<Key>();
+
+    Slot *slot = reinterpret_cast<Slot *>(node);
+
+    nextFree(slot) = freeSlots;
+    freeSlots = slot;
+}
+
+/**
+ * Destroys every node of the given tree, then frees all the slabs, so the cost is one deallocation per slab. Keys that
+ * are trivially destructible are not visited at all.
+ *
+ * @param root The root of the tree whose nodes live in this slab, or nullptr
  */
 template<typename Key>
-UnorderedSet<Key>::UnorderedSet() : root(nullptr), setSize(0) {
+void NodeSlab<Key>::release(Node<Key> *root) {
+    if (!std::is_trivially_destructible<Key>::value) destroyTree(root);
+
+    while (lastSlab != nullptr) {
+        Slot *previous = header(lastSlab).previous;
+
+        delete[] lastSlab;
+        lastSlab = previous;
+    }
+
+    lastSlabUsed = 0;
+    freeSlots = nullptr;
 }
 
 /**
- * Destructor
+ * Returns the number of bytes held by the slabs, not counting memory owned by the keys.
+ *
+ * @return The number of bytes used by the slabs
  */
 template<typename Key>
-UnorderedSet<Key>::~UnorderedSet() = default;
+size_t NodeSlab<Key>::bytesUsed() const {
+    size_t bytes = 0;
+
+    for (Slot *slab = lastSlab; slab != nullptr; slab = header(slab).previous) {
+        bytes += (header(slab).size + 1) * sizeof(Slot);
+    }
+
+    return bytes;
+}
+
+/**
+ * Returns the header stored in the first slot of a slab.
+ *
+ * @param slab The first slot of the slab
+ * @return The header of the slab
+ */
+template<typename Key>
+typename NodeSlab<Key>::SlabHeader &NodeSlab<Key>::header(Slot *slab) {
+    return *std::launder(reinterpret_cast<SlabHeader *>(slab));
+}
+
+/**
+ * Returns the link to the next free slot, stored in a free slot's bytes.
+ *
+ * @param slot The free slot
+ * @return The link to the next free slot
+ */
+template<typename Key>
+typename NodeSlab<Key>::Slot *&NodeSlab<Key>::nextFree(Slot *slot) {
+    return *reinterpret_cast<Slot **>(slot->bytes);
+}
+
+/**
+ * Recursively destroys the nodes of the given subtree without freeing their slots.
+ *
+ * @param node The root of the subtree to destroy
+ */
+template<typename Key>
+void NodeSlab<Key>::destroyTree(Node<Key> *node) {
+    if (node == nullptr) return;
+
+    destroyTree(node->left);
+    destroyTree(node->right);
+    node->~Node<Key>();
+}
+
+/**
+ * Constructor
+ */
+template<typename Key, typename Backend>
+UnorderedSet<Key, Backend>::UnorderedSet() : root(nullptr), setSize(0) {
+}
+
+/**
+ * Destructor. Releases the set's nodes together with their slabs.
+ */
+template<typename Key, typename Backend>
+UnorderedSet<Key, Backend>::~UnorderedSet() {
+    nodes.release(root);
+}
+
+/**
+ * Copy constructor. Copies every node of the other set into this set's own slab, keeping the tree's shape and colours,
+ * so the two sets can be changed independently.
+ *
+ * @param other The set to copy
+ */
+template<typename Key, typename Backend>
+UnorderedSet<Key, Backend>::UnorderedSet(const UnorderedSet &other) : root(nullptr), setSize(other.setSize) {
+    root = copyRecursive(other.root, nullptr);
+}
+
+/**
+ * Move constructor. Takes the other set's nodes and slab, leaving the other set empty.
+ *
+ * @param other The set to move from
+ */
+template<typename Key, typename Backend>
+UnorderedSet<Key, Backend>::UnorderedSet(UnorderedSet &&other) noexcept
+        : root(other.root), setSize(other.setSize), nodes(std::move(other.nodes)) {
+    other.root = nullptr;
+    other.setSize = 0;
+}
+
+/**
+ * Copy assignment. Replaces this set's keys with copies of the other set's keys.
+ *
+ * @param other The set to copy
+ * @return This set
+ */
+template<typename Key, typename Backend>
+UnorderedSet<Key, Backend> &UnorderedSet<Key, Backend>::operator=(const UnorderedSet &other) {
+    if (this != &other) *this = UnorderedSet(other);
+
+    return *this;
+}
+
+/**
+ * Move assignment. Swaps the keys of the two sets, so the other set releases this set's old nodes.
+ *
+ * @param other The set to move from
+ * @return This set
+ */
+template<typename Key, typename Backend>
+UnorderedSet<Key, Backend> &UnorderedSet<Key, Backend>::operator=(UnorderedSet &&other) noexcept {
+    std::swap(root, other.root);
+    std::swap(setSize, other.setSize);
+    std::swap(nodes, other.nodes);
+
+    return *this;
+}
 
 /**
  * Inserts the provided key into the unordered set. Insertion fails if the key already exists.
@@ -19,18 +234,24 @@ UnorderedSet<Key>::~UnorderedSet() = default;
  * @param key The key to insert
  * @return Whether the insertion was successful
  */
-template<typename Key>
-bool UnorderedSet<Key>::insert(const Key &key) {
-    // Check if the key already exists
-    if (search(key)) return false;
-
-    auto *newNode = new Node<Key>(key);
+template<typename Key, typename Backend>
+bool UnorderedSet<Key, Backend>::insert(const Key &key) {
     Node<Key> *currentNode = root;
-    Node<Key> *parent = currentNode;
+    Node<Key> *parent = nullptr;
+
+    // Find the insertion point, checking on the way whether the key already exists
+    while (currentNode != nullptr) {
+        if (key == currentNode->key) return false;
+
+        parent = currentNode;
+        currentNode = key < currentNode->key ? currentNode->left : currentNode->right;
+    }
+
+    Node<Key> *newNode = nodes.allocate(key);
 
     setSize += 1;
 
-    if (currentNode == nullptr) {
+    if (parent == nullptr) {
         newNode->color = Color::BLACK;
         root = newNode;
 
@@ -38,22 +259,17 @@ bool UnorderedSet<Key>::insert(const Key &key) {
     }
 
     newNode->color = Color::RED;
+    newNode->parent = parent;
 
-    while (currentNode != nullptr) {
-        if (key == currentNode->key) return false;
-
-        parent = currentNode;
-        currentNode = key < currentNode->key ? currentNode->left : currentNode->right;
-
-        if (currentNode == nullptr) {
-            newNode->parent = parent;
+    if (key < parent->key) {
+        parent->left = newNode;
+    } else {
+        parent->right = newNode;
+    }
 
-            if (key < parent->key) {
-                parent->left = newNode;
-            } else {
-                parent->right = newNode;
-            }
-        }
+    // Every node on the new node's path, just visited and still cached, gains one key
+    for (Node<Key> *ancestor = parent; ancestor != nullptr; ancestor = ancestor->parent) {
+        ancestor->size += 1;
     }
 
     if (newNode->color == Color::RED && parent->color == Color::RED) fixRedRedViolation(newNode);
@@ -64,52 +280,68 @@ bool UnorderedSet<Key>::insert(const Key &key) {
 }
 
 /**
- * Performs a left rotation around the given node.
+ * Performs a left rotation around the given node: the node, a right child, takes its parent's place and the parent
+ * becomes its left child.
  *
  * @param node The node to rotate around
  */
-template<typename Key>
-void UnorderedSet<Key>::rotateLeft(Node<Key> *node) {
+template<typename Key, typename Backend>
+void UnorderedSet<Key, Backend>::rotateLeft(Node<Key> *node) {
     Node<Key> *parent = node->parent;
 
-    node->parent = parent->parent;
-    parent->parent = node;
     parent->right = node->left;
+
+    if (parent->right != nullptr) parent->right->parent = parent;
+
+    replaceChild(parent, node);
     node->left = parent;
+    parent->parent = node;
 
-    if (node->parent != nullptr) {
-        if (node->key < node->parent->key) {
-            node->parent->left = node;
-        } else {
-            node->parent->right = node;
-        }
-    } else {
-        root = node;
-    }
+    resize(parent);
+    resize(node);
 }
 
 /**
- * Performs a right rotation around the given node.
+ * Performs a right rotation around the given node: the node, a left child, takes its parent's place and the parent
+ * becomes its right child.
  *
  * @param node The node to rotate around
  */
-template<typename Key>
-void UnorderedSet<Key>::rotateRight(Node<Key> *node) {
+template<typename Key, typename Backend>
+void UnorderedSet<Key, Backend>::rotateRight(Node<Key> *node) {
     Node<Key> *parent = node->parent;
 
-    node->parent = parent->parent;
-    parent->parent = node;
     parent->left = node->right;
+
+    if (parent->left != nullptr) parent->left->parent = parent;
+
+    replaceChild(parent, node);
     node->right = parent;
+    parent->parent = node;
 
-    if (node->parent != nullptr) {
-        if (node->key < node->parent->key) {
-            node->parent->left = node;
-        } else {
-            node->parent->right = node;
-        }
+    resize(parent);
+    resize(node);
+}
+
+/**
+ * Puts the replacement where the given node hangs from its parent, or makes it the root. Children are told apart by
+ * address rather than by key, since a deletion briefly leaves two nodes with the same key.
+ *
+ * @param node The node to replace
+ * @param replacement The node to hang in its place, or nullptr
+ */
+template<typename Key, typename Backend>
+void UnorderedSet<Key, Backend>::replaceChild(Node<Key> *node, Node<Key> *replacement) {
+    Node<Key> *parent = node->parent;
+
+    if (replacement != nullptr) replacement->parent = parent;
+
+    if (parent == nullptr) {
+        root = replacement;
+    } else if (parent->left == node) {
+        parent->left = replacement;
     } else {
-        root = node;
+        parent->right = replacement;
     }
 }
 
@@ -118,17 +350,23 @@ void UnorderedSet<Key>::rotateRight(Node<Key> *node) {
  *
  * @param node The node where the violation occurs
  */
-template<typename Key>
-void UnorderedSet<Key>::fixRedRedViolation(Node<Key> *node) {
+template<typename Key, typename Backend>
+void UnorderedSet<Key, Backend>::fixRedRedViolation(Node<Key> *node) {
     Node<Key> *parent = node->parent;
 
     // If the node is not red nor is its parent red, there is no red-red violation
     if (parent == nullptr || node->color != Color::RED || node->color != parent->color) return;
 
     Node<Key> *grandparent = parent->parent;
-    Node<Key> *uncle = nullptr;
 
-    if (grandparent != nullptr) uncle = parent->key < grandparent->key ? grandparent->right : grandparent->left;
+    // A red root is simply recoloured
+    if (grandparent == nullptr) {
+        parent->color = Color::BLACK;
+        return;
+    }
+
+    const bool parentIsLeft = grandparent->left == parent;
+    Node<Key> *uncle = parentIsLeft ? grandparent->right : grandparent->left;
 
     // If uncle is red
     if (uncle != nullptr && uncle->color == Color::RED) {
@@ -145,54 +383,42 @@ void UnorderedSet<Key>::fixRedRedViolation(Node<Key> *node) {
     // If uncle is black or null:
     else {
         // - LL and RR cases:
-        //   1. Rotate
+        //   1. Rotate the parent up
         //   2. Swap colours of grandparent and parent
         // - LR and RL case:
-        //   - Rotate
-        //   - Swap colours of grandparent and the inserted node
+        //   1. Rotate the inserted node up twice
+        //   2. Swap colours of grandparent and the inserted node
 
         // If L case
-        if (
-            grandparent != nullptr
-            && grandparent->left != nullptr
-            && grandparent->left->key == parent->key
-        ) {
+        if (parentIsLeft) {
             // If LL case
-            if (parent->left != nullptr && parent->left->key == node->key) {
-                // 1. Rotation
+            if (parent->left == node) {
                 rotateRight(parent);
-
-                // 2. Recolour
-                grandparent->color = grandparent->color == Color::RED ? Color::BLACK : Color::RED;
                 parent->color = Color::BLACK;
             }
             // If LR case
             else {
                 rotateLeft(node);
                 rotateRight(node);
+                node->color = Color::BLACK;
             }
         }
         // If R case
         else {
             // If RR case
-            if (parent->right != nullptr && parent->right->key == node->key) {
-                // 1. Rotation
+            if (parent->right == node) {
                 rotateLeft(parent);
-
-                // 2. Recolour
-                if (grandparent != nullptr)
-                    grandparent->color = grandparent->color == Color::RED
-                                             ? Color::BLACK
-                                             : Color::RED;
-
                 parent->color = Color::BLACK;
             }
             // If RL case
             else {
                 rotateRight(node);
                 rotateLeft(node);
+                node->color = Color::BLACK;
             }
         }
+
+        grandparent->color = Color::RED;
     }
 }
 
@@ -226,8 +452,8 @@ Node<Key> *findSuccessor(Node<Key> *node) {
  * @param key The key to search for in the set
  * @return Whether the key exists in the set
  */
-template<typename Key>
-bool UnorderedSet<Key>::search(const Key &key) const {
+template<typename Key, typename Backend>
+bool UnorderedSet<Key, Backend>::search(const Key &key) const {
     Node<Key> *current = root;
 
     while (current != nullptr) {
@@ -239,36 +465,133 @@ bool UnorderedSet<Key>::search(const Key &key) const {
     return false;
 }
 
-template<typename Key>
-size_t UnorderedSet<Key>::size() const {
+/**
+ * Returns the number of keys in the set.
+ *
+ * @return The number of keys in the set
+ */
+template<typename Key, typename Backend>
+size_t UnorderedSet<Key, Backend>::size() const {
     return getSize(root);
 }
 
 /**
- * Recursively calculates the size of the subtree rooted at the given node.
+ * Returns the number of keys in the set that are less than the given key, i.e. the position the key has or would have
+ * in sorted order.
  *
- * @param node The root node of the subtree to calculate the size of
+ * @param key The key to rank
+ * @return The number of keys less than the key
+ */
+template<typename Key, typename Backend>
+size_t UnorderedSet<Key, Backend>::rank(const Key &key) const {
+    return countBelow(key, false);
+}
+
+/**
+ * Returns the key at the given position in sorted order.
+ *
+ * @param index The position of the key, from 0 for the smallest key
+ * @return The key at the position
+ * @throws std::out_of_range If the set has no more than index keys
+ */
+template<typename Key, typename Backend>
+const Key &UnorderedSet<Key, Backend>::select(size_t index) const {
+    if (index >= size()) throw std::out_of_range("UnorderedSet::select index is out of range");
+
+    Node<Key> *current = root;
+
+    while (true) {
+        const size_t leftSize = getSize(current->left);
+
+        if (index == leftSize) return current->key;
+
+        if (index < leftSize) {
+            current = current->left;
+        } else {
+            index -= leftSize + 1;
+            current = current->right;
+        }
+    }
+}
+
+/**
+ * Counts the keys of the set between low and high, both included.
+ *
+ * @param low The smallest key to count
+ * @param high The largest key to count
+ * @return The number of keys in [low, high], or 0 if high is less than low
+ */
+template<typename Key, typename Backend>
+size_t UnorderedSet<Key, Backend>::countInRange(const Key &low, const Key &high) const {
+    if (high < low) return 0;
+
+    return countBelow(high, true) - countBelow(low, false);
+}
+
+/**
+ * Returns the number of bytes held by the set's node slabs, not counting memory owned by the keys.
+ *
+ * @return The number of bytes used by the set's nodes
+ */
+template<typename Key, typename Backend>
+size_t UnorderedSet<Key, Backend>::bytesUsed() const {
+    return nodes.bytesUsed();
+}
+
+/**
+ * Returns the size of the subtree rooted at the given node.
+ *
+ * @param node The root node of the subtree
  * @return The size of the subtree rooted at the given node
  */
-template<typename Key>
-size_t UnorderedSet<Key>::getSize(Node<Key> *node) const {
-    if (node == nullptr) return 0;
+template<typename Key, typename Backend>
+size_t UnorderedSet<Key, Backend>::getSize(Node<Key> *node) const {
+    return node == nullptr ? 0 : node->size;
+}
 
-    size_t size = 1;
+/**
+ * Recomputes the size of the given node from the sizes of its children, after its children changed.
+ *
+ * @param node The node to recompute the size of
+ */
+template<typename Key, typename Backend>
+void UnorderedSet<Key, Backend>::resize(Node<Key> *node) {
+    node->size = 1 + getSize(node->left) + getSize(node->right);
+}
 
-    size += getSize(node->left);
-    size += getSize(node->right);
+/**
+ * Counts the keys less than the given key, or less than or equal to it, on a single path from the root.
+ *
+ * @param key The key to compare against
+ * @param inclusive Whether to count a key equal to the given key
+ * @return The number of keys below the key
+ */
+template<typename Key, typename Backend>
+size_t UnorderedSet<Key, Backend>::countBelow(const Key &key, const bool inclusive) const {
+    Node<Key> *current = root;
+    size_t count = 0;
+
+    while (current != nullptr) {
+        if (current->key < key || (inclusive && current->key == key)) {
+            // The node and its whole left subtree are below the key
+            count += getSize(current->left) + 1;
+            current = current->right;
+        } else {
+            current = current->left;
+        }
+    }
 
-    return size;
+    return count;
 }
 
 /**
- * Fixes the Red-Black Tree properties after a node deletion.
+ * Fixes the Red-Black Tree properties before a black leaf is deleted. The leaf stays in the tree while it is fixed, and
+ * stands for the NULL child that will replace it.
  *
  * @param node The node to be deleted
  */
-template<typename Key>
-void UnorderedSet<Key>::deleteFix(Node<Key> *node) {
+template<typename Key, typename Backend>
+void UnorderedSet<Key, Backend>::deleteFix(Node<Key> *node) {
     // If the node to be deleted is red, there is nothing to fix
     if (node->color == Color::RED) return;
 
@@ -278,34 +601,46 @@ void UnorderedSet<Key>::deleteFix(Node<Key> *node) {
     node->color = Color::BLUE;
 
     Node<Key> *parent = node->parent;
-    Node<Key> *sibling = nullptr;
-    Node<Key> *innerNephew = nullptr;
-    Node<Key> *outerNephew = nullptr;
 
-    if (parent != nullptr) {
-        sibling = node->key < parent->key ? parent->left : parent->right;
+    // Case 2: If the blue node is the root, recolour it to black and exit.
+    if (parent == nullptr) {
+        node->color = Color::BLACK;
+        return;
+    }
+
+    // The blue node's path is one black short, so its sibling's subtree holds at least one black node
+    const bool nodeIsLeft = parent->left == node;
+    Node<Key> *sibling = nodeIsLeft ? parent->right : parent->left;
+    Node<Key> *innerNephew = nodeIsLeft ? sibling->left : sibling->right;
+    Node<Key> *outerNephew = nodeIsLeft ? sibling->right : sibling->left;
+
+    // Case 4: If the blue node's sibling is red:
+    // 1. Swap the colour of the blue node's sibling and parent
+    // 2. Rotate the parent in the direction of the blue node
+    // 3. Re-apply the suitable case for the blue node
+    if (sibling->color == Color::RED) {
+        // 1. Swap the colour of the blue node's sibling and parent
+        sibling->color = Color::BLACK;
+        parent->color = Color::RED;
 
-        if (sibling != nullptr) {
-            innerNephew = node->key < parent->key ? sibling->left : sibling->right;
-            outerNephew = node->key < parent->key ? sibling->right : sibling->left;
+        // 2. Rotate the parent in the direction of the blue node
+        if (nodeIsLeft) {
+            rotateLeft(sibling);
+        } else {
+            rotateRight(sibling);
         }
-    }
 
-    // Case 2: If the blue node is the root, recolour it to black and exit.
-    if (parent == nullptr) {
+        // 3. Re-apply the suitable case for the blue node
         node->color = Color::BLACK;
+        deleteFix(node);
     }
     // Case 3: If the blue node's sibling is black and both of its nephews are also black:
     // 1. Recolour the node to black and its sibling to red
     // 2. If its parent is red, recolour it to black. Otherwise, set the parent as a blue node and re-apply the suitable
     // case for the parent.
     else if (
-        // Blue node's sibling is black
-        sibling != nullptr &&
-        sibling->color == Color::BLACK &&
-        // and both of its nephews are also black
-        (sibling->left == nullptr || sibling->left->color == Color::BLACK) &&
-        (sibling->right == nullptr || sibling->right->color == Color::BLACK)
+        (innerNephew == nullptr || innerNephew->color == Color::BLACK) &&
+        (outerNephew == nullptr || outerNephew->color == Color::BLACK)
     ) {
         // 1. Recolour the node to black
         node->color = Color::BLACK;
@@ -322,50 +657,24 @@ void UnorderedSet<Key>::deleteFix(Node<Key> *node) {
             deleteFix(parent);
         }
     }
-    // Case 4: If the blue node's sibling is red:
-    // 1. Swap the colour of the blue node's sibling and parent
-    // 2. Rotate the parent in the direction of the blue node
-    // 3. Re-apply the suitable case for the blue node
-    else if (sibling != nullptr && sibling->color == Color::RED) {
-        // 1. Swap the colour of the blue node's sibling and parent
-        sibling->color = Color::BLACK;
-        parent->color = Color::RED;
-
-        // 2. Rotate the parent in the direction of the blue node
-        if (node->key < parent->key) {
-            rotateLeft(parent);
-        } else {
-            rotateRight(parent);
-        }
-
-        // 3. Re-apply the suitable case for the blue node
-        deleteFix(node);
-    }
     // Case 5: If the blue node's sibling is black, the outer nephew is black, and the inner nephew is red:
     // 1. Swap the colours of the blue node's siblings and inner nephew
     // 2. Rotate the blue node's sibling in the opposite direction of the blue node
     // 3. Apply case 6
-    else if (
-        // Blue node's sibling is black
-        sibling != nullptr &&
-        sibling->color == Color::BLACK &&
-        // the outer nephew is black
-        (outerNephew == nullptr || outerNephew->color == Color::BLACK) &&
-        // the inner nephew is red
-        innerNephew->color == Color::RED
-    ) {
+    else if (outerNephew == nullptr || outerNephew->color == Color::BLACK) {
         // 1. Swap the colours of the blue node's sibling and inner nephew
         sibling->color = Color::RED;
         innerNephew->color = Color::BLACK;
 
         // 2. Rotate the blue node's sibling in the opposite direction of the blue node
-        if (node->key < parent->key) {
-            rotateRight(sibling);
+        if (nodeIsLeft) {
+            rotateRight(innerNephew);
         } else {
-            rotateLeft(sibling);
+            rotateLeft(innerNephew);
         }
 
         // 3. Apply case 6
+        node->color = Color::BLACK;
         deleteFix(node);
     }
     // Case 6: If the blue node's sibling is black and the outer nephew is red
@@ -373,22 +682,16 @@ void UnorderedSet<Key>::deleteFix(Node<Key> *node) {
     // 2. Rotate the blue node's parent in the blue node's direction
     // 3. Recolour the red nephew to black
     // 4. Recolour the blue node to black and exit
-    else if (
-        // Blue node's sibling is black
-        sibling != nullptr &&
-        sibling->color == Color::BLACK &&
-        // the outer nephew is red
-        outerNephew->color == Color::RED
-    ) {
+    else {
         // 1. Swap the colours of the blue node's parent and sibling
         sibling->color = parent->color;
         parent->color = Color::BLACK;
 
         // 2. Rotate the blue node's parent in the blue node's direction
-        if (node->key < parent->key) {
-            rotateLeft(parent);
+        if (nodeIsLeft) {
+            rotateLeft(sibling);
         } else {
-            rotateRight(parent);
+            rotateRight(sibling);
         }
 
         // 3. Recolour the red nephew to black
@@ -404,11 +707,8 @@ void UnorderedSet<Key>::deleteFix(Node<Key> *node) {
  *
  * @param node Child to delete
  */
-template<typename Key>
-void UnorderedSet<Key>::deleteOneChild(Node<Key> *node) {
-    // If the node does not exist, do nothing
-    if (!search(node->key)) return;
-
+template<typename Key, typename Backend>
+void UnorderedSet<Key, Backend>::deleteOneChild(Node<Key> *node) {
     // Perform BST deletion
     // - If the node is a leaf, it can be deleted immediately
     // - If the node has one child, the node can be deleted after its parent adjusts a link to bypass the node
@@ -424,75 +724,57 @@ void UnorderedSet<Key>::deleteOneChild(Node<Key> *node) {
         return deleteOneChild(successor);
     }
 
-    // If the node is a leaf
-    if (node->left == nullptr && node->right == nullptr) {
-        if (node->parent != nullptr) {
-            if (node->key < node->parent->key) {
-                node->parent->left = nullptr;
-            } else {
-                node->parent->right = nullptr;
-            }
-        } else {
-            root = nullptr;
-        }
-    }
-    // If the node has one child
-    else {
-        Node<Key> *child = node->left != nullptr ? node->left : node->right;
+    Node<Key> *child = node->left != nullptr ? node->left : node->right;
 
-        // If the node to be deleted has a parent, set a bypass from the parent to the child node
-        if (node->parent != nullptr) {
-            child->parent = node->parent;
+    // If the node is a leaf, restore the black heights around it while it is still in the tree
+    if (child == nullptr) deleteFix(node);
 
-            if (node->key < node->parent->key) {
-                node->parent->left = child;
-            } else {
-                node->parent->right = child;
-            }
-        }
-        // If the node to be deleted is the root node, update the child node to be the root node
-        else {
-            child->color = Color::BLACK;
-            child->parent = nullptr;
-            root = child;
-        }
+    // Every ancestor of the node loses one key
+    for (Node<Key> *ancestor = node->parent; ancestor != nullptr; ancestor = ancestor->parent) {
+        ancestor->size -= 1;
     }
 
-    deleteFix(node);
+    // Set a bypass from the parent to the child node, or make the child the root
+    replaceChild(node, child);
+
+    // A black node with a single child has a red child, which takes over its black
+    if (child != nullptr) child->color = Color::BLACK;
 
     setSize -= 1;
 
-    delete node;
+    nodes.free(node);
 }
 
 /**
  * Recursively updates the size of the subtree rooted at the given node.
  */
-template<typename Key>
-void UnorderedSet<Key>::updateSize() {
+template<typename Key, typename Backend>
+void UnorderedSet<Key, Backend>::updateSize() {
     if (root == nullptr) return;
 
     setSize = getSize(root);
 }
 
 /**
- * Recursively clears the Red-Black Tree starting from the given node.
+ * Recursively copies the subtree rooted at the given node, with its colours and subtree sizes, into this set's slab.
  *
- * @param node The node to start clearing the Red-Black Tree from
+ * @param node The root of the subtree to copy
+ * @param parent The parent of the copy
+ * @return The root of the copy
  */
-template<typename Key>
-void UnorderedSet<Key>::clearRecursive(Node<Key> *node) {
-    if (node == nullptr) return;
+template<typename Key, typename Backend>
+Node<Key> *UnorderedSet<Key, Backend>::copyRecursive(const Node<Key> *node, Node<Key> *parent) {
+    if (node == nullptr) return nullptr;
 
-    clearRecursive(node->left);
-    node->left = nullptr;
+    Node<Key> *copy = nodes.allocate(node->key);
 
-    clearRecursive(node->right);
-    node->right = nullptr;
+    copy->color = node->color;
+    copy->size = node->size;
+    copy->parent = parent;
+    copy->left = copyRecursive(node->left, copy);
+    copy->right = copyRecursive(node->right, copy);
 
-    delete node;
-
-    setSize -= 1;
+    return copy;
 }
 
 /**
@@ -501,8 +783,8 @@ void UnorderedSet<Key>::clearRecursive(Node<Key> *node) {
  * @param key Key to erase
  * @return Whether the erase was successful
  */
-template<typename Key>
-bool UnorderedSet<Key>::erase(const Key &key) {
+template<typename Key, typename Backend>
+bool UnorderedSet<Key, Backend>::erase(const Key &key) {
     // Retrieve the node
     Node<Key> *node = root;
 
@@ -518,12 +800,13 @@ bool UnorderedSet<Key>::erase(const Key &key) {
 }
 
 /**
- * Clears the unordered set of all keys.
+ * Clears the unordered set of all keys, handing back all of its slabs at once.
  */
-template<typename Key>
-void UnorderedSet<Key>::clear() {
-    clearRecursive(root);
+template<typename Key, typename Backend>
+void UnorderedSet<Key, Backend>::clear() {
+    nodes.release(root);
     root = nullptr;
+    setSize = 0;
 }
 
 /**
@@ -531,8 +814,8 @@ void UnorderedSet<Key>::clear() {
  *
  * @return The beginning of the unordered set
  */
-template<typename Key>
-typename UnorderedSet<Key>::Iterator UnorderedSet<Key>::begin() const {
+template<typename Key, typename Backend>
+typename UnorderedSet<Key, Backend>::Iterator UnorderedSet<Key, Backend>::begin() const {
     if (root == nullptr) return Iterator(nullptr);
 
     Node<Key> *smallestNode = root;
@@ -549,8 +832,8 @@ typename UnorderedSet<Key>::Iterator UnorderedSet<Key>::begin() const {
  *
  * @return The end of the unordered set
  */
-template<typename Key>
-typename UnorderedSet<Key>::Iterator UnorderedSet<Key>::end() const {
+template<typename Key, typename Backend>
+typename UnorderedSet<Key, Backend>::Iterator UnorderedSet<Key, Backend>::end() const {
     return Iterator(nullptr);
 }
 